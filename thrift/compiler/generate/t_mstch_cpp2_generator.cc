@@ -619,6 +619,8 @@ class mstch_cpp2_field : public mstch_field {
             {"field:index_plus_one", &mstch_cpp2_field::index_plus_one},
             {"field:cpp_name", &mstch_cpp2_field::cpp_name},
             {"field:next_field_key", &mstch_cpp2_field::next_field_key},
+            {"field:next_field_cpp_name",
+             &mstch_cpp2_field::next_field_cpp_name},
             {"field:next_field_type", &mstch_cpp2_field::next_field_type},
             {"field:cpp_ref?", &mstch_cpp2_field::cpp_ref},
             {"field:cpp_ref_unique?", &mstch_cpp2_field::cpp_ref_unique},
@@ -631,6 +633,8 @@ class mstch_cpp2_field : public mstch_field {
             {"field:enum_has_value", &mstch_cpp2_field::enum_has_value},
             {"field:optionals?", &mstch_cpp2_field::optionals},
             {"field:terse_writes?", &mstch_cpp2_field::terse_writes},
+            {"field:trivially_comparable?",
+             &mstch_cpp2_field::trivially_comparable},
             {"field:fatal_annotations?",
              &mstch_cpp2_field::has_fatal_annotations},
             {"field:fatal_annotations", &mstch_cpp2_field::fatal_annotations},
@@ -690,6 +694,9 @@ class mstch_cpp2_field : public mstch_field {
   mstch::node next_field_key() {
     return std::to_string(field_->get_next()->get_key());
   }
+  mstch::node next_field_cpp_name() {
+    return get_cpp_name(field_->get_next());
+  }
   mstch::node next_field_type() {
     return field_->get_next()
         ? generators_->type_generator_->generate(
@@ -710,6 +717,16 @@ class mstch_cpp2_field : public mstch_field {
         (is_cpp_ref_unique_either(field_) ||
          (!t->is_struct() && !t->is_xception()));
   }
+  mstch::node trivially_comparable() {
+    // Always present numbers and enums, compared without branches by the
+    // equal_to of structs annotated with cpp.define_hash
+    auto t = field_->get_type()->get_true_type();
+    return field_->get_req() != t_field::e_req::T_OPTIONAL &&
+        !cpp2::is_cpp_ref(field_) &&
+        !t->annotations_.count("cpp.indirection") &&
+        (t->is_enum() ||
+         (t->is_base_type() && !t->is_void() && !t->is_string_or_binary()));
+  }
   mstch::node has_fatal_annotations() {
     return get_fatal_annotations(field_->annotations_).size() > 0;
   }
@@ -769,6 +786,7 @@ class mstch_cpp2_struct : public mstch_struct {
             {"struct:cpp_declare_hash", &mstch_cpp2_struct::cpp_declare_hash},
             {"struct:cpp_declare_equal_to",
              &mstch_cpp2_struct::cpp_declare_equal_to},
+            {"struct:cpp_define_hash?", &mstch_cpp2_struct::cpp_define_hash},
             {"struct:cpp_noncopyable", &mstch_cpp2_struct::cpp_noncopyable},
             {"struct:cpp_noncomparable", &mstch_cpp2_struct::cpp_noncomparable},
             {"struct:cpp_noexcept_move", &mstch_cpp2_struct::cpp_noexcept_move},
@@ -780,6 +798,12 @@ class mstch_cpp2_struct : public mstch_struct {
             {"struct:isset_fields", &mstch_cpp2_struct::isset_fields},
             {"struct:optionals?", &mstch_cpp2_struct::optionals},
             {"struct:is_large?", &mstch_cpp2_struct::is_large},
+            {"struct:binary_fixed_size?",
+             &mstch_cpp2_struct::binary_fixed_size},
+            {"struct:fast_read_fields?", &mstch_cpp2_struct::has_fast_read},
+            {"struct:fast_read_fields", &mstch_cpp2_struct::fast_read_fields},
+            {"struct:fast_read_ends_struct?",
+             &mstch_cpp2_struct::fast_read_ends_struct},
             {"struct:no_getters_setters?",
              &mstch_cpp2_struct::no_getters_setters},
             {"struct:fatal_annotations?",
@@ -896,6 +920,15 @@ class mstch_cpp2_struct : public mstch_struct {
     return strct_->annotations_.count("cpp.declare_equal_to") ||
         strct_->annotations_.count("cpp2.declare_equal_to");
   }
+  mstch::node cpp_define_hash() {
+    // Generated std::hash and std::equal_to, unless declared to be user
+    // provided
+    return (strct_->annotations_.count("cpp.define_hash") ||
+            strct_->annotations_.count("cpp2.define_hash")) &&
+        !strct_->is_union() &&
+        !strct_->annotations_.count("cpp.declare_hash") &&
+        !strct_->annotations_.count("cpp2.declare_hash");
+  }
   mstch::node cpp_noncopyable() {
     return bool(strct_->annotations_.count("cpp2.noncopyable"));
   }
@@ -973,6 +1006,52 @@ class mstch_cpp2_struct : public mstch_struct {
     }
     return false;
   }
+  mstch::node binary_fixed_size() {
+    // Whether the Binary serialized size may not depend on the value: all
+    // fields are always written and are numbers, enums or structs (whose
+    // own size decides at compile time).
+    if (strct_->is_union() || strct_->is_xception() ||
+        strct_->get_members().empty()) {
+      return false;
+    }
+    bool terse_writes = cache_->parsed_options_.count("terse_writes") != 0;
+    for (auto const* field : strct_->get_members()) {
+      auto const* type = field->get_type()->get_true_type();
+      if (field->get_req() == t_field::e_req::T_OPTIONAL ||
+          cpp2::is_cpp_ref(field) ||
+          type->annotations_.count("cpp.indirection")) {
+        return false;
+      }
+      if (type->is_struct()) {
+        if (type->is_union()) {
+          return false;
+        }
+        continue;
+      }
+      if (terse_writes && field->get_req() != t_field::e_req::T_REQUIRED) {
+        return false;
+      }
+      if (!type->is_enum() &&
+          !(type->is_base_type() && !type->is_void() &&
+            !type->is_string_or_binary())) {
+        return false;
+      }
+    }
+    return true;
+  }
+  mstch::node has_fast_read() {
+    return !get_fast_read_fields().empty();
+  }
+  mstch::node fast_read_fields() {
+    return generate_elements(
+        get_fast_read_fields(),
+        generators_->field_generator_.get(),
+        generators_,
+        cache_);
+  }
+  mstch::node fast_read_ends_struct() {
+    return get_fast_read_fields().size() == strct_->get_members().size();
+  }
   mstch::node no_getters_setters() {
     return cache_->parsed_options_.count("no_getters_setters") != 0;
   }
@@ -1100,6 +1179,40 @@ class mstch_cpp2_struct : public mstch_struct {
         cache_);
   }
 
+  // The leading fields of a struct annotated with cpp.fast_read that the
+  // reader decodes in one go: always written numbers, enums and bools, with
+  // ids the Compact protocol encodes as deltas. Empty unless there are at
+  // least two.
+  std::vector<t_field const*> get_fast_read_fields() const {
+    std::vector<t_field const*> fields;
+    if (strct_->is_union() ||
+        (!strct_->annotations_.count("cpp.fast_read") &&
+         !strct_->annotations_.count("cpp2.fast_read"))) {
+      return fields;
+    }
+    int32_t prev_key = 0;
+    for (auto const* field : strct_->get_members()) {
+      auto const* type = field->get_type()->get_true_type();
+      if (field->get_req() == t_field::e_req::T_OPTIONAL ||
+          cpp2::is_cpp_ref(field) ||
+          type->annotations_.count("cpp.indirection") ||
+          !cpp2::get_cpp_type(field->get_type()).empty() ||
+          !cpp2::get_cpp_type(type).empty() ||
+          !(type->is_enum() ||
+            (type->is_base_type() && !type->is_void() &&
+             !type->is_string_or_binary())) ||
+          field->get_key() <= prev_key || field->get_key() - prev_key > 15) {
+        break;
+      }
+      fields.push_back(field);
+      prev_key = field->get_key();
+    }
+    if (fields.size() < 2) {
+      fields.clear();
+    }
+    return fields;
+  }
+
   std::shared_ptr<cpp2_generator_context> context_;
 
   std::vector<t_field*> fields_in_layout_order_;
@@ -1117,6 +1230,8 @@ class mstch_cpp2_function : public mstch_function {
         this,
         {
             {"function:coroutine?", &mstch_cpp2_function::coroutine},
+            {"function:coroutine_dispatch?",
+             &mstch_cpp2_function::coroutine_dispatch},
             {"function:eb", &mstch_cpp2_function::event_based},
             {"function:cpp_name", &mstch_cpp2_function::cpp_name},
         });
@@ -1124,7 +1239,23 @@ class mstch_cpp2_function : public mstch_function {
   mstch::node coroutine() {
     return bool(function_->annotations_.count("cpp.coroutine"));
   }
+  // Coroutines that the processor starts itself, without a HandlerCallback:
+  // the ones processed in the thread manager that reply once.
+  mstch::node coroutine_dispatch() {
+    return function_->annotations_.count("cpp.coroutine") &&
+        !is_event_based() &&
+        !function_->get_returntype()->is_streamresponse() &&
+        !function_->returns_sink();
+  }
   mstch::node event_based() {
+    return is_event_based();
+  }
+  mstch::node cpp_name() {
+    return get_cpp_name(function_);
+  }
+
+ private:
+  bool is_event_based() const {
     if (function_->annotations_.count("thread") &&
         function_->annotations_.at("thread") == "eb") {
       return true;
@@ -1134,9 +1265,6 @@ class mstch_cpp2_function : public mstch_function {
     }
     return false;
   }
-  mstch::node cpp_name() {
-    return get_cpp_name(function_);
-  }
 };
 
 class mstch_cpp2_service : public mstch_service {
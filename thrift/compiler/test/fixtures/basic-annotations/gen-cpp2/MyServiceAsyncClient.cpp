@@ -163,7 +163,7 @@ void MyServiceAsyncClient::sync_ping(apache::thrift::RpcOptions& rpcOptions) {
   _returnState.resetProtocolId(protocolId);
   _returnState.resetCtx(std::shared_ptr<apache::thrift::ContextStack>(ctx, &ctx->ctx));
   SCOPE_EXIT {
-    if (_returnState.header() && !_returnState.header()->getHeaders().empty()) {
+    if (_returnState.header() && !_returnState.header()->readHeadersEmpty()) {
       rpcOptions.setReadHeaders(_returnState.header()->releaseHeaders());
     }
   };
@@ -325,7 +325,7 @@ void MyServiceAsyncClient::sync_getRandomData(apache::thrift::RpcOptions& rpcOpt
   _returnState.resetProtocolId(protocolId);
   _returnState.resetCtx(std::shared_ptr<apache::thrift::ContextStack>(ctx, &ctx->ctx));
   SCOPE_EXIT {
-    if (_returnState.header() && !_returnState.header()->getHeaders().empty()) {
+    if (_returnState.header() && !_returnState.header()->readHeadersEmpty()) {
       rpcOptions.setReadHeaders(_returnState.header()->releaseHeaders());
     }
   };
@@ -487,7 +487,7 @@ bool MyServiceAsyncClient::sync_hasDataById(apache::thrift::RpcOptions& rpcOptio
   _returnState.resetProtocolId(protocolId);
   _returnState.resetCtx(std::shared_ptr<apache::thrift::ContextStack>(ctx, &ctx->ctx));
   SCOPE_EXIT {
-    if (_returnState.header() && !_returnState.header()->getHeaders().empty()) {
+    if (_returnState.header() && !_returnState.header()->readHeadersEmpty()) {
       rpcOptions.setReadHeaders(_returnState.header()->releaseHeaders());
     }
   };
@@ -651,7 +651,7 @@ void MyServiceAsyncClient::sync_getDataById(apache::thrift::RpcOptions& rpcOptio
   _returnState.resetProtocolId(protocolId);
   _returnState.resetCtx(std::shared_ptr<apache::thrift::ContextStack>(ctx, &ctx->ctx));
   SCOPE_EXIT {
-    if (_returnState.header() && !_returnState.header()->getHeaders().empty()) {
+    if (_returnState.header() && !_returnState.header()->readHeadersEmpty()) {
       rpcOptions.setReadHeaders(_returnState.header()->releaseHeaders());
     }
   };
@@ -813,7 +813,7 @@ void MyServiceAsyncClient::sync_putDataById(apache::thrift::RpcOptions& rpcOptio
   _returnState.resetProtocolId(protocolId);
   _returnState.resetCtx(std::shared_ptr<apache::thrift::ContextStack>(ctx, &ctx->ctx));
   SCOPE_EXIT {
-    if (_returnState.header() && !_returnState.header()->getHeaders().empty()) {
+    if (_returnState.header() && !_returnState.header()->readHeadersEmpty()) {
       rpcOptions.setReadHeaders(_returnState.header()->releaseHeaders());
     }
   };
@@ -1063,7 +1063,7 @@ void MyServiceAsyncClient::sync_cppDoNothing(apache::thrift::RpcOptions& rpcOpti
   _returnState.resetProtocolId(protocolId);
   _returnState.resetCtx(std::shared_ptr<apache::thrift::ContextStack>(ctx, &ctx->ctx));
   SCOPE_EXIT {
-    if (_returnState.header() && !_returnState.header()->getHeaders().empty()) {
+    if (_returnState.header() && !_returnState.header()->readHeadersEmpty()) {
       rpcOptions.setReadHeaders(_returnState.header()->releaseHeaders());
     }
   };
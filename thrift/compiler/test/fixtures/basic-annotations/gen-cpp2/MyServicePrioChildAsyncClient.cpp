@@ -86,7 +86,7 @@ void MyServicePrioChildAsyncClient::sync_pang(apache::thrift::RpcOptions& rpcOpt
   _returnState.resetProtocolId(protocolId);
   _returnState.resetCtx(std::shared_ptr<apache::thrift::ContextStack>(ctx, &ctx->ctx));
   SCOPE_EXIT {
-    if (_returnState.header() && !_returnState.header()->getHeaders().empty()) {
+    if (_returnState.header() && !_returnState.header()->readHeadersEmpty()) {
       rpcOptions.setReadHeaders(_returnState.header()->releaseHeaders());
     }
   };
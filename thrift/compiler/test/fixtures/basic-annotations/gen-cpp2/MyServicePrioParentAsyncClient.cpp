@@ -98,7 +98,7 @@ void MyServicePrioParentAsyncClient::sync_ping(apache::thrift::RpcOptions& rpcOp
   _returnState.resetProtocolId(protocolId);
   _returnState.resetCtx(std::shared_ptr<apache::thrift::ContextStack>(ctx, &ctx->ctx));
   SCOPE_EXIT {
-    if (_returnState.header() && !_returnState.header()->getHeaders().empty()) {
+    if (_returnState.header() && !_returnState.header()->readHeadersEmpty()) {
       rpcOptions.setReadHeaders(_returnState.header()->releaseHeaders());
     }
   };
@@ -260,7 +260,7 @@ void MyServicePrioParentAsyncClient::sync_pong(apache::thrift::RpcOptions& rpcOp
   _returnState.resetProtocolId(protocolId);
   _returnState.resetCtx(std::shared_ptr<apache::thrift::ContextStack>(ctx, &ctx->ctx));
   SCOPE_EXIT {
-    if (_returnState.header() && !_returnState.header()->getHeaders().empty()) {
+    if (_returnState.header() && !_returnState.header()->readHeadersEmpty()) {
       rpcOptions.setReadHeaders(_returnState.header()->releaseHeaders());
     }
   };
@@ -151,7 +151,7 @@ void MyServiceAsyncClient::sync_ping(apache::thrift::RpcOptions& rpcOptions) {
   _returnState.resetProtocolId(protocolId);
   _returnState.resetCtx(std::shared_ptr<apache::thrift::ContextStack>(ctx, &ctx->ctx));
   SCOPE_EXIT {
-    if (_returnState.header() && !_returnState.header()->getHeaders().empty()) {
+    if (_returnState.header() && !_returnState.header()->readHeadersEmpty()) {
       rpcOptions.setReadHeaders(_returnState.header()->releaseHeaders());
     }
   };
@@ -292,7 +292,7 @@ void MyServiceAsyncClient::sync_getRandomData(apache::thrift::RpcOptions& rpcOpt
   _returnState.resetProtocolId(protocolId);
   _returnState.resetCtx(std::shared_ptr<apache::thrift::ContextStack>(ctx, &ctx->ctx));
   SCOPE_EXIT {
-    if (_returnState.header() && !_returnState.header()->getHeaders().empty()) {
+    if (_returnState.header() && !_returnState.header()->readHeadersEmpty()) {
       rpcOptions.setReadHeaders(_returnState.header()->releaseHeaders());
     }
   };
@@ -433,7 +433,7 @@ bool MyServiceAsyncClient::sync_hasDataById(apache::thrift::RpcOptions& rpcOptio
   _returnState.resetProtocolId(protocolId);
   _returnState.resetCtx(std::shared_ptr<apache::thrift::ContextStack>(ctx, &ctx->ctx));
   SCOPE_EXIT {
-    if (_returnState.header() && !_returnState.header()->getHeaders().empty()) {
+    if (_returnState.header() && !_returnState.header()->readHeadersEmpty()) {
       rpcOptions.setReadHeaders(_returnState.header()->releaseHeaders());
     }
   };
@@ -576,7 +576,7 @@ void MyServiceAsyncClient::sync_getDataById(apache::thrift::RpcOptions& rpcOptio
   _returnState.resetProtocolId(protocolId);
   _returnState.resetCtx(std::shared_ptr<apache::thrift::ContextStack>(ctx, &ctx->ctx));
   SCOPE_EXIT {
-    if (_returnState.header() && !_returnState.header()->getHeaders().empty()) {
+    if (_returnState.header() && !_returnState.header()->readHeadersEmpty()) {
       rpcOptions.setReadHeaders(_returnState.header()->releaseHeaders());
     }
   };
@@ -717,7 +717,7 @@ void MyServiceAsyncClient::sync_putDataById(apache::thrift::RpcOptions& rpcOptio
   _returnState.resetProtocolId(protocolId);
   _returnState.resetCtx(std::shared_ptr<apache::thrift::ContextStack>(ctx, &ctx->ctx));
   SCOPE_EXIT {
-    if (_returnState.header() && !_returnState.header()->getHeaders().empty()) {
+    if (_returnState.header() && !_returnState.header()->readHeadersEmpty()) {
       rpcOptions.setReadHeaders(_returnState.header()->releaseHeaders());
     }
   };
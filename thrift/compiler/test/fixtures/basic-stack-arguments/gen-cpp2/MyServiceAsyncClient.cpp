@@ -127,7 +127,7 @@ bool MyServiceAsyncClient::sync_hasDataById(apache::thrift::RpcOptions& rpcOptio
   _returnState.resetProtocolId(protocolId);
   _returnState.resetCtx(std::shared_ptr<apache::thrift::ContextStack>(ctx, &ctx->ctx));
   SCOPE_EXIT {
-    if (_returnState.header() && !_returnState.header()->getHeaders().empty()) {
+    if (_returnState.header() && !_returnState.header()->readHeadersEmpty()) {
       rpcOptions.setReadHeaders(_returnState.header()->releaseHeaders());
     }
   };
@@ -164,7 +164,7 @@ MyServiceAsyncClient::sync_complete_hasDataById(
   	tryResponse.emplaceException(std::move(returnState.exception()));
   } else {
     tryResponse.emplace();
-    if (returnState.header() && !returnState.header()->getHeaders().empty()) {
+    if (returnState.header() && !returnState.header()->readHeadersEmpty()) {
   	  tryResponse->responseContext.headers = returnState.header()->releaseHeaders();
     }
     tryResponse->response = folly::makeTryWith([&] {
@@ -326,7 +326,7 @@ void MyServiceAsyncClient::sync_getDataById(apache::thrift::RpcOptions& rpcOptio
   _returnState.resetProtocolId(protocolId);
   _returnState.resetCtx(std::shared_ptr<apache::thrift::ContextStack>(ctx, &ctx->ctx));
   SCOPE_EXIT {
-    if (_returnState.header() && !_returnState.header()->getHeaders().empty()) {
+    if (_returnState.header() && !_returnState.header()->readHeadersEmpty()) {
       rpcOptions.setReadHeaders(_returnState.header()->releaseHeaders());
     }
   };
@@ -363,7 +363,7 @@ MyServiceAsyncClient::sync_complete_getDataById(
   	tryResponse.emplaceException(std::move(returnState.exception()));
   } else {
     tryResponse.emplace();
-    if (returnState.header() && !returnState.header()->getHeaders().empty()) {
+    if (returnState.header() && !returnState.header()->readHeadersEmpty()) {
   	  tryResponse->responseContext.headers = returnState.header()->releaseHeaders();
     }
     tryResponse->response = folly::makeTryWith([&] {
@@ -525,7 +525,7 @@ void MyServiceAsyncClient::sync_putDataById(apache::thrift::RpcOptions& rpcOptio
   _returnState.resetProtocolId(protocolId);
   _returnState.resetCtx(std::shared_ptr<apache::thrift::ContextStack>(ctx, &ctx->ctx));
   SCOPE_EXIT {
-    if (_returnState.header() && !_returnState.header()->getHeaders().empty()) {
+    if (_returnState.header() && !_returnState.header()->readHeadersEmpty()) {
       rpcOptions.setReadHeaders(_returnState.header()->releaseHeaders());
     }
   };
@@ -562,7 +562,7 @@ MyServiceAsyncClient::sync_complete_putDataById(
   	tryResponse.emplaceException(std::move(returnState.exception()));
   } else {
     tryResponse.emplace();
-    if (returnState.header() && !returnState.header()->getHeaders().empty()) {
+    if (returnState.header() && !returnState.header()->readHeadersEmpty()) {
   	  tryResponse->responseContext.headers = returnState.header()->releaseHeaders();
     }
     tryResponse->response = folly::makeTryWith([&] {
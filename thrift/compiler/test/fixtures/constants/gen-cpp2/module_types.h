@@ -428,6 +428,12 @@ class UnEnumStruct final : private apache::thrift::detail::st::ComparisonOperato
   template <class Protocol_>
   uint32_t write(Protocol_* prot_) const;
 
+  // Binary serialized size of every value, 0 if a field's size varies
+  static constexpr uint32_t __fbthrift_binary_serialized_size =
+      ::apache::thrift::detail::pm::binary_struct_size({
+        ::apache::thrift::detail::pm::fixed_serialized_size< ::apache::thrift::BinaryProtocolWriter, ::apache::thrift::type_class::enumeration,  ::cpp2::City>::value
+      });
+
  private:
   template <class Protocol_>
   void readNoXfer(Protocol_* iprot);
@@ -500,6 +506,13 @@ class Range final : private apache::thrift::detail::st::ComparisonOperators<Rang
   template <class Protocol_>
   uint32_t write(Protocol_* prot_) const;
 
+  // Binary serialized size of every value, 0 if a field's size varies
+  static constexpr uint32_t __fbthrift_binary_serialized_size =
+      ::apache::thrift::detail::pm::binary_struct_size({
+        ::apache::thrift::detail::pm::fixed_serialized_size< ::apache::thrift::BinaryProtocolWriter, ::apache::thrift::type_class::integral, int32_t>::value,
+        ::apache::thrift::detail::pm::fixed_serialized_size< ::apache::thrift::BinaryProtocolWriter, ::apache::thrift::type_class::integral, int32_t>::value
+      });
+
  private:
   template <class Protocol_>
   void readNoXfer(Protocol_* iprot);
@@ -46,6 +46,11 @@ void MyServiceAsyncProcessor::process_ping(std::unique_ptr<apache::thrift::Respo
     return;
   }
   req->setStartedProcessing();
+#if FOLLY_HAS_COROUTINES
+  apache::thrift::RequestParams params{ctx, tm, eb};
+  apache::thrift::detail::si::async_tm_prep(iface_, params);
+  apache::thrift::detail::ap::process_coro(std::move(req), std::move(ctxStack), ctx, eb, tm, [&] { return iface_->co_ping(params); }, return_ping<ProtocolIn_,ProtocolOut_>, throw_wrapped_ping<ProtocolIn_, ProtocolOut_>);
+#else // FOLLY_HAS_COROUTINES
   auto callback = std::make_unique<apache::thrift::HandlerCallback<void>>(std::move(req), std::move(ctxStack), return_ping<ProtocolIn_,ProtocolOut_>, throw_wrapped_ping<ProtocolIn_, ProtocolOut_>, ctx->getProtoSeqId(), eb, tm, ctx);
   if (!callback->isRequestActive()) {
     callback.release()->deleteInThread();
@@ -53,6 +58,7 @@ void MyServiceAsyncProcessor::process_ping(std::unique_ptr<apache::thrift::Respo
   }
   ctx->setStartedProcessing();
   iface_->async_tm_ping(std::move(callback));
+#endif // FOLLY_HAS_COROUTINES
 }
 
 template <class ProtocolIn_, class ProtocolOut_>
@@ -158,6 +164,11 @@ void MyServiceAsyncProcessor::process_hasDataById(std::unique_ptr<apache::thrift
     return;
   }
   req->setStartedProcessing();
+#if FOLLY_HAS_COROUTINES
+  apache::thrift::RequestParams params{ctx, tm, eb};
+  apache::thrift::detail::si::async_tm_prep(iface_, params);
+  apache::thrift::detail::ap::process_coro(std::move(req), std::move(ctxStack), ctx, eb, tm, [&] { return iface_->co_hasDataById(params, args.get<0>().ref()); }, return_hasDataById<ProtocolIn_,ProtocolOut_>, throw_wrapped_hasDataById<ProtocolIn_, ProtocolOut_>);
+#else // FOLLY_HAS_COROUTINES
   auto callback = std::make_unique<apache::thrift::HandlerCallback<bool>>(std::move(req), std::move(ctxStack), return_hasDataById<ProtocolIn_,ProtocolOut_>, throw_wrapped_hasDataById<ProtocolIn_, ProtocolOut_>, ctx->getProtoSeqId(), eb, tm, ctx);
   if (!callback->isRequestActive()) {
     callback.release()->deleteInThread();
@@ -165,6 +176,7 @@ void MyServiceAsyncProcessor::process_hasDataById(std::unique_ptr<apache::thrift
   }
   ctx->setStartedProcessing();
   iface_->async_tm_hasDataById(std::move(callback), args.get<0>().ref());
+#endif // FOLLY_HAS_COROUTINES
 }
 
 template <class ProtocolIn_, class ProtocolOut_>
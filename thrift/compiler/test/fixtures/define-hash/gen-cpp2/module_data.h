@@ -0,0 +1,13 @@
+/**
+ * Autogenerated by Thrift
+ *
+ * DO NOT EDIT UNLESS YOU ARE SURE THAT YOU KNOW WHAT YOU ARE DOING
+ *  @generated
+ */
+#pragma once
+
+#include <thrift/lib/cpp2/gen/module_data_h.h>
+
+#include "thrift/compiler/test/fixtures/define-hash/gen-cpp2/module_types.h"
+
+
@@ -157,6 +157,13 @@ class Field final : private apache::thrift::detail::st::ComparisonOperators<Fiel
   template <class Protocol_>
   uint32_t write(Protocol_* prot_) const;
 
+  // Binary serialized size of every value, 0 if a field's size varies
+  static constexpr uint32_t __fbthrift_binary_serialized_size =
+      ::apache::thrift::detail::pm::binary_struct_size({
+        ::apache::thrift::detail::pm::fixed_serialized_size< ::apache::thrift::BinaryProtocolWriter, ::apache::thrift::type_class::integral,  ::cpp2::ColorID>::value,
+        ::apache::thrift::detail::pm::fixed_serialized_size< ::apache::thrift::BinaryProtocolWriter, ::apache::thrift::type_class::integral, int32_t>::value
+      });
+
  private:
   template <class Protocol_>
   void readNoXfer(Protocol_* iprot);
@@ -0,0 +1,19 @@
+/**
+ * Autogenerated by Thrift
+ *
+ * DO NOT EDIT UNLESS YOU ARE SURE THAT YOU KNOW WHAT YOU ARE DOING
+ *  @generated
+ */
+#pragma once
+
+#include <thrift/lib/cpp2/gen/module_constants_h.h>
+
+#include "thrift/compiler/test/fixtures/fast-read/gen-cpp2/module_types.h"
+
+namespace cpp2 {
+
+struct module_constants {
+
+};
+
+} // cpp2
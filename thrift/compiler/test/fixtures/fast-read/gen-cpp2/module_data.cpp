@@ -0,0 +1,12 @@
+/**
+ * Autogenerated by Thrift
+ *
+ * DO NOT EDIT UNLESS YOU ARE SURE THAT YOU KNOW WHAT YOU ARE DOING
+ *  @generated
+ */
+
+#include "thrift/compiler/test/fixtures/fast-read/gen-cpp2/module_data.h"
+
+#include <thrift/lib/cpp2/gen/module_data_cpp.h>
+
+
@@ -123,6 +123,14 @@ class MyStruct final : private apache::thrift::detail::st::ComparisonOperators<M
   template <class Protocol_>
   uint32_t write(Protocol_* prot_) const;
 
+  // Binary serialized size of every value, 0 if a field's size varies
+  static constexpr uint32_t __fbthrift_binary_serialized_size =
+      ::apache::thrift::detail::pm::binary_struct_size({
+        ::apache::thrift::detail::pm::fixed_serialized_size< ::apache::thrift::BinaryProtocolWriter, ::apache::thrift::type_class::structure,  ::cpp2::Included>::value,
+        ::apache::thrift::detail::pm::fixed_serialized_size< ::apache::thrift::BinaryProtocolWriter, ::apache::thrift::type_class::structure,  ::cpp2::Included>::value,
+        ::apache::thrift::detail::pm::fixed_serialized_size< ::apache::thrift::BinaryProtocolWriter, ::apache::thrift::type_class::integral,  ::cpp2::IncludedInt64>::value
+      });
+
  private:
   template <class Protocol_>
   void readNoXfer(Protocol_* iprot);
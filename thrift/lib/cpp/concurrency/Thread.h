@@ -20,6 +20,8 @@
 #include <cstdint>
 #include <memory>
 
+#include <folly/Range.h>
+
 namespace apache { namespace thrift { namespace concurrency {
 
 class Thread;
@@ -65,6 +67,19 @@ class PriorityRunnable : public virtual Runnable {
   virtual PRIORITY getPriority() const = 0;
 };
 
+/**
+ * Runnable that can tell which tenant (e.g. client) it runs for, so that a
+ * thread manager can share its threads fairly between tenants.
+ */
+class TenantRunnable : public virtual Runnable {
+ public:
+  /**
+   * Returns the value of `key` (e.g. a request header) identifying the
+   * tenant, or an empty string. Must stay valid until the task runs.
+   */
+  virtual folly::StringPiece getTenant(folly::StringPiece key) const = 0;
+};
+
 /**
  * Minimal thread class. Returned by thread factory bound to a Runnable object
  * and ready to start execution.  More or less analogous to java.lang.Thread
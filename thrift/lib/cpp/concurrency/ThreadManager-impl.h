@@ -21,6 +21,7 @@
 
 #include <deque>
 #include <memory>
+#include <vector>
 
 #include <folly/DefaultKeepAliveExecutor.h>
 #include <folly/ThreadLocal.h>
@@ -50,8 +51,10 @@ class ThreadManager::Task {
   };
 
   Task(shared_ptr<Runnable> runnable,
-       const std::chrono::milliseconds& expiration)
+       const std::chrono::milliseconds& expiration,
+       size_t priority = 0)
     : runnable_(std::move(runnable))
+    , priority_(priority)
     , queueBeginTime_(SystemClock::now())
     , expireTime_(expiration > std::chrono::milliseconds::zero() ?
                   queueBeginTime_ + expiration : SystemClockTimePoint())
@@ -76,6 +79,10 @@ class ThreadManager::Task {
     return queueBeginTime_;
   }
 
+  size_t getPriority() const {
+    return priority_;
+  }
+
   bool canExpire() const {
     return expireTime_ != SystemClockTimePoint();
   }
@@ -88,8 +95,20 @@ class ThreadManager::Task {
     return context_;
   }
 
+  // Whether the thread manager must be told when the task is done, see
+  // ThreadManager::ImplT::onTaskDone()
+  bool needsDoneNotification() const {
+    return needsDoneNotification_;
+  }
+
+  void setNeedsDoneNotification() {
+    needsDoneNotification_ = true;
+  }
+
  private:
   shared_ptr<Runnable> runnable_;
+  size_t priority_;
+  bool needsDoneNotification_{false};
   SystemClockTimePoint queueBeginTime_;
   SystemClockTimePoint expireTime_;
   std::shared_ptr<folly::RequestContext> context_;
@@ -114,6 +133,7 @@ class ThreadManager::ImplT : public ThreadManager,
         waitingTimeUs_(0),
         executingTimeUs_(0),
         numTasks_(0),
+        queueWaitUs_(enableTaskStats ? numPriorities : 0),
         state_(ThreadManager::UNINITIALIZED),
         tasks_(numPriorities),
         monitor_(&mutex_),
@@ -213,6 +233,7 @@ class ThreadManager::ImplT : public ThreadManager,
   void getStats(std::chrono::microseconds& waitTime,
                 std::chrono::microseconds& runTime,
                 int64_t maxItems) override;
+  std::vector<util::LogLinearHistogram> getQueueWaitHistograms() override;
   void enableCodel(bool) override;
   Codel* getCodel() override;
 
@@ -228,7 +249,8 @@ class ThreadManager::ImplT : public ThreadManager,
   Codel codel_;
 
  protected:
-  void add(
+  // Returns false if the task was dropped as the thread manager is stopped
+  bool add(
       size_t priority,
       shared_ptr<Runnable> value,
       int64_t timeout,
@@ -242,6 +264,32 @@ class ThreadManager::ImplT : public ThreadManager,
     return "";
   }
 
+  // Picks the next task to run, strict priority order by default
+  virtual bool tryDequeue(std::unique_ptr<Task>& task) {
+    return tasks_.try_dequeue(task);
+  }
+
+  // Called by the worker once it is done with a task returned by
+  // tryDequeue(), whether it ran or expired, if tryDequeue() asked for it
+  // with Task::setNeedsDoneNotification()
+  virtual void onTaskDone(const Task&) {}
+
+  // Queue of the requests for workers to exit once the pending tasks are
+  // done
+  virtual size_t exitRequestPriority() {
+    return tasks_.priorities() / 2; // median priority
+  }
+
+  // Wakes up an idle worker, e.g. when tryDequeue() held back a task which
+  // can now run
+  void wakeUpWorker() {
+    waitSem_.post();
+  }
+
+  folly::PriorityUMPMCQueueSet<std::unique_ptr<Task>, false>& taskQueues() {
+    return tasks_;
+  }
+
  private:
   void stopImpl(bool joinArg);
   void removeWorkerImpl(size_t value, bool afterTasks = false);
@@ -263,6 +311,8 @@ class ThreadManager::ImplT : public ThreadManager,
   std::chrono::microseconds waitingTimeUs_;
   std::chrono::microseconds executingTimeUs_;
   int64_t numTasks_;
+  // Per priority, also protected by statsLock_
+  std::vector<util::LogLinearHistogram> queueWaitUs_;
 
   ExpireCallback expireCallback_;
   ExpireCallback codelCallback_;
@@ -18,6 +18,7 @@
 
 #include <atomic>
 #include <cassert>
+#include <deque>
 #include <memory>
 #include <queue>
 #include <set>
@@ -27,7 +28,9 @@
 #include <folly/GLog.h>
 #include <folly/MPMCQueue.h>
 #include <folly/Memory.h>
+#include <folly/ScopeGuard.h>
 #include <folly/String.h>
+#include <folly/container/F14Map.h>
 #include <folly/executors/Codel.h>
 #include <folly/io/async/Request.h>
 
@@ -103,6 +106,11 @@ class ThreadManager::ImplT<SemType>::Worker : public Runnable {
         manager_->workerExiting(this);
         return;
       }
+      auto done = folly::makeGuard([&] {
+        if (task->needsDoneNotification()) {
+          manager_->onTaskDone(*task);
+        }
+      });
 
       // Getting the current time is moderately expensive,
       // so only get the time if we actually need it.
@@ -312,8 +320,7 @@ void ThreadManager::ImplT<SemType>::removeWorkerImpl(size_t value, bool afterTas
     // Insert nullptr tasks onto the tasks queue to ask workers to exit
     // after all current tasks are completed
     for (size_t n = 0; n < value; ++n) {
-      auto const qpriority = tasks_.priorities() / 2; // median priority
-      tasks_.at_priority(qpriority).enqueue(nullptr);
+      tasks_.at_priority(exitRequestPriority()).enqueue(nullptr);
       ++totalTaskCount_;
     }
     monitor_.notifyAll();
@@ -357,7 +364,7 @@ void ThreadManager::ImplT<SemType>::add(
 }
 
 template <typename SemType>
-void ThreadManager::ImplT<SemType>::add(
+bool ThreadManager::ImplT<SemType>::add(
     size_t priority,
     shared_ptr<Runnable> value,
     int64_t /*timeout*/,
@@ -376,12 +383,12 @@ void ThreadManager::ImplT<SemType>::add(
 
   if (state_ != ThreadManager::STARTED) {
     LOG(WARNING) << "abort add() that got called after join() or stop()";
-    return;
+    return false;
   }
 
-  auto task = std::make_unique<Task>(
-      std::move(value), std::chrono::milliseconds{expiration});
   auto const qpriority = std::min(tasks_.priorities() - 1, priority);
+  auto task = std::make_unique<Task>(
+      std::move(value), std::chrono::milliseconds{expiration}, qpriority);
   tasks_.at_priority(qpriority).enqueue(std::move(task));
 
   ++totalTaskCount_;
@@ -391,6 +398,7 @@ void ThreadManager::ImplT<SemType>::add(
     // are running and will get around to this task in time.
     waitSem_.post();
   }
+  return true;
 }
 
 template <typename SemType>
@@ -453,7 +461,7 @@ ThreadManager::ImplT<SemType>::waitOnTask() {
   std::unique_ptr<Task> task;
 
   // Fast path - if tasks are ready, get one
-  if (tasks_.try_dequeue(task)) {
+  if (tryDequeue(task)) {
     --totalTaskCount_;
     return task;
   }
@@ -468,7 +476,7 @@ ThreadManager::ImplT<SemType>::waitOnTask() {
   ++idleCount_;
   --totalTaskCount_;
   g.release();
-  while (!tasks_.try_dequeue(task)) {
+  while (!tryDequeue(task)) {
     waitSem_.wait();
     if (shouldStop()) {
       Guard f(mutex_);
@@ -528,6 +536,13 @@ void ThreadManager::ImplT<SemType>::getStats(std::chrono::microseconds& waitTime
   }
 }
 
+template <typename SemType>
+std::vector<util::LogLinearHistogram>
+ThreadManager::ImplT<SemType>::getQueueWaitHistograms() {
+  folly::MSLGuard g(statsLock_);
+  return queueWaitUs_;
+}
+
 template <typename SemType>
 void ThreadManager::ImplT<SemType>::reportTaskStats(
     const Task& task,
@@ -543,6 +558,8 @@ void ThreadManager::ImplT<SemType>::reportTaskStats(
     waitingTimeUs_ += waitTimeUs;
     executingTimeUs_ += runTimeUs;
     ++numTasks_;
+    queueWaitUs_[task.getPriority()].add(
+        std::max<int64_t>(0, waitTimeUs.count()));
   }
 
   // Optimistic check lock free
@@ -610,6 +627,14 @@ class PriorityQueueThreadManager : public ThreadManager::ImplT<SemType> {
       : ThreadManager::ImplT<SemType>(enableTaskStats, N_PRIORITIES),
         numThreads_(numThreads) {}
 
+  PriorityQueueThreadManager(
+      size_t numThreads,
+      const ThreadManager::PriorityQueueOptions& options,
+      bool enableTaskStats)
+      : PriorityQueueThreadManager(numThreads, enableTaskStats) {
+    setPriorityQueueOptions(options);
+  }
+
   class PriorityFunctionRunner :
       public virtual apache::thrift::concurrency::PriorityRunnable,
       public virtual FunctionRunner {
@@ -693,6 +718,18 @@ class PriorityQueueThreadManager : public ThreadManager::ImplT<SemType> {
     }
   }
 
+  void setPriorityQueueOptions(
+      const ThreadManager::PriorityQueueOptions& options) override {
+    folly::MSLGuard g(schedulerLock_);
+    weighted_ = false;
+    for (size_t i = 0; i < N_PRIORITIES; ++i) {
+      weights_[i] = options.weights[i];
+      credits_[i] = 0;
+      weighted_ = weighted_ || weights_[i] > 0;
+    }
+    reservedThreads_ = options.reservedThreads;
+  }
+
   using Task = typename ThreadManager::ImplT<SemType>::Task;
 
   std::string statContext(const Task& task) override {
@@ -703,9 +740,149 @@ class PriorityQueueThreadManager : public ThreadManager::ImplT<SemType> {
     return statContexts_[prio];
   }
 
+ protected:
+  bool tryDequeue(std::unique_ptr<Task>& task) override {
+    if (!isScheduled()) {
+      // Strict priority without reserved threads: nothing to account for
+      return ThreadManager::ImplT<SemType>::tryDequeue(task);
+    }
+
+    bool heldBack = false;
+    if (tryDequeueScheduled(task, heldBack)) {
+      return true;
+    }
+    if (heldBack) {
+      // The worker may have consumed the wake up of the task it held back:
+      // wake up another one when a thread is released.
+      ++heldBack_;
+    }
+    return false;
+  }
+
+  void onTaskDone(const Task&) override {
+    --running_;
+    auto heldBack = heldBack_.load();
+    while (heldBack > 0 &&
+           !heldBack_.compare_exchange_weak(heldBack, heldBack - 1)) {
+    }
+    if (heldBack > 0) {
+      this->wakeUpWorker();
+    }
+  }
+
+  size_t exitRequestPriority() override {
+    // Weighted scheduling doesn't serve the priorities in order: exit
+    // requests go last so that join() still runs every pending task.
+    return isScheduled()
+        ? N_PRIORITIES - 1
+        : ThreadManager::ImplT<SemType>::exitRequestPriority();
+  }
+
  private:
+  bool isScheduled() const {
+    return weighted_ || reservedThreads_ > 0;
+  }
+
+  bool tryDequeueScheduled(std::unique_ptr<Task>& task, bool& heldBack) {
+    std::array<uint32_t, N_PRIORITIES> weights;
+    {
+      folly::MSLGuard g(schedulerLock_);
+      weights = weights_;
+    }
+    for (size_t prio = 0; prio < N_PRIORITIES; ++prio) {
+      if (weights[prio] == 0 && tryDequeueAt(prio, task, heldBack)) {
+        return true;
+      }
+    }
+
+    // Smooth weighted round robin among the non-empty weighted queues: every
+    // candidate earns its weight, the richest one is served and pays for the
+    // whole round.
+    std::array<bool, N_PRIORITIES> tried{};
+    while (true) {
+      size_t best = N_PRIORITIES;
+      {
+        folly::MSLGuard g(schedulerLock_);
+        int64_t total = 0;
+        for (size_t prio = 0; prio < N_PRIORITIES; ++prio) {
+          if (weights_[prio] == 0 || tried[prio] ||
+              this->taskQueues().at_priority(prio).empty()) {
+            continue;
+          }
+          credits_[prio] += weights_[prio];
+          total += weights_[prio];
+          if (best == N_PRIORITIES || credits_[prio] > credits_[best]) {
+            best = prio;
+          }
+        }
+        if (best == N_PRIORITIES) {
+          return false;
+        }
+        credits_[best] -= total;
+      }
+      if (tryDequeueAt(best, task, heldBack)) {
+        return true;
+      }
+      tried[best] = true;
+    }
+  }
+
+  // Dequeues from a single priority, making sure that tasks other than
+  // HIGH_IMPORTANT leave reservedThreads_ threads available.
+  bool tryDequeueAt(size_t prio, std::unique_ptr<Task>& task, bool& heldBack) {
+    auto& queue = this->taskQueues().at_priority(prio);
+    if (prio == HIGH_IMPORTANT) {
+      return queue.try_dequeue(task);
+    }
+    auto workers = this->workerCount();
+    auto limit = workers > reservedThreads_ ? workers - reservedThreads_ : 1;
+    if (running_++ >= limit) {
+      --running_;
+      heldBack = heldBack || !queue.empty();
+      return false;
+    }
+    if (!queue.try_dequeue(task)) {
+      --running_;
+      return false;
+    }
+    if (!task) {
+      // Requests for the worker to exit are not accounted for
+      --running_;
+      if (hasPendingAbove(prio)) {
+        // Weighted scheduling may get to the exit requests before the other
+        // priorities are drained, join() must still run every pending task.
+        queue.enqueue(nullptr);
+        this->wakeUpWorker();
+        return false;
+      }
+      return true;
+    }
+    task->setNeedsDoneNotification();
+    return true;
+  }
+
+  bool hasPendingAbove(size_t prio) {
+    for (size_t i = 0; i < prio; ++i) {
+      if (!this->taskQueues().at_priority(i).empty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   size_t numThreads_;
   std::string statContexts_[N_PRIORITIES];
+
+  folly::MicroSpinLock schedulerLock_{0};
+  std::array<uint32_t, N_PRIORITIES> weights_{};
+  std::array<int64_t, N_PRIORITIES> credits_{};
+  std::atomic<bool> weighted_{false};
+  std::atomic<size_t> reservedThreads_{0};
+  // Tasks other than HIGH_IMPORTANT currently running, only accounted for
+  // when isScheduled()
+  std::atomic<size_t> running_{0};
+  // Tasks held back by the reserved threads since a thread was released
+  std::atomic<size_t> heldBack_{0};
 };
 
 static inline shared_ptr<ThreadFactory> Factory(
@@ -724,6 +901,264 @@ shared_ptr<ThreadManager> ThreadManager::newPriorityQueueThreadManager(
   return tm;
 }
 
+template <typename SemType>
+shared_ptr<ThreadManager> ThreadManager::newPriorityQueueThreadManager(
+    size_t numThreads,
+    const PriorityQueueOptions& options,
+    bool enableTaskStats) {
+  auto tm = make_shared<PriorityQueueThreadManager<SemType>>(
+      numThreads, options, enableTaskStats);
+  tm->threadFactory(Factory(PosixThreadFactory::NORMAL_PRI));
+  return tm;
+}
+
+template <typename SemType>
+class TenantFairThreadManager : public ThreadManager::ImplT<SemType> {
+ public:
+  using Task = typename ThreadManager::ImplT<SemType>::Task;
+  using TenantStats = ThreadManager::TenantStats;
+
+  // The tenants sharing the overflow queue are reported under this name
+  static constexpr folly::StringPiece kOverflowTenant{"*"};
+
+  TenantFairThreadManager(
+      size_t numThreads,
+      const ThreadManager::TenantQueueOptions& options,
+      bool enableTaskStats = false)
+      // One queue per tenant, one for the overflow tenants and one, served
+      // last, for the requests to stop workers.
+      : ThreadManager::ImplT<SemType>(
+            enableTaskStats,
+            options.maxTenants + 2),
+        numThreads_(numThreads),
+        options_(options),
+        overflowQueue_(options.maxTenants),
+        exitQueue_(options.maxTenants + 1),
+        queues_(options.maxTenants + 1) {
+    options_.quantum = std::max<uint32_t>(options_.quantum, 1);
+  }
+
+  using ThreadManager::ImplT<SemType>::add;
+
+  void add(
+      std::shared_ptr<Runnable> task,
+      int64_t timeout = 0,
+      int64_t expiration = 0,
+      bool cancellable = false,
+      bool numa = false) noexcept override {
+    size_t queue;
+    {
+      folly::MSLGuard g(lock_);
+      queue = getQueue(*task);
+      auto& state = queues_[queue];
+      if (options_.maxPendingPerTenant > 0 &&
+          state.pending >= options_.maxPendingPerTenant) {
+        ++state.rejected;
+        queue = exitQueue_;
+      } else {
+        ++state.admitted;
+        onEnqueue(queue);
+      }
+    }
+    if (queue == exitQueue_) {
+      // Dropping the task (outside of the lock) rejects it
+      return;
+    }
+    if (!ThreadManager::ImplT<SemType>::add(
+            queue, std::move(task), timeout, expiration, cancellable, numa)) {
+      folly::MSLGuard g(lock_);
+      --queues_[queue].admitted;
+      onDequeue(queue);
+    }
+  }
+
+  void start() override {
+    ThreadManager::ImplT<SemType>::start();
+    ThreadManager::ImplT<SemType>::addWorker(numThreads_);
+  }
+
+  std::vector<TenantStats> getTenantStats() const override {
+    std::vector<TenantStats> result;
+    folly::MSLGuard g(lock_);
+    result.reserve(nextQueue_ + 1);
+    for (size_t index = 0; index < nextQueue_; ++index) {
+      result.push_back(makeStats(index));
+    }
+    result.push_back(makeStats(overflowQueue_));
+    return result;
+  }
+
+ protected:
+  bool tryDequeue(std::unique_ptr<Task>& task) override {
+    auto& queues = this->taskQueues();
+    {
+      folly::MSLGuard g(lock_);
+      // Only the queues with pending tasks are visited, each at most once
+      for (size_t visited = active_.size(); visited > 0; --visited) {
+        auto index = active_.front();
+        auto& state = queues_[index];
+        if (state.pending == 0) {
+          // Its last task was rolled back
+          active_.pop_front();
+          state.active = false;
+          continue;
+        }
+        if (state.deficit == 0) {
+          // Start of this queue's turn
+          state.deficit = options_.quantum;
+        }
+        if (queues.at_priority(index).try_dequeue(task)) {
+          --state.deficit;
+          onDequeue(index);
+          if (state.active && state.deficit == 0) {
+            active_.pop_front();
+            active_.push_back(index);
+          }
+          return true;
+        }
+        // Its task is still being enqueued, come back to it later
+        active_.pop_front();
+        active_.push_back(index);
+      }
+    }
+    return queues.at_priority(exitQueue_).try_dequeue(task);
+  }
+
+  size_t exitRequestPriority() override {
+    return exitQueue_;
+  }
+
+ private:
+  struct Queue {
+    // Empty for the overflow queue and the unassigned ones
+    std::string tenant;
+    size_t pending{0};
+    uint64_t admitted{0};
+    uint64_t rejected{0};
+    // Tasks this queue can still dequeue in its turn
+    uint32_t deficit{0};
+    // Whether this queue is in active_, resp. idle_
+    bool active{false};
+    bool idle{false};
+  };
+
+  // Must be called with lock_ held
+  size_t getQueue(Runnable& runnable) {
+    auto* tenantRunnable = dynamic_cast<TenantRunnable*>(&runnable);
+    auto name = tenantRunnable ? tenantRunnable->getTenant(options_.tenantKey)
+                               : folly::StringPiece();
+    auto it = tenants_.find(name);
+    if (it != tenants_.end()) {
+      return it->second;
+    }
+    auto index = allocateQueue();
+    if (index != overflowQueue_) {
+      auto& state = queues_[index];
+      state.tenant = name.str();
+      state.admitted = 0;
+      state.rejected = 0;
+      tenants_.emplace(state.tenant, index);
+    }
+    return index;
+  }
+
+  // A queue never assigned, else the queue of the tenant idle for the longest
+  // time, else the overflow queue. Must be called with lock_ held.
+  size_t allocateQueue() {
+    if (nextQueue_ < overflowQueue_) {
+      return nextQueue_++;
+    }
+    while (!idle_.empty()) {
+      auto index = idle_.front();
+      idle_.pop_front();
+      auto& state = queues_[index];
+      state.idle = false;
+      // The tenant may have had new tasks since it became idle
+      if (state.pending == 0) {
+        tenants_.erase(state.tenant);
+        return index;
+      }
+    }
+    return overflowQueue_;
+  }
+
+  // Must be called with lock_ held
+  void onEnqueue(size_t index) {
+    auto& state = queues_[index];
+    ++state.pending;
+    if (!state.active) {
+      state.active = true;
+      active_.push_back(index);
+    }
+  }
+
+  // Must be called with lock_ held
+  void onDequeue(size_t index) {
+    auto& state = queues_[index];
+    if (--state.pending > 0) {
+      return;
+    }
+    // An empty queue doesn't keep its credit
+    state.deficit = 0;
+    if (state.active && active_.front() == index) {
+      active_.pop_front();
+      state.active = false;
+    }
+    if (index != overflowQueue_ && !state.idle) {
+      state.idle = true;
+      idle_.push_back(index);
+    }
+  }
+
+  // Must be called with lock_ held
+  TenantStats makeStats(size_t index) const {
+    const auto& state = queues_[index];
+    TenantStats stats;
+    if (index == overflowQueue_) {
+      stats.tenant = kOverflowTenant.str();
+      stats.overflow = true;
+    } else {
+      stats.tenant = state.tenant;
+    }
+    stats.pending = state.pending;
+    stats.admitted = state.admitted;
+    stats.rejected = state.rejected;
+    return stats;
+  }
+
+  const size_t numThreads_;
+  ThreadManager::TenantQueueOptions options_;
+  const size_t overflowQueue_;
+  const size_t exitQueue_;
+
+  mutable folly::MicroSpinLock lock_{0};
+  folly::F14FastMap<std::string, size_t> tenants_;
+  std::vector<Queue> queues_;
+  // Queues assigned so far, in [0, overflowQueue_]
+  size_t nextQueue_{0};
+  // Queues with pending tasks, in the order they are served. A queue whose
+  // tasks were all rolled back stays until its turn.
+  std::deque<size_t> active_;
+  // Tenant queues which became empty, oldest first. A queue which got new
+  // tasks since stays until it is reclaimed.
+  std::deque<size_t> idle_;
+};
+
+template <typename SemType>
+constexpr folly::StringPiece TenantFairThreadManager<SemType>::kOverflowTenant;
+
+template <typename SemType>
+std::shared_ptr<TenantFairThreadManager<SemType>>
+ThreadManager::newTenantFairThreadManager(
+    size_t numThreads,
+    const TenantQueueOptions& options,
+    bool enableTaskStats) {
+  auto tm = make_shared<TenantFairThreadManager<SemType>>(
+      numThreads, options, enableTaskStats);
+  tm->threadFactory(Factory(PosixThreadFactory::NORMAL_PRI));
+  return tm;
+}
+
 template <typename SemType>
 class PriorityThreadManager::PriorityImplT
     : public PriorityThreadManager,
@@ -963,6 +1398,16 @@ class PriorityThreadManager::PriorityImplT
     return managers_[priority]->getCodel();
   }
 
+  std::vector<util::LogLinearHistogram> getQueueWaitHistograms() override {
+    std::vector<util::LogLinearHistogram> result(N_PRIORITIES);
+    for (int i = 0; i < N_PRIORITIES; i++) {
+      for (const auto& histogram : managers_[i]->getQueueWaitHistograms()) {
+        result[i].merge(histogram);
+      }
+    }
+    return result;
+  }
+
  private:
   void joinKeepAliveOnce() {
     if (!std::exchange(keepAliveJoined_, true)) {
@@ -22,6 +22,8 @@
 #include <array>
 #include <functional>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <folly/Executor.h>
 #include <folly/SharedMutex.h>
@@ -35,6 +37,7 @@
 #include <thrift/lib/cpp/concurrency/Thread.h>
 #include <thrift/lib/cpp/concurrency/Util.h>
 #include <thrift/lib/cpp/concurrency/Monitor.h>
+#include <thrift/lib/cpp/util/LogLinearHistogram.h>
 
 DECLARE_bool(codel_enabled);
 
@@ -43,6 +46,8 @@ namespace apache { namespace thrift { namespace concurrency {
 class Runnable;
 class ThreadFactory;
 class ThreadManagerObserver;
+template <typename SemType>
+class TenantFairThreadManager;
 
 /**
  * ThreadManager class
@@ -218,6 +223,62 @@ class ThreadManager : public virtual folly::Executor {
       size_t numThreads,
       bool enableTaskStats = false);
 
+  /**
+   * How a single thread pool is shared between priorities.
+   *
+   * Priorities with a weight of 0 are served strictly, in priority order,
+   * before any other. Pending tasks of the remaining priorities are served in
+   * proportion to their weights, so that low priorities are not starved. The
+   * default (all weights 0) is strict priority.
+   *
+   * reservedThreads threads are kept for HIGH_IMPORTANT tasks: tasks of other
+   * priorities never occupy more than workerCount() - reservedThreads threads
+   * (and at least one).
+   */
+  struct PriorityQueueOptions {
+    std::array<uint32_t, N_PRIORITIES> weights{};
+    size_t reservedThreads{0};
+  };
+
+  template <typename SemType = folly::LifoSem>
+  static std::shared_ptr<ThreadManager> newPriorityQueueThreadManager(
+      size_t numThreads,
+      const PriorityQueueOptions& options,
+      bool enableTaskStats = false);
+
+  /**
+   * Updates the scheduling of a priority queue thread manager, can be called
+   * at any time. Ignored by other thread managers.
+   */
+  virtual void setPriorityQueueOptions(const PriorityQueueOptions&) {}
+
+  /**
+   * How a single thread pool is shared between tenants, identified by the
+   * value TenantRunnable::getTenant() returns for tenantKey. Tasks that are
+   * not TenantRunnables belong to the "" tenant. Priorities are ignored.
+   *
+   * Each tenant has its own queue, served by deficit round robin: when its
+   * turn comes, up to quantum tasks are dequeued from it. At most maxTenants
+   * tenants have a queue of their own: once they are all taken, a new tenant
+   * takes over the queue of the tenant idle (i.e. with no pending task) for
+   * the longest time, or shares a single overflow queue if none is idle.
+   * Tasks beyond maxPendingPerTenant pending ones (0 for unbounded) are
+   * rejected, i.e. dropped like on a full queue.
+   */
+  struct TenantQueueOptions {
+    std::string tenantKey;
+    uint32_t quantum{1};
+    size_t maxPendingPerTenant{0};
+    size_t maxTenants{64};
+  };
+
+  template <typename SemType = folly::LifoSem>
+  static std::shared_ptr<TenantFairThreadManager<SemType>>
+  newTenantFairThreadManager(
+      size_t numThreads,
+      const TenantQueueOptions& options,
+      bool enableTaskStats = false);
+
   /**
    * Get an internal statistics.
    *
@@ -232,6 +293,37 @@ class ThreadManager : public virtual folly::Executor {
     runTime = std::chrono::microseconds::zero();
   }
 
+  /**
+   * Distribution of the time (us) tasks spent in a queue, indexed by
+   * priority. Thread managers without priorities return a single
+   * histogram; empty if task stats are disabled.
+   */
+  virtual std::vector<util::LogLinearHistogram> getQueueWaitHistograms() {
+    return {};
+  }
+
+  /**
+   * Tasks of a tenant of a tenant fair thread manager, see
+   * TenantQueueOptions. The counters restart when a tenant gets a queue.
+   * The tenants sharing the overflow queue are accounted together, with
+   * overflow set.
+   */
+  struct TenantStats {
+    std::string tenant;
+    bool overflow{false};
+    size_t pending{0};
+    uint64_t admitted{0};
+    uint64_t rejected{0};
+  };
+
+  /**
+   * The tenants currently having a queue, and the overflow one. Empty for
+   * thread managers which don't share their threads between tenants.
+   */
+  virtual std::vector<TenantStats> getTenantStats() const {
+    return {};
+  }
+
   struct RunStats {
     const std::string& threadPoolName;
     SystemClockTimePoint queueBegin;
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include <folly/portability/GFlags.h>
+#include <folly/synchronization/Baton.h>
+
+#include <thrift/lib/cpp/concurrency/ThreadManager.h>
+
+DEFINE_int32(threads, 8, "Total number of worker threads");
+DEFINE_int32(task_us, 20, "Time in us each task spins for");
+
+using namespace apache::thrift::concurrency;
+
+namespace {
+
+using PriorityFunctionRunner =
+    PriorityQueueThreadManager<folly::LifoSem>::PriorityFunctionRunner;
+
+// Mixed load, mostly NORMAL with some of every other priority
+constexpr size_t kBatch = 1000;
+PRIORITY taskPriority(size_t i) {
+  switch (i % 20) {
+    case 0:
+      return HIGH_IMPORTANT;
+    case 1:
+    case 2:
+      return HIGH;
+    case 3:
+    case 4:
+      return IMPORTANT;
+    case 5:
+    case 6:
+    case 7:
+      return BEST_EFFORT;
+    default:
+      return NORMAL;
+  }
+}
+
+void spin() {
+  auto end = std::chrono::steady_clock::now() +
+      std::chrono::microseconds(FLAGS_task_us);
+  while (std::chrono::steady_clock::now() < end) {
+  }
+}
+
+void runBatch(ThreadManager& threadManager) {
+  std::atomic<size_t> remaining{kBatch};
+  folly::Baton<> done;
+  for (size_t i = 0; i < kBatch; ++i) {
+    threadManager.add(
+        std::make_shared<PriorityFunctionRunner>(taskPriority(i), [&] {
+          spin();
+          if (--remaining == 0) {
+            done.post();
+          }
+        }));
+  }
+  done.wait();
+}
+
+// Same total number of threads, one for each priority other than NORMAL
+std::shared_ptr<ThreadManager> priorityThreadManager(bool stats) {
+  size_t threads = FLAGS_threads;
+  size_t normal = threads > 4 ? threads - 4 : 1;
+  return PriorityThreadManager::newPriorityThreadManager(
+      {{1, 1, 1, normal, 1}}, stats);
+}
+
+std::shared_ptr<ThreadManager> strictPriorityQueue(bool stats) {
+  return ThreadManager::newPriorityQueueThreadManager(FLAGS_threads, stats);
+}
+
+std::shared_ptr<ThreadManager> weightedPriorityQueue(bool stats) {
+  ThreadManager::PriorityQueueOptions options;
+  options.weights = {{0, 16, 8, 4, 1}};
+  options.reservedThreads = 1;
+  return ThreadManager::newPriorityQueueThreadManager(
+      FLAGS_threads, options, stats);
+}
+
+template <class Factory>
+void runBenchmark(size_t iters, Factory factory) {
+  folly::BenchmarkSuspender setup;
+  auto threadManager = factory(false);
+  threadManager->start();
+  setup.dismiss();
+  for (size_t i = 0; i < iters; ++i) {
+    runBatch(*threadManager);
+  }
+  setup.rehire();
+  threadManager->join();
+}
+
+// Per priority queueing latency of a few batches
+template <class Factory>
+void reportLatency(const char* name, Factory factory) {
+  auto threadManager = factory(true);
+  threadManager->start();
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < 10; ++i) {
+    runBatch(*threadManager);
+  }
+  auto wall = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - begin);
+  threadManager->join();
+  // Share of the pool's time spent running tasks
+  double utilization = 10.0 * kBatch * FLAGS_task_us /
+      (static_cast<double>(wall.count()) * FLAGS_threads);
+  std::cout << name << ": utilization " << utilization * 100 << "%\n";
+  auto histograms = threadManager->getQueueWaitHistograms();
+  for (size_t prio = 0; prio < histograms.size(); ++prio) {
+    std::cout << "  priority " << prio
+              << " queue wait p50=" << histograms[prio].percentile(50)
+              << "us p99=" << histograms[prio].percentile(99) << "us\n";
+  }
+}
+
+} // namespace
+
+BENCHMARK(PriorityThreadManager, iters) {
+  runBenchmark(iters, priorityThreadManager);
+}
+
+BENCHMARK_RELATIVE(StrictPriorityQueue, iters) {
+  runBenchmark(iters, strictPriorityQueue);
+}
+
+BENCHMARK_RELATIVE(WeightedPriorityQueue, iters) {
+  runBenchmark(iters, weightedPriorityQueue);
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  reportLatency("PriorityThreadManager", priorityThreadManager);
+  reportLatency("StrictPriorityQueue", strictPriorityQueue);
+  reportLatency("WeightedPriorityQueue", weightedPriorityQueue);
+  return 0;
+}
@@ -16,11 +16,13 @@
 
 #include <numa.h>
 
+#include <algorithm>
 #include <chrono>
 #include <deque>
 #include <iostream>
 #include <memory>
 #include <random>
+#include <string>
 #include <thread>
 
 #include <folly/Synchronized.h>
@@ -831,3 +833,257 @@ TEST_F(ThreadManagerTest, PriorityQueueThreadManagerExecutor) {
 
   EXPECT_EQ("bca", foo);
 }
+
+TEST_F(ThreadManagerTest, QueueWaitHistograms) {
+  auto threadManager =
+      ThreadManager::newPriorityQueueThreadManager(1, true /*stats*/);
+  threadManager->start();
+  folly::Baton<> reqSyncBaton;
+  // block the TM
+  threadManager->add([&] { reqSyncBaton.wait(); });
+
+  // addWithPriority() takes executor priorities: 2 is HIGH, -1 BEST_EFFORT
+  threadManager->addWithPriority([] {}, 2);
+  threadManager->addWithPriority([] {}, -1);
+  threadManager->addWithPriority([] {}, -1);
+  /* sleep override */
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  // unblock the TM
+  reqSyncBaton.post();
+  threadManager->join();
+
+  auto histograms = threadManager->getQueueWaitHistograms();
+  ASSERT_EQ(N_PRIORITIES, histograms.size());
+  // The blocking task, added at HIGH_IMPORTANT by default
+  EXPECT_EQ(1, histograms[PRIORITY::HIGH_IMPORTANT].count());
+  EXPECT_EQ(1, histograms[PRIORITY::HIGH].count());
+  EXPECT_EQ(2, histograms[PRIORITY::BEST_EFFORT].count());
+  EXPECT_EQ(0, histograms[PRIORITY::IMPORTANT].count());
+  EXPECT_LE(20000, histograms[PRIORITY::BEST_EFFORT].percentile(50));
+
+  // Not collected without task stats
+  auto noStats = ThreadManager::newSimpleThreadManager(1);
+  noStats->start();
+  noStats->add([] {});
+  noStats->join();
+  EXPECT_TRUE(noStats->getQueueWaitHistograms().empty());
+}
+
+TEST_F(ThreadManagerTest, PriorityQueueThreadManagerWeighted) {
+  ThreadManager::PriorityQueueOptions options;
+  options.weights[PRIORITY::NORMAL] = 3;
+  options.weights[PRIORITY::BEST_EFFORT] = 1;
+  auto threadManager = ThreadManager::newPriorityQueueThreadManager(1, options);
+  threadManager->start();
+  folly::Baton<> reqSyncBaton;
+  // block the TM
+  threadManager->add([&] { reqSyncBaton.wait(); });
+
+  std::string order;
+  for (int i = 0; i < 8; ++i) {
+    threadManager->addWithPriority([&] { order += "n"; }, 0);
+    threadManager->addWithPriority([&] { order += "b"; }, -1);
+  }
+  // IMPORTANT has no weight: served strictly before the weighted ones
+  threadManager->addWithPriority([&] { order += "i"; }, 1);
+
+  // unblock the TM
+  reqSyncBaton.post();
+  threadManager->join();
+
+  EXPECT_EQ("innbnnnbnnnbbbbbb", order);
+}
+
+TEST_F(ThreadManagerTest, PriorityQueueThreadManagerReservedThreads) {
+  ThreadManager::PriorityQueueOptions options;
+  options.reservedThreads = 1;
+  auto threadManager = ThreadManager::newPriorityQueueThreadManager(2, options);
+  threadManager->start();
+  folly::Baton<> reqSyncBaton;
+  folly::Baton<> highDoneBaton;
+  std::atomic<bool> normalRan{false};
+  threadManager->addWithPriority([&] { reqSyncBaton.wait(); }, 0);
+  threadManager->addWithPriority([&] { normalRan = true; }, 0);
+  threadManager->add([&] { highDoneBaton.post(); });
+
+  // The second thread only serves HIGH_IMPORTANT tasks
+  EXPECT_TRUE(highDoneBaton.try_wait_for(std::chrono::seconds(5)));
+  /* sleep override */
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(normalRan);
+
+  // Without reservation, both threads serve any priority
+  threadManager->setPriorityQueueOptions({});
+  reqSyncBaton.post();
+  threadManager->join();
+  EXPECT_TRUE(normalRan);
+}
+
+namespace {
+
+class TenantTask : public TenantRunnable {
+ public:
+  TenantTask(std::string tenant, folly::Func func)
+      : tenant_(std::move(tenant)), func_(std::move(func)) {}
+
+  void run() override {
+    func_();
+  }
+
+  folly::StringPiece getTenant(folly::StringPiece key) const override {
+    return key == "client_id" ? folly::StringPiece(tenant_)
+                              : folly::StringPiece();
+  }
+
+ private:
+  std::string tenant_;
+  folly::Func func_;
+};
+
+ThreadManager::TenantQueueOptions tenantOptions() {
+  ThreadManager::TenantQueueOptions options;
+  options.tenantKey = "client_id";
+  return options;
+}
+
+} // namespace
+
+TEST_F(ThreadManagerTest, TenantFairThreadManagerRoundRobin) {
+  auto options = tenantOptions();
+  options.quantum = 2;
+  auto threadManager = ThreadManager::newTenantFairThreadManager(1, options);
+  threadManager->start();
+  folly::Baton<> reqSyncBaton;
+  // block the TM, this task belongs to the "" tenant
+  threadManager->add([&] { reqSyncBaton.wait(); });
+
+  std::string order;
+  for (int i = 0; i < 4; ++i) {
+    threadManager->add(
+        std::make_shared<TenantTask>("a", [&] { order += "a"; }));
+  }
+  for (int i = 0; i < 4; ++i) {
+    threadManager->add(
+        std::make_shared<TenantTask>("b", [&] { order += "b"; }));
+  }
+
+  // unblock the TM
+  reqSyncBaton.post();
+  threadManager->join();
+
+  // The flooding tenant doesn't delay the other one
+  EXPECT_EQ("aabbaabb", order);
+}
+
+TEST_F(ThreadManagerTest, TenantFairThreadManagerLimits) {
+  auto options = tenantOptions();
+  options.maxPendingPerTenant = 2;
+  options.maxTenants = 2;
+  auto threadManager = ThreadManager::newTenantFairThreadManager(1, options);
+  threadManager->start();
+  folly::Baton<> started;
+  folly::Baton<> reqSyncBaton;
+  // block the TM, the "" tenant is idle once this task runs
+  threadManager->add([&] {
+    started.post();
+    reqSyncBaton.wait();
+  });
+  started.wait();
+
+  std::atomic<int> ran{0};
+  for (const auto& tenant : {"a", "a", "a", "b", "c", "c"}) {
+    threadManager->add(std::make_shared<TenantTask>(tenant, [&] { ++ran; }));
+  }
+
+  auto stats = threadManager->getTenantStats();
+  std::sort(stats.begin(), stats.end(), [](const auto& x, const auto& y) {
+    return x.tenant < y.tenant;
+  });
+  // "b" took over the queue of the idle "" tenant, "c" came when no queue
+  // was left
+  ASSERT_EQ(3, stats.size());
+  EXPECT_EQ("*", stats[0].tenant);
+  EXPECT_TRUE(stats[0].overflow);
+  EXPECT_EQ(2, stats[0].pending);
+  EXPECT_EQ("a", stats[1].tenant);
+  EXPECT_FALSE(stats[1].overflow);
+  EXPECT_EQ(2, stats[1].pending);
+  EXPECT_EQ(2, stats[1].admitted);
+  EXPECT_EQ(1, stats[1].rejected);
+  EXPECT_EQ("b", stats[2].tenant);
+  EXPECT_EQ(1, stats[2].pending);
+
+  reqSyncBaton.post();
+  threadManager->join();
+  EXPECT_EQ(5, ran);
+  for (const auto& tenantStats : threadManager->getTenantStats()) {
+    EXPECT_EQ(0, tenantStats.pending);
+  }
+}
+
+TEST_F(ThreadManagerTest, TenantFairThreadManagerEvictsIdleTenants) {
+  auto options = tenantOptions();
+  options.maxTenants = 1;
+  auto threadManager = ThreadManager::newTenantFairThreadManager(1, options);
+  threadManager->start();
+
+  // Each tenant in turn finds the queue of the previous one idle
+  for (const auto& tenant : {"a", "b", "c"}) {
+    folly::Baton<> ran;
+    threadManager->add(
+        std::make_shared<TenantTask>(tenant, [&] { ran.post(); }));
+    ran.wait();
+    auto stats = threadManager->getTenantStats();
+    ASSERT_EQ(2, stats.size());
+    EXPECT_EQ(tenant, stats[0].tenant);
+    EXPECT_EQ(1, stats[0].admitted);
+    EXPECT_TRUE(stats[1].overflow);
+    EXPECT_EQ(0, stats[1].admitted);
+  }
+  threadManager->join();
+}
+
+TEST_F(ThreadManagerTest, TenantFairThreadManagerOverflowName) {
+  auto options = tenantOptions();
+  options.maxTenants = 1;
+  auto threadManager = ThreadManager::newTenantFairThreadManager(1, options);
+  threadManager->start();
+  folly::Baton<> started;
+  folly::Baton<> reqSyncBaton;
+  threadManager->add([&] {
+    started.post();
+    reqSyncBaton.wait();
+  });
+  started.wait();
+
+  // A tenant named like the overflow one isn't mixed up with it
+  threadManager->add(std::make_shared<TenantTask>("*", [] {}));
+  threadManager->add(std::make_shared<TenantTask>("a", [] {}));
+
+  auto stats = threadManager->getTenantStats();
+  ASSERT_EQ(2, stats.size());
+  EXPECT_EQ("*", stats[0].tenant);
+  EXPECT_FALSE(stats[0].overflow);
+  EXPECT_EQ(1, stats[0].pending);
+  EXPECT_EQ("*", stats[1].tenant);
+  EXPECT_TRUE(stats[1].overflow);
+  EXPECT_EQ(1, stats[1].pending);
+
+  reqSyncBaton.post();
+  threadManager->join();
+}
+
+TEST_F(ThreadManagerTest, TenantFairThreadManagerAddAfterStop) {
+  auto threadManager =
+      ThreadManager::newTenantFairThreadManager(1, tenantOptions());
+  threadManager->start();
+  threadManager->join();
+
+  // The dropped task isn't left pending
+  threadManager->add(std::make_shared<TenantTask>("a", [] {}));
+  for (const auto& tenantStats : threadManager->getTenantStats()) {
+    EXPECT_EQ(0, tenantStats.pending);
+    EXPECT_EQ(0, tenantStats.admitted);
+  }
+}
@@ -106,6 +106,8 @@ class TServerObserver {
 
   virtual void taskTimeout() {}
 
+  virtual void deadlineExceeded() {}
+
   virtual void serverOverloaded() {}
 
   virtual void receivedRequest() {}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+
+#include <folly/Optional.h>
+#include <folly/Range.h>
+#include <folly/small_vector.h>
+
+namespace apache {
+namespace thrift {
+namespace transport {
+
+/**
+ * Compact storage for the key-value headers of a received message.
+ *
+ * All the keys and values are stored back to back in a single buffer and
+ * looked up linearly. For the handful of small headers a request usually
+ * carries, this is faster than a std::map and costs one or two allocations
+ * per message instead of three per header. When a key is inserted twice the
+ * last value wins, as with std::map::operator[].
+ *
+ * The StringPieces returned by find() and forEach() point into the buffer,
+ * they are invalidated by any modification.
+ */
+class FlatHeaderMap {
+ public:
+  // Location of a key or a value in the buffer
+  struct Slice {
+    uint32_t offset;
+    uint32_t length;
+  };
+
+  size_t size() const {
+    return entries_.size();
+  }
+
+  bool empty() const {
+    return entries_.empty();
+  }
+
+  void clear() {
+    buffer_.clear();
+    entries_.clear();
+  }
+
+  /**
+   * Appends `length` bytes written by `fill(char*)` to the buffer, so that
+   * keys and values can be read straight from a cursor without going through
+   * a temporary string.
+   */
+  template <typename Fill>
+  Slice append(size_t length, Fill&& fill) {
+    Slice slice{static_cast<uint32_t>(buffer_.size()),
+                static_cast<uint32_t>(length)};
+    buffer_.resize(buffer_.size() + length);
+    fill(&buffer_[slice.offset]);
+    return slice;
+  }
+
+  Slice append(folly::StringPiece str) {
+    return append(
+        str.size(), [&](char* dest) { memcpy(dest, str.data(), str.size()); });
+  }
+
+  void insertOrAssign(Slice key, Slice value) {
+    for (auto& entry : entries_) {
+      if (get(entry.key) == get(key)) {
+        entry.value = value;
+        return;
+      }
+    }
+    entries_.push_back({key, value});
+  }
+
+  void insertOrAssign(folly::StringPiece key, folly::StringPiece value) {
+    auto keySlice = append(key);
+    insertOrAssign(keySlice, append(value));
+  }
+
+  // Only inserts if the key is not present yet, as std::map::insert
+  void insert(folly::StringPiece key, folly::StringPiece value) {
+    if (!find(key)) {
+      entries_.push_back({append(key), append(value)});
+    }
+  }
+
+  folly::Optional<folly::StringPiece> find(folly::StringPiece key) const {
+    for (const auto& entry : entries_) {
+      if (get(entry.key) == key) {
+        return get(entry.value);
+      }
+    }
+    return folly::none;
+  }
+
+  // Calls f(StringPiece key, StringPiece value) for every header
+  template <typename F>
+  void forEach(F&& f) const {
+    for (const auto& entry : entries_) {
+      f(get(entry.key), get(entry.value));
+    }
+  }
+
+  std::map<std::string, std::string> toMap() const {
+    std::map<std::string, std::string> map;
+    forEach([&](folly::StringPiece key, folly::StringPiece value) {
+      map.emplace(key.str(), value.str());
+    });
+    return map;
+  }
+
+ private:
+  struct Entry {
+    Slice key;
+    Slice value;
+  };
+
+  folly::StringPiece get(Slice slice) const {
+    return folly::StringPiece(buffer_.data() + slice.offset, slice.length);
+  }
+
+  std::string buffer_;
+  folly::small_vector<Entry, 16> entries_;
+};
+
+} // namespace transport
+} // namespace thrift
+} // namespace apache
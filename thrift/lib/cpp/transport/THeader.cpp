@@ -60,6 +60,7 @@ const string THeader::ID_VERSION = "1";
 const string THeader::PRIORITY_HEADER = "thrift_priority";
 const string& THeader::CLIENT_TIMEOUT_HEADER = *(new string("client_timeout"));
 const string THeader::QUEUE_TIMEOUT_HEADER = "queue_timeout";
+const string THeader::DEADLINE_HEADER = "deadline_ms";
 const string THeader::QUERY_LOAD_HEADER = "load";
 
 std::string getReadableChars(Cursor c, size_t limit) {
@@ -161,6 +162,7 @@ unique_ptr<IOBuf> THeader::removeHttpClient(IOBufQueue* queue, size_t& needed) {
       if (parser.readDataAvailable(toCopyLen)) {
         queue->trimStart(bytesParsed - parser.getUnparsedDataLen());
         readHeaders_ = parser.moveReadHeaders();
+        clearFlatReadHeaders();
         return memBuffer.cloneBufferAsIOBuf();
       }
       remainingDataLen -= toCopyLen;
@@ -426,11 +428,40 @@ static void readInfoHeaders(
   }
 }
 
+static FlatHeaderMap::Slice readFlatString(
+    RWPrivateCursor& c,
+    FlatHeaderMap& headers) {
+  auto sz = readVarint<uint32_t>(c);
+  if (!c.canAdvance(sz)) {
+    throw TTransportException(
+        TTransportException::CORRUPTED_DATA,
+        folly::stringPrintf(
+            "String size %u is larger than available %zu bytes",
+            sz,
+            c.totalLength()));
+  }
+  return headers.append(sz, [&](char* dest) { c.pull(dest, sz); });
+}
+
+/**
+ * Same as readInfoHeaders, but copies the strings straight from the cursor
+ * into the flat storage instead of allocating them one by one.
+ */
+static void readFlatInfoHeaders(RWPrivateCursor& c, FlatHeaderMap& headers) {
+  uint32_t numKVHeaders = readVarint<int32_t>(c);
+  while (numKVHeaders--) {
+    auto key = readFlatString(c, headers);
+    auto value = readFlatString(c, headers);
+    headers.insertOrAssign(key, value);
+  }
+}
+
 unique_ptr<IOBuf> THeader::readHeaderFormat(
     unique_ptr<IOBuf> buf,
     StringToStringMap& persistentReadHeaders) {
   readTrans_.clear(); // Clear out any previous transforms.
   readHeaders_.clear(); // Clear out any previous headers.
+  clearFlatReadHeaders();
 
   // magic(4), seqId(2), flags(2), headerSize(2)
   const uint8_t commonHeaderSize = 10;
@@ -474,7 +505,7 @@ unique_ptr<IOBuf> THeader::readHeaderFormat(
     }
     switch (infoId) {
       case infoIdType::KEYVALUE:
-        readInfoHeaders(c, readHeaders_);
+        readFlatInfoHeaders(c, flatReadHeaders_);
         break;
       case infoIdType::PKEYVALUE:
         readInfoHeaders(c, persistentReadHeaders);
@@ -483,9 +514,8 @@ unique_ptr<IOBuf> THeader::readHeaderFormat(
   }
 
   // if persistent headers are not empty, merge together.
-  if (!persistentReadHeaders.empty()) {
-    readHeaders_.insert(
-        persistentReadHeaders.begin(), persistentReadHeaders.end());
+  for (const auto& header : persistentReadHeaders) {
+    flatReadHeaders_.insert(header.first, header.second);
   }
 
   // Get just the data section using trim on a queue
@@ -704,10 +734,33 @@ void THeader::setHeaders(THeader::StringToStringMap&& headers) {
 
 void THeader::setReadHeaders(THeader::StringToStringMap&& headers) {
   readHeaders_ = std::move(headers);
+  clearFlatReadHeaders();
 }
 
 void THeader::eraseReadHeader(const std::string& key) {
+  getHeaders();
   readHeaders_.erase(key);
+  clearFlatReadHeaders();
+}
+
+void THeader::materializeReadHeaders() const {
+  std::lock_guard<std::mutex> guard(readHeadersMutex_);
+  if (!readHeadersMaterialized_.load(std::memory_order_relaxed)) {
+    readHeaders_ = flatReadHeaders_.toMap();
+    readHeadersMaterialized_.store(true, std::memory_order_release);
+  }
+}
+
+folly::Optional<folly::StringPiece> THeader::getReadHeader(
+    folly::StringPiece key) const {
+  if (!flatReadHeaders_.empty()) {
+    return flatReadHeaders_.find(key);
+  }
+  auto it = readHeaders_.find(key.str());
+  if (it == readHeaders_.end()) {
+    return folly::none;
+  }
+  return folly::StringPiece(it->second);
 }
 
 static size_t getInfoHeaderSize(const THeader::StringToStringMap& headers) {
@@ -739,9 +792,11 @@ void THeader::clearHeaders() {
 }
 
 string THeader::getPeerIdentity() {
-  if (readHeaders_.find(IDENTITY_HEADER) != readHeaders_.end()) {
-    if (readHeaders_[ID_VERSION_HEADER] == ID_VERSION) {
-      return readHeaders_[IDENTITY_HEADER];
+  auto identity = getReadHeader(IDENTITY_HEADER);
+  if (identity) {
+    auto version = getReadHeader(ID_VERSION_HEADER);
+    if (version && *version == ID_VERSION) {
+      return identity->str();
     }
   }
   return "";
@@ -917,17 +972,16 @@ apache::thrift::concurrency::PRIORITY THeader::getCallPriority() {
   if (priority_) {
     return *priority_;
   }
-  const auto& map = getHeaders();
-  auto iter = map.find(PRIORITY_HEADER);
-  if (iter != map.end()) {
+  auto value = getReadHeader(PRIORITY_HEADER);
+  if (value) {
     try {
-      unsigned prio = folly::to<unsigned>(iter->second);
+      unsigned prio = folly::to<unsigned>(*value);
       if (prio < apache::thrift::concurrency::N_PRIORITIES) {
         return static_cast<apache::thrift::concurrency::PRIORITY>(prio);
       }
     } catch (const std::range_error&) {
     }
-    LOG(INFO) << "Bad method priority " << iter->second << ", using default";
+    LOG(INFO) << "Bad method priority " << *value << ", using default";
   }
   // no priority
   return apache::thrift::concurrency::N_PRIORITIES;
@@ -935,15 +989,14 @@ apache::thrift::concurrency::PRIORITY THeader::getCallPriority() {
 
 std::chrono::milliseconds THeader::getTimeoutFromHeader(
     const std::string& header) const {
-  const auto& map = getHeaders();
-  auto iter = map.find(header);
-  if (iter != map.end()) {
+  auto value = getReadHeader(header);
+  if (value) {
     try {
-      int64_t timeout = folly::to<int64_t>(iter->second);
+      int64_t timeout = folly::to<int64_t>(*value);
       return std::chrono::milliseconds(timeout);
     } catch (const std::range_error&) {
     }
-    LOG(INFO) << "Bad client timeout " << iter->second << ", using default";
+    LOG(INFO) << "Bad client timeout " << *value << ", using default";
   }
 
   return std::chrono::milliseconds(0);
@@ -965,6 +1018,14 @@ std::chrono::milliseconds THeader::getClientQueueTimeout() const {
   }
 }
 
+std::chrono::milliseconds THeader::getDeadline() const {
+  if (deadline_) {
+    return *deadline_;
+  } else {
+    return getTimeoutFromHeader(DEADLINE_HEADER);
+  }
+}
+
 void THeader::setHttpClientParser(shared_ptr<THttpClientParser> parser) {
   CHECK(clientType_ == THRIFT_HTTP_CLIENT_TYPE);
   httpClientParser_ = parser;
@@ -978,6 +1039,10 @@ void THeader::setClientQueueTimeout(std::chrono::milliseconds timeout) {
   queueTimeout_ = timeout;
 }
 
+void THeader::setDeadline(std::chrono::milliseconds deadline) {
+  deadline_ = deadline;
+}
+
 void THeader::setCallPriority(apache::thrift::concurrency::PRIORITY priority) {
   priority_ = priority;
 }
@@ -17,8 +17,10 @@
 #ifndef THRIFT_TRANSPORT_THEADER_H_
 #define THRIFT_TRANSPORT_THEADER_H_ 1
 
+#include <atomic>
 #include <functional>
 #include <map>
+#include <mutex>
 #include <vector>
 
 #include <folly/Optional.h>
@@ -26,6 +28,7 @@
 #include <folly/portability/Unistd.h>
 #include <thrift/lib/cpp/concurrency/Thread.h>
 #include <thrift/lib/cpp/protocol/TProtocolTypes.h>
+#include <thrift/lib/cpp/transport/FlatHeaderMap.h>
 
 #include <bitset>
 #include <chrono>
@@ -219,13 +222,39 @@ class THeader {
   // these work with read headers
   void setReadHeaders(StringToStringMap&&);
   void eraseReadHeader(const std::string& key);
+
+  /**
+   * Headers parsed from the wire are kept in a flat buffer, the map is only
+   * built the first time it is requested. Concurrent calls are safe (the map
+   * is built once under a lock), but not concurrent modifications.
+   */
   const StringToStringMap& getHeaders() const {
+    if (!flatReadHeaders_.empty() &&
+        !readHeadersMaterialized_.load(std::memory_order_acquire)) {
+      materializeReadHeaders();
+    }
     return readHeaders_;
   }
 
+  /**
+   * Whether there are no read headers, without building the map.
+   */
+  bool readHeadersEmpty() const {
+    return flatReadHeaders_.empty() && readHeaders_.empty();
+  }
+
+  /**
+   * Looks up a single read header without building the map. The returned
+   * StringPiece is invalidated by any modification of the read headers.
+   */
+  folly::Optional<folly::StringPiece> getReadHeader(
+      folly::StringPiece key) const;
+
   StringToStringMap releaseHeaders() {
+    getHeaders();
     StringToStringMap headers;
     readHeaders_.swap(headers);
+    clearFlatReadHeaders();
     return headers;
   }
 
@@ -321,11 +350,16 @@ class THeader {
 
   std::chrono::milliseconds getClientQueueTimeout() const;
 
+  // Absolute deadline of the request (milliseconds since the Unix epoch),
+  // 0 if none.
+  std::chrono::milliseconds getDeadline() const;
+
   void setHttpClientParser(
       std::shared_ptr<apache::thrift::util::THttpClientParser>);
 
   void setClientTimeout(std::chrono::milliseconds timeout);
   void setClientQueueTimeout(std::chrono::milliseconds timeout);
+  void setDeadline(std::chrono::milliseconds deadline);
   void setCallPriority(apache::thrift::concurrency::PRIORITY priority);
 
   // Utility method for converting TRANSFORMS enum to string
@@ -348,6 +382,7 @@ class THeader {
   static const std::string PRIORITY_HEADER;
   static const std::string& CLIENT_TIMEOUT_HEADER;
   static const std::string QUEUE_TIMEOUT_HEADER;
+  static const std::string DEADLINE_HEADER;
   static const std::string QUERY_LOAD_HEADER;
 
  protected:
@@ -395,8 +430,12 @@ class THeader {
   std::vector<uint16_t> readTrans_;
   std::vector<uint16_t> writeTrans_;
 
-  // Map to use for headers
-  StringToStringMap readHeaders_;
+  // Map to use for headers. Read headers parsed from the wire are stored in
+  // flatReadHeaders_ and only copied into readHeaders_ by getHeaders().
+  mutable StringToStringMap readHeaders_;
+  FlatHeaderMap flatReadHeaders_;
+  mutable std::atomic<bool> readHeadersMaterialized_{false};
+  mutable std::mutex readHeadersMutex_;
   StringToStringMap writeHeaders_;
 
   // Won't be cleared when flushing
@@ -406,6 +445,7 @@ class THeader {
   // the header map.
   folly::Optional<std::chrono::milliseconds> clientTimeout_;
   folly::Optional<std::chrono::milliseconds> queueTimeout_;
+  folly::Optional<std::chrono::milliseconds> deadline_;
   folly::Optional<apache::thrift::concurrency::PRIORITY> priority_;
 
   static const std::string IDENTITY_HEADER;
@@ -421,6 +461,12 @@ class THeader {
   size_t getMaxWriteHeadersSize(
       const StringToStringMap& persistentWriteHeaders) const;
 
+  void materializeReadHeaders() const;
+  void clearFlatReadHeaders() {
+    flatReadHeaders_.clear();
+    readHeadersMaterialized_.store(false, std::memory_order_relaxed);
+  }
+
   /**
    * Returns whether the 1st byte of the protocol payload should be hadled
    * as compact framed.
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+
+#include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include <folly/init/Init.h>
+#include <folly/io/IOBuf.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBufQueue.h>
+
+#include <thrift/lib/cpp/transport/FlatHeaderMap.h>
+#include <thrift/lib/cpp/transport/THeader.h>
+#include <thrift/lib/cpp/util/VarintUtils.h>
+
+using namespace apache::thrift::transport;
+using apache::thrift::util::readVarint;
+using apache::thrift::util::writeVarint;
+
+namespace {
+
+// Typical request: a handful of small headers
+void setHeaders(THeader& header, size_t numHeaders) {
+  header.setHeader(THeader::CLIENT_TIMEOUT_HEADER, "1000");
+  header.setHeader(THeader::PRIORITY_HEADER, "2");
+  for (size_t i = 2; i < numHeaders; ++i) {
+    header.setHeader(
+        folly::to<std::string>("header_", i),
+        folly::to<std::string>("value_", i));
+  }
+}
+
+std::unique_ptr<folly::IOBuf> serialize(size_t numHeaders) {
+  THeader header;
+  setHeaders(header, numHeaders);
+  THeader::StringToStringMap persistentHeaders;
+  return header.addHeader(folly::IOBuf::create(0), persistentHeaders);
+}
+
+template <class Consume>
+void parse(size_t iters, size_t numHeaders, Consume consume) {
+  folly::BenchmarkSuspender setup;
+  auto buf = serialize(numHeaders);
+  THeader::StringToStringMap persistentHeaders;
+  setup.dismiss();
+  for (size_t i = 0; i < iters; ++i) {
+    folly::IOBufQueue queue(folly::IOBufQueue::cacheChainLength());
+    queue.append(buf->clone());
+    THeader header;
+    size_t needed;
+    folly::doNotOptimizeAway(
+        header.removeHeader(&queue, needed, persistentHeaders));
+    consume(header);
+  }
+}
+
+// Key-value section of a header: a varint count, then every key and value as
+// a varint length followed by its bytes
+std::unique_ptr<folly::IOBuf> serializeInfoHeaders(size_t numHeaders) {
+  THeader header;
+  setHeaders(header, numHeaders);
+  folly::IOBufQueue queue(folly::IOBufQueue::cacheChainLength());
+  folly::io::QueueAppender appender(&queue, 1024);
+  writeVarint(appender, header.getWriteHeaders().size());
+  for (const auto& entry : header.getWriteHeaders()) {
+    writeVarint(appender, entry.first.size());
+    appender.push(folly::StringPiece(entry.first));
+    writeVarint(appender, entry.second.size());
+    appender.push(folly::StringPiece(entry.second));
+  }
+  return queue.move();
+}
+
+template <class Read>
+void readInfoHeaders(size_t iters, size_t numHeaders, Read read) {
+  folly::BenchmarkSuspender setup;
+  auto buf = serializeInfoHeaders(numHeaders);
+  setup.dismiss();
+  for (size_t i = 0; i < iters; ++i) {
+    folly::io::Cursor c(buf.get());
+    read(c);
+  }
+}
+
+} // namespace
+
+// Before FlatHeaderMap: a string per key and value, and a map node per header
+void readHeadersMap(size_t iters, size_t numHeaders) {
+  readInfoHeaders(iters, numHeaders, [](folly::io::Cursor& c) {
+    THeader::StringToStringMap headers;
+    auto numKVHeaders = readVarint<uint32_t>(c);
+    while (numKVHeaders--) {
+      auto key = c.readFixedString(readVarint<uint32_t>(c));
+      auto value = c.readFixedString(readVarint<uint32_t>(c));
+      headers[key] = value;
+    }
+    folly::doNotOptimizeAway(headers.find(THeader::CLIENT_TIMEOUT_HEADER));
+  });
+}
+
+// Now: the strings are copied back to back into a single buffer
+void readHeadersFlat(size_t iters, size_t numHeaders) {
+  readInfoHeaders(iters, numHeaders, [](folly::io::Cursor& c) {
+    FlatHeaderMap headers;
+    auto numKVHeaders = readVarint<uint32_t>(c);
+    while (numKVHeaders--) {
+      auto keySize = readVarint<uint32_t>(c);
+      auto key = headers.append(keySize, [&](char* d) { c.pull(d, keySize); });
+      auto valueSize = readVarint<uint32_t>(c);
+      auto value =
+          headers.append(valueSize, [&](char* d) { c.pull(d, valueSize); });
+      headers.insertOrAssign(key, value);
+    }
+    folly::doNotOptimizeAway(headers.find(THeader::CLIENT_TIMEOUT_HEADER));
+  });
+}
+
+void addHeader(size_t iters, size_t numHeaders) {
+  for (size_t i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(serialize(numHeaders));
+  }
+}
+
+// What the server does for most requests: look up a few known headers
+void removeHeaderLookup(size_t iters, size_t numHeaders) {
+  parse(iters, numHeaders, [](THeader& header) {
+    folly::doNotOptimizeAway(header.getClientTimeout());
+    folly::doNotOptimizeAway(header.getCallPriority());
+  });
+}
+
+// Handlers that need the whole map pay for building it
+void removeHeaderGetHeaders(size_t iters, size_t numHeaders) {
+  parse(iters, numHeaders, [](THeader& header) {
+    folly::doNotOptimizeAway(header.getHeaders().size());
+  });
+}
+
+BENCHMARK_PARAM(readHeadersMap, 4)
+BENCHMARK_RELATIVE_PARAM(readHeadersFlat, 4)
+BENCHMARK_PARAM(addHeader, 4)
+BENCHMARK_PARAM(removeHeaderLookup, 4)
+BENCHMARK_RELATIVE_PARAM(removeHeaderGetHeaders, 4)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_PARAM(readHeadersMap, 10)
+BENCHMARK_RELATIVE_PARAM(readHeadersFlat, 10)
+BENCHMARK_PARAM(addHeader, 10)
+BENCHMARK_PARAM(removeHeaderLookup, 10)
+BENCHMARK_RELATIVE_PARAM(removeHeaderGetHeaders, 10)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_PARAM(readHeadersMap, 32)
+BENCHMARK_RELATIVE_PARAM(readHeadersFlat, 32)
+BENCHMARK_PARAM(addHeader, 32)
+BENCHMARK_PARAM(removeHeaderLookup, 32)
+BENCHMARK_RELATIVE_PARAM(removeHeaderGetHeaders, 32)
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -17,10 +17,13 @@
 #include <thrift/lib/cpp/transport/THeader.h>
 #include <thrift/lib/cpp/util/THttpParser.h>
 
+#include <folly/Conv.h>
 #include <folly/Random.h>
 #include <folly/io/IOBuf.h>
 #include <folly/io/IOBufQueue.h>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include <folly/portability/GTest.h>
 
@@ -147,6 +150,66 @@ TEST(THeaderTest, defaultTimeoutAndPriority) {
   EXPECT_EQ(concurrency::PRIORITY::N_PRIORITIES, header.getCallPriority());
 }
 
+TEST(THeaderTest, readHeadersRoundTrip) {
+  THeader writer;
+  writer.setHeader("foo", "bar");
+  writer.setHeader(THeader::CLIENT_TIMEOUT_HEADER, "10");
+  THeader::StringToStringMap persistentWriteHeaders{{"foo", "persistent"},
+                                                    {"p", "1"}};
+  auto buf = writer.addHeader(IOBuf::create(0), persistentWriteHeaders);
+
+  THeader reader;
+  THeader::StringToStringMap persistentReadHeaders;
+  IOBufQueue queue(IOBufQueue::cacheChainLength());
+  queue.append(std::move(buf));
+  size_t needed;
+  reader.removeHeader(&queue, needed, persistentReadHeaders);
+
+  // Per-message headers take precedence over the persistent ones
+  EXPECT_EQ("bar", reader.getReadHeader("foo").value_or("none"));
+  EXPECT_EQ("1", reader.getReadHeader("p").value_or("none"));
+  EXPECT_FALSE(reader.getReadHeader("missing").hasValue());
+  EXPECT_EQ(std::chrono::milliseconds(10), reader.getClientTimeout());
+  EXPECT_FALSE(reader.readHeadersEmpty());
+
+  THeader::StringToStringMap expected{
+      {"foo", "bar"}, {THeader::CLIENT_TIMEOUT_HEADER, "10"}, {"p", "1"}};
+  EXPECT_EQ(expected, reader.getHeaders());
+  EXPECT_EQ("bar", reader.getReadHeader("foo").value_or("none"));
+
+  reader.eraseReadHeader("p");
+  EXPECT_FALSE(reader.getReadHeader("p").hasValue());
+  EXPECT_EQ(2, reader.getHeaders().size());
+  EXPECT_EQ(2, reader.releaseHeaders().size());
+  EXPECT_TRUE(reader.getHeaders().empty());
+  EXPECT_TRUE(reader.readHeadersEmpty());
+  EXPECT_FALSE(reader.getReadHeader("foo").hasValue());
+}
+
+TEST(THeaderTest, concurrentGetHeaders) {
+  THeader writer;
+  for (int i = 0; i < 16; ++i) {
+    writer.setHeader(folly::to<std::string>("key", i), "value");
+  }
+  THeader::StringToStringMap persistentHeaders;
+  auto buf = writer.addHeader(IOBuf::create(0), persistentHeaders);
+
+  THeader reader;
+  IOBufQueue queue(IOBufQueue::cacheChainLength());
+  queue.append(std::move(buf));
+  size_t needed;
+  reader.removeHeader(&queue, needed, persistentHeaders);
+
+  // The map is built lazily by the first caller, the others must wait for it
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&] { EXPECT_EQ(16, reader.getHeaders().size()); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 void testAsciiHeaderData(const std::string& data, const std::string& expected) {
   auto buf = folly::IOBuf::copyBuffer(data);
   std::map<std::string, std::string> persistentHeaders;
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrift/lib/cpp/util/LogLinearHistogram.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <folly/lang/Bits.h>
+
+namespace apache {
+namespace thrift {
+namespace util {
+
+constexpr size_t LogLinearHistogram::kSubBucketBits;
+constexpr size_t LogLinearHistogram::kSubBuckets;
+constexpr size_t LogLinearHistogram::kMaxValueBits;
+constexpr uint64_t LogLinearHistogram::kMaxValue;
+constexpr size_t LogLinearHistogram::kNumBuckets;
+
+size_t LogLinearHistogram::bucketIndex(uint64_t value) {
+  if (value < kSubBuckets) {
+    return value;
+  }
+  value = std::min(value, kMaxValue);
+  // Values in [2^msb, 2^(msb+1)) are split in kSubBuckets buckets of width
+  // 2^shift.
+  const size_t msb = folly::findLastSet(value) - 1;
+  const size_t shift = msb - kSubBucketBits;
+  return (shift + 1) * kSubBuckets + ((value >> shift) - kSubBuckets);
+}
+
+uint64_t LogLinearHistogram::bucketLowerBound(size_t index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  const size_t shift = index / kSubBuckets - 1;
+  return (kSubBuckets + index % kSubBuckets) << shift;
+}
+
+uint64_t LogLinearHistogram::bucketUpperBound(size_t index) {
+  if (index + 1 >= kNumBuckets) {
+    return kMaxValue;
+  }
+  return bucketLowerBound(index + 1) - 1;
+}
+
+void LogLinearHistogram::Recorder::addTo(LogLinearHistogram& histogram) const {
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    histogram.buckets_[i] += buckets_[i].load(std::memory_order_relaxed);
+  }
+  histogram.count_ += count_.load(std::memory_order_relaxed);
+  histogram.sum_ += sum_.load(std::memory_order_relaxed);
+}
+
+void LogLinearHistogram::add(uint64_t value, uint64_t count) {
+  buckets_[bucketIndex(value)] += count;
+  count_ += count;
+  sum_ += value * count;
+}
+
+void LogLinearHistogram::merge(const LogLinearHistogram& other) {
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+  sum_ += other.sum_;
+}
+
+uint64_t LogLinearHistogram::percentile(double pct) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  const auto target = std::max<uint64_t>(
+      1,
+      static_cast<uint64_t>(
+          std::ceil(std::max(0.0, std::min(100.0, pct)) / 100.0 * count_)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    seen += buckets_[i];
+    if (seen >= target) {
+      return bucketUpperBound(i);
+    }
+  }
+  return kMaxValue;
+}
+
+} // namespace util
+} // namespace thrift
+} // namespace apache
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace apache {
+namespace thrift {
+namespace util {
+
+/**
+ * Histogram of non-negative integers with log-linear buckets (HDR style):
+ * every power of two is split into kSubBuckets buckets of equal width, which
+ * bounds the relative error of any percentile to 1 / kSubBuckets whatever
+ * the magnitude of the values. Values above kMaxValue fall into the last
+ * bucket.
+ */
+class LogLinearHistogram {
+ public:
+  static constexpr size_t kSubBucketBits = 3;
+  static constexpr size_t kSubBuckets = size_t(1) << kSubBucketBits;
+  static constexpr size_t kMaxValueBits = 40;
+  static constexpr uint64_t kMaxValue = (uint64_t(1) << kMaxValueBits) - 1;
+  static constexpr size_t kNumBuckets =
+      (kMaxValueBits - kSubBucketBits + 1) * kSubBuckets;
+
+  static size_t bucketIndex(uint64_t value);
+  // Smallest value falling into the bucket
+  static uint64_t bucketLowerBound(size_t index);
+  // Largest value falling into the bucket
+  static uint64_t bucketUpperBound(size_t index);
+
+  /**
+   * Lock-free histogram written by a single thread and read concurrently by
+   * others. Updates are plain relaxed loads and stores, they don't need any
+   * read-modify-write operation since there is only one writer.
+   */
+  class Recorder {
+   public:
+    void record(uint64_t value) {
+      increment(buckets_[bucketIndex(value)], 1);
+      increment(count_, 1);
+      increment(sum_, value);
+    }
+
+    void addTo(LogLinearHistogram& histogram) const;
+
+   private:
+    static void increment(std::atomic<uint64_t>& counter, uint64_t value) {
+      counter.store(
+          counter.load(std::memory_order_relaxed) + value,
+          std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, kNumBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+  };
+
+  void add(uint64_t value, uint64_t count = 1);
+  void merge(const LogLinearHistogram& other);
+
+  uint64_t count() const {
+    return count_;
+  }
+
+  uint64_t sum() const {
+    return sum_;
+  }
+
+  double mean() const {
+    return count_ == 0 ? 0.0 : static_cast<double>(sum_) / count_;
+  }
+
+  uint64_t bucketCount(size_t index) const {
+    return buckets_[index];
+  }
+
+  /**
+   * Upper bound of the bucket holding the given percentile (in [0, 100]),
+   * 0 if the histogram is empty.
+   */
+  uint64_t percentile(double pct) const;
+
+ private:
+  std::array<uint64_t, kNumBuckets> buckets_{};
+  uint64_t count_{0};
+  uint64_t sum_{0};
+};
+
+} // namespace util
+} // namespace thrift
+} // namespace apache
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrift/lib/cpp/util/LogLinearHistogram.h>
+
+#include <limits>
+
+#include <gtest/gtest.h>
+
+using apache::thrift::util::LogLinearHistogram;
+
+TEST(LogLinearHistogram, buckets) {
+  for (size_t i = 0; i < LogLinearHistogram::kNumBuckets; ++i) {
+    auto lower = LogLinearHistogram::bucketLowerBound(i);
+    auto upper = LogLinearHistogram::bucketUpperBound(i);
+    EXPECT_LE(lower, upper);
+    EXPECT_EQ(i, LogLinearHistogram::bucketIndex(lower));
+    EXPECT_EQ(i, LogLinearHistogram::bucketIndex(upper));
+    if (i > 0) {
+      EXPECT_EQ(LogLinearHistogram::bucketUpperBound(i - 1) + 1, lower);
+    }
+  }
+  EXPECT_EQ(
+      LogLinearHistogram::kNumBuckets - 1,
+      LogLinearHistogram::bucketIndex(std::numeric_limits<uint64_t>::max()));
+}
+
+TEST(LogLinearHistogram, percentiles) {
+  LogLinearHistogram histogram;
+  EXPECT_EQ(0, histogram.percentile(50));
+  for (uint64_t i = 1; i <= 1000; ++i) {
+    histogram.add(i);
+  }
+  EXPECT_EQ(1000, histogram.count());
+  EXPECT_EQ(500500, histogram.sum());
+  EXPECT_DOUBLE_EQ(500.5, histogram.mean());
+  // Percentiles are accurate to 1 / kSubBuckets
+  for (double pct : {1.0, 50.0, 90.0, 99.0, 100.0}) {
+    const double exact = pct * 10;
+    const double value = histogram.percentile(pct);
+    EXPECT_GE(value, exact);
+    EXPECT_LE(value, exact * (1 + 1.0 / LogLinearHistogram::kSubBuckets));
+  }
+}
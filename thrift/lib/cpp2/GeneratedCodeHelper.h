@@ -31,7 +31,9 @@
 #include <thrift/lib/cpp2/async/AsyncProcessor.h>
 #include <thrift/lib/cpp2/async/ClientBufferedStream.h>
 #include <thrift/lib/cpp2/async/ClientSinkBridge.h>
+#include <thrift/lib/cpp2/async/CoroDispatch.h>
 #include <thrift/lib/cpp2/async/RequestChannel.h>
+#include <thrift/lib/cpp2/async/RequestDeadline.h>
 #include <thrift/lib/cpp2/async/Sink.h>
 #include <thrift/lib/cpp2/async/Stream.h>
 #include <thrift/lib/cpp2/async/StreamCallbacks.h>
@@ -905,6 +907,21 @@ void process_pmap(
     return;
   }
 
+  if (UNLIKELY(!req->isOneway() && ctx->isDeadlineExceeded())) {
+    GeneratedAsyncProcessor::processDeadlineExceeded(std::move(req), eb);
+    return;
+  }
+  if (UNLIKELY(ctx->isDeadlinePropagated())) {
+    // Make the deadline visible to the handler (and to the thread manager
+    // task, which captures the RequestContext), so that the calls it makes
+    // forward it downstream. Only done when the caller propagated it, to
+    // keep the context copy off the path of plain requests with a timeout.
+    folly::ShallowCopyRequestContextScopeGuard guard(
+        RequestDeadline::getRequestToken(),
+        std::make_unique<RequestDeadline>(*ctx->getDeadline()));
+    (proc->*(pfn->second))(std::move(req), std::move(buf), ctx, eb, tm);
+    return;
+  }
   (proc->*(pfn->second))(std::move(req), std::move(buf), ctx, eb, tm);
 }
 
@@ -1176,7 +1193,9 @@ apache::thrift::detail::SinkConsumerImpl toSinkConsumerImpl(
       std::move(consumer),
       sinkConsumer.bufferSize,
       sinkConsumer.sinkOptions.chunkTimeout,
-      std::move(executor)};
+      std::move(executor),
+      sinkConsumer.sinkOptions.batchBytes,
+      sinkConsumer.sinkOptions.bufferBytes};
 }
 #endif
 
@@ -1262,6 +1281,12 @@ inline void async_tm_prep(ServerInterface* si, CallbackBase* callback) {
   si->setConnectionContext(callback->getConnectionContext());
 }
 
+inline void async_tm_prep(ServerInterface* si, const RequestParams& params) {
+  si->setEventBase(params.getEventBase());
+  si->setThreadManager(params.getThreadManager());
+  si->setConnectionContext(params.getRequestContext());
+}
+
 template <class F>
 void async_tm_oneway(ServerInterface* si, CallbackBasePtr callback, F&& f) {
   async_tm_prep(si, callback.get());
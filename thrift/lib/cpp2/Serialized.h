@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include <folly/Optional.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBuf.h>
+#include <folly/io/IOBufQueue.h>
+
+#include <thrift/lib/cpp/protocol/TType.h>
+#include <thrift/lib/cpp2/protocol/BinaryProtocol.h>
+#include <thrift/lib/cpp2/protocol/CompactProtocol.h>
+#include <thrift/lib/cpp2/protocol/Cpp2Ops.h>
+
+namespace apache {
+namespace thrift {
+
+/**
+ * A Thrift struct along with its serialized bytes, so that a value sent many
+ * times, e.g. the same snapshot returned to every client, is serialized once
+ * per protocol rather than once per response.
+ *
+ * Use it as the cpp.type of a typedef of the struct:
+ *
+ *   cpp_include "thrift/lib/cpp2/Serialized.h"
+ *
+ *   typedef Snapshot (cpp.type = "apache::thrift::Serialized<Snapshot>")
+ *     SerializedSnapshot
+ *
+ * Binary and Compact writers chain the cached bytes into their output
+ * without copying them; other protocols write the value. When read with
+ * Binary or Compact, the bytes are kept as they are and the value is only
+ * parsed on first access, which throws if they are malformed.
+ *
+ * Copies share the value and the cached bytes, which may be computed
+ * concurrently from several threads. mutable_value() gives the copy its own
+ * value and drops its cached bytes; changes made through the returned
+ * reference must be done before the copy is serialized again.
+ */
+template <typename T>
+class Serialized {
+ public:
+  using value_type = T;
+
+  Serialized() : Serialized(T()) {}
+
+  /* implicit */ Serialized(T value)
+      : state_(std::make_shared<State>(std::move(value))) {}
+
+  const T& value() const {
+    auto& state = *state_;
+    if (!state.hasValue.load(std::memory_order_acquire)) {
+      std::lock_guard<std::mutex> guard(state.mutex);
+      if (!state.hasValue.load(std::memory_order_relaxed)) {
+        T value;
+        if (state.slots[kBinarySlot].ready.load(std::memory_order_relaxed)) {
+          parse<BinaryProtocolReader>(*state.slots[kBinarySlot].buf, value);
+        } else {
+          parse<CompactProtocolReader>(*state.slots[kCompactSlot].buf, value);
+        }
+        state.value = std::move(value);
+        state.hasValue.store(true, std::memory_order_release);
+      }
+    }
+    return *state.value;
+  }
+
+  T& mutable_value() {
+    if (state_.use_count() != 1) {
+      state_ = std::make_shared<State>(value());
+    } else {
+      value();
+      for (auto& slot : state_->slots) {
+        slot.ready.store(false, std::memory_order_relaxed);
+        slot.buf.reset();
+      }
+    }
+    return *state_->value;
+  }
+
+  /**
+   * The value serialized with ProtocolWriter, either Binary or Compact,
+   * computed on first call.
+   */
+  template <typename ProtocolWriter>
+  const std::unique_ptr<folly::IOBuf>& serialized() const {
+    constexpr int kSlot = slotOf<ProtocolWriter>();
+    static_assert(kSlot >= 0, "Only Binary and Compact bytes are cached");
+    auto& slot = state_->slots[kSlot];
+    if (!slot.ready.load(std::memory_order_acquire)) {
+      // Outside of the lock, which value() may take.
+      auto& value = this->value();
+      std::lock_guard<std::mutex> guard(state_->mutex);
+      if (!slot.ready.load(std::memory_order_relaxed)) {
+        slot.buf = serialize<ProtocolWriter>(value);
+        slot.ready.store(true, std::memory_order_release);
+      }
+    }
+    return slot.buf;
+  }
+
+  template <class Protocol_>
+  void read(Protocol_* iprot) {
+    readImpl(iprot, std::integral_constant<bool, isCached<Protocol_>()>{});
+  }
+  template <class Protocol_>
+  uint32_t serializedSize(Protocol_ const* prot_) const {
+    return serializedSizeImpl(
+        prot_, std::integral_constant<bool, isCached<Protocol_>()>{});
+  }
+  template <class Protocol_>
+  uint32_t serializedSizeZC(Protocol_ const* prot_) const {
+    return serializedSizeZCImpl(
+        prot_, std::integral_constant<bool, isCached<Protocol_>()>{});
+  }
+  template <class Protocol_>
+  uint32_t write(Protocol_* prot_) const {
+    return writeImpl(
+        prot_, std::integral_constant<bool, isCached<Protocol_>()>{});
+  }
+
+  friend bool operator==(const Serialized& lhs, const Serialized& rhs) {
+    return lhs.state_ == rhs.state_ || lhs.value() == rhs.value();
+  }
+  friend bool operator!=(const Serialized& lhs, const Serialized& rhs) {
+    return !(lhs == rhs);
+  }
+  friend bool operator<(const Serialized& lhs, const Serialized& rhs) {
+    return lhs.value() < rhs.value();
+  }
+
+ private:
+  static constexpr int kBinarySlot = 0;
+  static constexpr int kCompactSlot = 1;
+
+  struct Slot {
+    std::atomic<bool> ready{false};
+    std::unique_ptr<folly::IOBuf> buf;
+  };
+
+  struct State {
+    State() = default;
+    explicit State(T v) : value(std::move(v)), hasValue(true) {}
+
+    // Serializes the lazy initialization of value and slots
+    std::mutex mutex;
+    folly::Optional<T> value;
+    std::atomic<bool> hasValue{false};
+    std::array<Slot, 2> slots;
+  };
+
+  // Exact protocol types: CompactV1 for instance shares Compact's
+  // protocolType() but not its encoding.
+  template <typename Protocol>
+  static constexpr int slotOf() {
+    using P = std::remove_const_t<Protocol>;
+    return std::is_same<P, BinaryProtocolWriter>::value ||
+            std::is_same<P, BinaryProtocolReader>::value
+        ? kBinarySlot
+        : std::is_same<P, CompactProtocolWriter>::value ||
+                std::is_same<P, CompactProtocolReader>::value
+            ? kCompactSlot
+            : -1;
+  }
+  template <typename Protocol>
+  static constexpr bool isCached() {
+    return slotOf<Protocol>() >= 0;
+  }
+
+  template <typename ProtocolReader>
+  static void parse(const folly::IOBuf& buf, T& value) {
+    ProtocolReader reader;
+    reader.setInput(&buf);
+    Cpp2Ops<T>::read(&reader, &value);
+  }
+
+  template <typename ProtocolWriter>
+  static std::unique_ptr<folly::IOBuf> serialize(const T& value) {
+    ProtocolWriter writer;
+    folly::IOBufQueue queue(folly::IOBufQueue::cacheChainLength());
+    writer.setOutput(&queue, Cpp2Ops<T>::serializedSizeZC(&writer, &value));
+    Cpp2Ops<T>::write(&writer, &value);
+    return queue.move();
+  }
+
+  template <class Protocol_>
+  void readImpl(Protocol_* iprot, std::true_type) {
+    // Keep the bytes of the struct, sharing the input when it is managed.
+    folly::io::Cursor begin = iprot->getCursor();
+    auto start = iprot->getCursorPosition();
+    iprot->skip(protocol::T_STRUCT);
+    auto state = std::make_shared<State>();
+    auto& slot = state->slots[slotOf<Protocol_>()];
+    begin.clone(slot.buf, iprot->getCursorPosition() - start);
+    slot.buf->makeManaged();
+    slot.ready.store(true, std::memory_order_relaxed);
+    state_ = std::move(state);
+  }
+  template <class Protocol_>
+  void readImpl(Protocol_* iprot, std::false_type) {
+    T value;
+    Cpp2Ops<T>::read(iprot, &value);
+    state_ = std::make_shared<State>(std::move(value));
+  }
+
+  template <class Protocol_>
+  uint32_t serializedSizeImpl(Protocol_ const*, std::true_type) const {
+    return serialized<Protocol_>()->computeChainDataLength();
+  }
+  template <class Protocol_>
+  uint32_t serializedSizeImpl(Protocol_ const* prot_, std::false_type) const {
+    return Cpp2Ops<T>::serializedSize(prot_, &value());
+  }
+
+  template <class Protocol_>
+  uint32_t serializedSizeZCImpl(Protocol_ const* prot_, std::true_type) const {
+    return prot_->serializedSizeSerializedData(serialized<Protocol_>());
+  }
+  template <class Protocol_>
+  uint32_t serializedSizeZCImpl(Protocol_ const* prot_, std::false_type)
+      const {
+    return Cpp2Ops<T>::serializedSizeZC(prot_, &value());
+  }
+
+  template <class Protocol_>
+  uint32_t writeImpl(Protocol_* prot_, std::true_type) const {
+    return prot_->writeSerializedData(serialized<Protocol_>());
+  }
+  template <class Protocol_>
+  uint32_t writeImpl(Protocol_* prot_, std::false_type) const {
+    return Cpp2Ops<T>::write(prot_, &value());
+  }
+
+  std::shared_ptr<State> state_;
+};
+
+template <class T>
+class Cpp2Ops<Serialized<T>> {
+ public:
+  typedef Serialized<T> Type;
+  static constexpr protocol::TType thriftType() {
+    return protocol::T_STRUCT;
+  }
+  static void clear(Type* value) {
+    *value = Type();
+  }
+  template <class Protocol>
+  static uint32_t write(Protocol* prot, const Type* value) {
+    return value->write(prot);
+  }
+  template <class Protocol>
+  static void read(Protocol* prot, Type* value) {
+    value->read(prot);
+  }
+  template <class Protocol>
+  static uint32_t serializedSize(Protocol* prot, const Type* value) {
+    return value->serializedSize(prot);
+  }
+  template <class Protocol>
+  static uint32_t serializedSizeZC(Protocol* prot, const Type* value) {
+    return value->serializedSizeZC(prot);
+  }
+};
+
+} // namespace thrift
+} // namespace apache
@@ -22,6 +22,21 @@ namespace thrift {
 constexpr std::chrono::seconds ServerInterface::BlockingThreadManager::kTimeout;
 thread_local RequestParams ServerInterface::requestParams_;
 
+void GeneratedAsyncProcessor::processDeadlineExceeded(
+    std::unique_ptr<ResponseChannelRequest> req,
+    folly::EventBase* eb) {
+  req->onDeadlineExceeded();
+  eb->runInEventBaseThread([req = std::move(req)]() mutable {
+    if (!req->isOneway() && req->isActive()) {
+      req->sendErrorWrapped(
+          folly::make_exception_wrapper<TApplicationException>(
+              TApplicationException::TApplicationExceptionType::TIMEOUT,
+              "Request deadline exceeded"),
+          kTaskExpiredErrorCode);
+    }
+  });
+}
+
 void HandlerCallbackBase::sendReply(
     ResponseAndStream<folly::IOBufQueue, folly::IOBufQueue>&&
         responseAndStream) {
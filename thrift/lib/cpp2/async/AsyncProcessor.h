@@ -109,6 +109,7 @@ class EventTask : public virtual apache::thrift::concurrency::Runnable {
 };
 
 class PriorityEventTask : public apache::thrift::concurrency::PriorityRunnable,
+                          public apache::thrift::concurrency::TenantRunnable,
                           public EventTask {
  public:
   PriorityEventTask(
@@ -117,18 +118,30 @@ class PriorityEventTask : public apache::thrift::concurrency::PriorityRunnable,
           std::unique_ptr<apache::thrift::ResponseChannelRequest>)>&& taskFunc,
       std::unique_ptr<apache::thrift::ResponseChannelRequest> req,
       folly::EventBase* base,
-      bool oneway)
+      bool oneway,
+      apache::thrift::Cpp2RequestContext* ctx = nullptr)
       : EventTask(std::move(taskFunc), std::move(req), base, oneway),
-        priority_(priority) {}
+        priority_(priority),
+        ctx_(ctx) {}
 
   apache::thrift::concurrency::PriorityThreadManager::PRIORITY getPriority()
       const override {
     return priority_;
   }
+
+  // The tenant is identified by a request header, which also covers the
+  // otherMetadata of rocket and HTTP/2 requests.
+  folly::StringPiece getTenant(folly::StringPiece key) const override {
+    if (!ctx_ || !ctx_->getHeader()) {
+      return folly::StringPiece();
+    }
+    return ctx_->getHeader()->getReadHeader(key).value_or(folly::StringPiece());
+  }
   using EventTask::run;
 
  private:
   apache::thrift::concurrency::PriorityThreadManager::PRIORITY priority_;
+  apache::thrift::Cpp2RequestContext* ctx_;
 };
 
 class AsyncProcessor : public TProcessorBase {
@@ -168,6 +181,15 @@ class GeneratedAsyncProcessor : public AsyncProcessor {
   template <typename ProcessFunc>
   using ProcessMap = folly::F14ValueMap<std::string, ProcessFunc>;
 
+  /**
+   * Drop a request whose deadline passed before its processing started: the
+   * client already gave up on it. The client is sent a TIMEOUT error (unless
+   * the request is oneway) from the event base thread.
+   */
+  static void processDeadlineExceeded(
+      std::unique_ptr<apache::thrift::ResponseChannelRequest> req,
+      folly::EventBase* eb);
+
  protected:
   template <typename ProtocolIn, typename Args>
   static void deserializeRequest(
@@ -269,13 +291,18 @@ class GeneratedAsyncProcessor : public AsyncProcessor {
                       [rq = std::move(rq)]() mutable { rq.reset(); });
                   return;
                 }
+                if (ctx->isDeadlineExceeded()) {
+                  processDeadlineExceeded(std::move(rq), eb);
+                  return;
+                }
               }
               (childClass->*processFunc)(
                   std::move(rq), std::move(buf), ctx, eb, tm);
             },
             std::move(req),
             eb,
-            kind == apache::thrift::RpcKind::SINGLE_REQUEST_NO_RESPONSE),
+            kind == apache::thrift::RpcKind::SINGLE_REQUEST_NO_RESPONSE,
+            ctx),
         0, // timeout
         0, // expiration
         true, // cancellable
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include <boost/variant.hpp>
 
 #include <folly/Portability.h>
@@ -24,6 +26,7 @@
 #ifdef FOLLY_HAS_COROUTINES
 #include <folly/experimental/coro/AsyncGenerator.h>
 #include <folly/experimental/coro/Baton.h>
+#include <folly/experimental/coro/CurrentExecutor.h>
 #include <folly/experimental/coro/Task.h>
 #endif
 
@@ -90,6 +93,35 @@ class ClientSinkBridge : public TwoWayBridge<
     };
 
     bool sinkComplete = false;
+    SinkBatch batch;
+    auto flush = [&] {
+      if (!batch.empty()) {
+        clientPush(folly::Try<StreamPayload>(batch.finish()));
+        credit--;
+      }
+    };
+
+    using NextResult = typename folly::coro::AsyncGenerator<
+        folly::Try<StreamPayload>&&>::NextResult;
+    // A partial batch isn't held while the generator waits for its next item
+    auto next = [&]() -> folly::coro::Task<NextResult> {
+      if (batch.empty()) {
+        co_return co_await generator.next();
+      }
+      auto executor = co_await folly::coro::co_current_executor;
+      auto item = folly::coro::co_invoke(
+                      [&]() -> folly::coro::Task<NextResult> {
+                        co_return co_await generator.next();
+                      })
+                      .scheduleOn(executor)
+                      .start();
+      // Runs after the generator if it has its item without waiting
+      co_await folly::coro::co_reschedule_on_current_executor;
+      if (!item.isReady()) {
+        flush();
+      }
+      co_return co_await std::move(item);
+    };
 
     while (true) {
       co_await waitEvent();
@@ -101,11 +133,26 @@ class ClientSinkBridge : public TwoWayBridge<
       }
 
       while (credit > 0 && !sinkComplete) {
-        auto item = co_await generator.next();
+        auto item = co_await next();
+
+        if (item.has_value() && (*item).hasValue() && batchBytes_ > 0) {
+          // Throughput mode: items are coalesced into payloads of up to
+          // batchBytes_, a payload taking one credit. A batch is sent once
+          // the next item doesn't fit, the generator has to wait for it or
+          // the generator is done.
+          auto size = (*item)->payload->computeChainDataLength();
+          if (batch.bytes() + size > batchBytes_) {
+            flush();
+          }
+          batch.add(std::move(*item).value());
+          continue;
+        }
 
+        flush();
         if (item.has_value()) {
           if ((*item).hasValue()) {
             clientPush(std::move(*item));
+            credit--;
           } else {
             clientPush(std::move(*item));
             // AsyncGenerator who serialized and yield the exception also in
@@ -117,7 +164,6 @@ class ClientSinkBridge : public TwoWayBridge<
           clientPush(SinkComplete{});
           sinkComplete = true;
         }
-        credit--;
       }
     }
     co_return std::move(finalResponse);
@@ -135,6 +181,9 @@ class ClientSinkBridge : public TwoWayBridge<
       SinkServerCallback* serverCallback) override {
     serverCallback_ = serverCallback;
     evb_ = folly::getKeepAliveToken(evb);
+    if (auto batchBytes = firstPayload.metadata.sinkBatchBytes_ref()) {
+      batchBytes_ = std::max(*batchBytes, 0);
+    }
     bool scheduledWait = serverWait(this);
     DCHECK(scheduledWait);
     firstResponse_.emplace(std::move(firstPayload));
@@ -217,6 +266,8 @@ class ClientSinkBridge : public TwoWayBridge<
 
   SinkServerCallback* serverCallback_{nullptr};
   folly::Executor::KeepAlive<folly::EventBase> evb_;
+  // set by servers accepting coalesced payloads
+  size_t batchBytes_{0};
 };
 #else
 class ClientSinkBridge {
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrift/lib/cpp2/async/CoroDispatch.h>
+
+#include <array>
+#include <new>
+#include <utility>
+
+#include <folly/Optional.h>
+
+#include <thrift/lib/cpp/transport/THeader.h>
+#include <thrift/lib/cpp2/util/Checksum.h>
+
+namespace apache {
+namespace thrift {
+namespace detail {
+namespace ap {
+
+namespace {
+constexpr size_t kNumSizeClasses = CoroDispatchFramePool::kMaxFrameBytes /
+    CoroDispatchFramePool::kSizeClassBytes;
+
+struct FreeFrame {
+  FreeFrame* next;
+};
+
+struct FreeFrames {
+  std::array<FreeFrame*, kNumSizeClasses> heads{};
+  std::array<size_t, kNumSizeClasses> counts{};
+
+  ~FreeFrames() {
+    for (auto head : heads) {
+      while (head) {
+        ::operator delete(std::exchange(head, head->next));
+      }
+    }
+  }
+};
+
+thread_local FreeFrames freeFrames;
+
+size_t sizeClass(size_t size) {
+  return (size - 1) / CoroDispatchFramePool::kSizeClassBytes;
+}
+} // namespace
+
+void* CoroDispatchFramePool::allocate(size_t size) {
+  if (size == 0 || size > kMaxFrameBytes) {
+    return ::operator new(size);
+  }
+  auto cls = sizeClass(size);
+  if (auto frame = freeFrames.heads[cls]) {
+    freeFrames.heads[cls] = frame->next;
+    --freeFrames.counts[cls];
+    return frame;
+  }
+  return ::operator new((cls + 1) * kSizeClassBytes);
+}
+
+void CoroDispatchFramePool::deallocate(void* frame, size_t size) noexcept {
+  if (size == 0 || size > kMaxFrameBytes) {
+    ::operator delete(frame);
+    return;
+  }
+  auto cls = sizeClass(size);
+  if (freeFrames.counts[cls] == kMaxFramesPerClass) {
+    ::operator delete(frame);
+    return;
+  }
+  freeFrames.heads[cls] = new (frame) FreeFrame{freeFrames.heads[cls]};
+  ++freeFrames.counts[cls];
+}
+
+void release_request(
+    std::unique_ptr<ResponseChannelRequest> req,
+    folly::EventBase* eb) {
+  if (!req) {
+    return;
+  }
+  if (eb->inRunningEventBaseThread()) {
+    req.reset();
+    return;
+  }
+  eb->runInEventBaseThread([req = std::move(req)]() mutable { req.reset(); });
+}
+
+void send_coro_reply(
+    std::unique_ptr<ResponseChannelRequest> req,
+    Cpp2RequestContext* reqCtx,
+    folly::EventBase* eb,
+    folly::IOBufQueue queue) {
+  folly::Optional<uint32_t> crc32c;
+  if (req->isReplyChecksumNeeded() && !queue.empty()) {
+    auto buf = queue.move();
+    crc32c = checksum::crc32c(*buf);
+    queue.append(std::move(buf));
+  }
+  queue.append(transport::THeader::transform(
+      queue.move(),
+      reqCtx->getHeader()->getWriteTransforms(),
+      reqCtx->getHeader()->getMinCompressBytes()));
+  if (eb->isInEventBaseThread()) {
+    req->sendReply(queue.move(), nullptr, crc32c);
+  } else {
+    eb->runInEventBaseThread(
+        [req = std::move(req), queue = std::move(queue), crc32c]() mutable {
+          req->sendReply(queue.move(), nullptr, crc32c);
+        });
+  }
+}
+
+} // namespace ap
+} // namespace detail
+} // namespace thrift
+} // namespace apache
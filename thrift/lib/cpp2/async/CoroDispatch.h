@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <folly/Portability.h>
+
+#include <folly/ExceptionWrapper.h>
+#include <folly/io/IOBufQueue.h>
+#include <folly/io/async/EventBase.h>
+#include <glog/logging.h>
+#if FOLLY_HAS_COROUTINES
+#include <experimental/coroutine>
+#include <folly/experimental/coro/Task.h>
+#include <folly/experimental/coro/ViaIfAsync.h>
+#endif // FOLLY_HAS_COROUTINES
+
+#include <thrift/lib/cpp/ContextStack.h>
+#include <thrift/lib/cpp/concurrency/ThreadManager.h>
+#include <thrift/lib/cpp2/async/ResponseChannel.h>
+#include <thrift/lib/cpp2/server/Cpp2ConnContext.h>
+
+namespace apache {
+namespace thrift {
+namespace detail {
+namespace ap {
+
+/**
+ * Per-thread free lists for the frames of the coroutines that process
+ * requests, by size class. A frame goes back to the list of the thread that
+ * finished the request, which is usually the one that started it. The lists
+ * are bounded, so threads that mostly finish requests don't hoard frames.
+ */
+class CoroDispatchFramePool {
+ public:
+  static constexpr size_t kSizeClassBytes = 64;
+  static constexpr size_t kMaxFrameBytes = 1024;
+  static constexpr size_t kMaxFramesPerClass = 64;
+
+  static void* allocate(size_t size);
+  static void deallocate(void* frame, size_t size) noexcept;
+};
+
+// Frees the request in the event base thread, where it has to be destroyed.
+void release_request(
+    std::unique_ptr<ResponseChannelRequest> req,
+    folly::EventBase* eb);
+
+// Checksums and transforms the reply like HandlerCallback does, then sends it
+// from the event base thread.
+void send_coro_reply(
+    std::unique_ptr<ResponseChannelRequest> req,
+    Cpp2RequestContext* reqCtx,
+    folly::EventBase* eb,
+    folly::IOBufQueue queue);
+
+#if FOLLY_HAS_COROUTINES
+
+/**
+ * Coroutine processing a request. It runs in the calling thread until it
+ * first suspends, and frees its frame, taken from CoroDispatchFramePool, when
+ * it's done. Nothing waits for it.
+ */
+class DetachedDispatch {
+ public:
+  class promise_type {
+   public:
+    static void* operator new(size_t size) {
+      return CoroDispatchFramePool::allocate(size);
+    }
+    static void operator delete(void* frame, size_t size) {
+      CoroDispatchFramePool::deallocate(frame, size);
+    }
+
+    DetachedDispatch get_return_object() noexcept {
+      return {};
+    }
+    std::experimental::suspend_never initial_suspend() noexcept {
+      return {};
+    }
+    std::experimental::suspend_never final_suspend() noexcept {
+      return {};
+    }
+    void return_void() noexcept {}
+    [[noreturn]] void unhandled_exception() noexcept {
+      std::terminate();
+    }
+  };
+};
+
+template <typename Task>
+struct coro_task_result;
+template <typename T>
+struct coro_task_result<folly::coro::Task<T>> {
+  using type = T;
+};
+
+template <typename ReturnFn, typename T>
+folly::IOBufQueue serialize_coro_result(
+    ReturnFn returnFn,
+    int32_t protoSeqId,
+    ContextStack* ctx,
+    const T& result) {
+  return returnFn(protoSeqId, ctx, result);
+}
+
+template <typename ReturnFn, typename T>
+folly::IOBufQueue serialize_coro_result(
+    ReturnFn returnFn,
+    int32_t protoSeqId,
+    ContextStack* ctx,
+    const std::unique_ptr<T>& result) {
+  return returnFn(protoSeqId, ctx, *result);
+}
+
+/**
+ * Processes a request with the Task returned by makeTask(), which calls the
+ * co_ method of the handler, in place of HandlerCallback and async_tm_.
+ *
+ * Called from the thread manager thread the request was queued to, the task
+ * starts right away in that thread instead of being queued again, and
+ * resumes on the thread manager when it suspends. Its result is serialized
+ * by returnFn and sent by the last step of the coroutine, without going
+ * through a future or a callback.
+ */
+template <typename MakeTask, typename ReturnFn, typename ThrowWrappedFn>
+DetachedDispatch process_coro(
+    std::unique_ptr<ResponseChannelRequest> req,
+    std::unique_ptr<ContextStack> ctxStack,
+    Cpp2RequestContext* reqCtx,
+    folly::EventBase* eb,
+    concurrency::ThreadManager* tm,
+    MakeTask makeTask,
+    ReturnFn returnFn,
+    ThrowWrappedFn throwWrappedFn) {
+  using T = typename coro_task_result<decltype(makeTask())>::type;
+  if (!req->isActive()) {
+    release_request(std::move(req), eb);
+    co_return;
+  }
+  reqCtx->setStartedProcessing();
+  auto protoSeqId = reqCtx->getProtoSeqId();
+
+  folly::IOBufQueue queue;
+  folly::exception_wrapper ew;
+  try {
+    auto result = folly::coro::co_viaIfAsync(
+        folly::getKeepAliveToken(tm), makeTask());
+    if constexpr (std::is_void<T>::value) {
+      co_await std::move(result);
+      queue = returnFn(protoSeqId, ctxStack.get());
+    } else {
+      auto value = co_await std::move(result);
+      queue =
+          serialize_coro_result(returnFn, protoSeqId, ctxStack.get(), value);
+    }
+  } catch (const std::exception& e) {
+    ew = folly::exception_wrapper(std::current_exception(), e);
+  } catch (...) {
+    ew = folly::exception_wrapper(std::current_exception());
+  }
+
+  if (ew) {
+    if (eb->isInEventBaseThread()) {
+      throwWrappedFn(std::move(req), protoSeqId, ctxStack.get(), ew, reqCtx);
+    } else {
+      eb->runInEventBaseThread([throwWrappedFn,
+                                req = std::move(req),
+                                protoSeqId,
+                                ctxStack = std::move(ctxStack),
+                                ew = std::move(ew),
+                                reqCtx]() mutable {
+        throwWrappedFn(std::move(req), protoSeqId, ctxStack.get(), ew, reqCtx);
+      });
+    }
+    co_return;
+  }
+  ctxStack.reset();
+  send_coro_reply(std::move(req), reqCtx, eb, std::move(queue));
+}
+
+/**
+ * Oneway counterpart of process_coro(): the request and its context stack
+ * are kept until the task completes, and its result is dropped. Errors are
+ * logged, as there is nobody to send them to.
+ */
+template <typename MakeTask>
+DetachedDispatch process_coro_oneway(
+    std::unique_ptr<ResponseChannelRequest> req,
+    std::unique_ptr<ContextStack> ctxStack,
+    Cpp2RequestContext* reqCtx,
+    folly::EventBase* eb,
+    concurrency::ThreadManager* tm,
+    MakeTask makeTask) {
+  reqCtx->setStartedProcessing();
+  folly::exception_wrapper ew;
+  try {
+    co_await folly::coro::co_viaIfAsync(
+        folly::getKeepAliveToken(tm), makeTask());
+  } catch (const std::exception& e) {
+    ew = folly::exception_wrapper(std::current_exception(), e);
+  } catch (...) {
+    ew = folly::exception_wrapper(std::current_exception());
+  }
+  if (ew) {
+    LOG(ERROR) << ew.what();
+    if (ctxStack) {
+      ctxStack->handlerErrorWrapped(ew);
+    }
+  }
+  ctxStack.reset();
+  release_request(std::move(req), eb);
+}
+
+#endif // FOLLY_HAS_COROUTINES
+
+} // namespace ap
+} // namespace detail
+} // namespace thrift
+} // namespace apache
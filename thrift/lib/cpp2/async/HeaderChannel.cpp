@@ -17,6 +17,7 @@
 #include <thrift/lib/cpp2/async/HeaderChannel.h>
 
 #include <thrift/lib/cpp2/async/RequestChannel.h>
+#include <thrift/lib/cpp2/async/RequestDeadline.h>
 
 namespace apache {
 namespace thrift {
@@ -36,11 +37,16 @@ void HeaderChannel::addRpcOptionHeaders(
         folly::to<std::string>(rpcOptions.getPriority()));
   }
 
+  auto deadline = RequestDeadline::current();
   if (!rpcOptions.getClientOnlyTimeouts()) {
-    if (rpcOptions.getTimeout() > std::chrono::milliseconds(0)) {
+    auto timeout = rpcOptions.getTimeout();
+    if (deadline) {
+      timeout = RequestDeadline::forwardedTimeout(*deadline, timeout);
+    }
+    if (timeout > std::chrono::milliseconds(0)) {
       header->setHeader(
           transport::THeader::CLIENT_TIMEOUT_HEADER,
-          folly::to<std::string>(rpcOptions.getTimeout().count()));
+          folly::to<std::string>(timeout.count()));
     }
 
     if (rpcOptions.getQueueTimeout() > std::chrono::milliseconds(0)) {
@@ -49,6 +55,12 @@ void HeaderChannel::addRpcOptionHeaders(
           folly::to<std::string>(rpcOptions.getQueueTimeout().count()));
     }
   }
+
+  if (deadline) {
+    header->setHeader(
+        transport::THeader::DEADLINE_HEADER,
+        folly::to<std::string>(RequestDeadline::toEpochMs(*deadline).count()));
+  }
 }
 } // namespace thrift
 } // namespace apache
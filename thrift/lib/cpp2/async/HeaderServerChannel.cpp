@@ -392,8 +392,7 @@ TServerObserver::SamplingStatus HeaderServerChannel::shouldSample(
   bool isServerSamplingEnabled =
       (sampleRate_ > 0) && ((sample_++ % sampleRate_) == 0);
   bool isClientSamplingEnabled =
-      header->getHeaders().find(kClientLoggingHeader.str()) !=
-      header->getHeaders().end();
+      header->getReadHeader(kClientLoggingHeader).hasValue();
   return SamplingStatus(isServerSamplingEnabled, isClientSamplingEnabled);
 }
 
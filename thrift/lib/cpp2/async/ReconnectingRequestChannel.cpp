@@ -16,10 +16,22 @@
 
 #include <thrift/lib/cpp2/async/ReconnectingRequestChannel.h>
 
+#include <algorithm>
+#include <limits>
+#include <map>
 #include <memory>
+#include <string>
 #include <utility>
 
+#include <folly/Conv.h>
 #include <folly/ExceptionWrapper.h>
+#include <folly/Optional.h>
+#include <folly/io/IOBuf.h>
+#include <folly/io/async/EventBase.h>
+
+#include <thrift/lib/cpp/transport/THeader.h>
+#include <thrift/lib/cpp/transport/TTransportException.h>
+#include <thrift/lib/cpp2/async/ResumableStream.h>
 
 namespace apache {
 namespace thrift {
@@ -52,6 +64,196 @@ class ChannelKeepAlive : public RequestClientCallback {
 };
 } // namespace
 
+// Sits between the stream's client and the connection it's received on, which
+// changes when the stream is resumed. Counts the payloads received and the
+// credits granted, which the server needs to pick the stream up.
+class ReconnectingRequestChannel::ResumableStream final
+    : public StreamClientCallback,
+      public StreamServerCallback {
+ public:
+  ResumableStream(
+      ReconnectingRequestChannel& channel,
+      StreamClientCallback& clientCallback,
+      const RpcOptions& options,
+      std::unique_ptr<folly::IOBuf> buf,
+      transport::THeader& header)
+      : channel_(channel),
+        channelGuard_(&channel),
+        clientCallback_(&clientCallback),
+        options_(options),
+        buf_(std::move(buf)),
+        writeHeaders_(header.getWriteHeaders()),
+        crc32c_(header.getCrc32c()),
+        // the first response takes one
+        credits_(std::max(options.getChunkBufferSize(), 1) - 1) {}
+
+  // StreamClientCallback implementation, called by the transport
+  void onFirstResponse(
+      FirstResponsePayload&& firstResponse,
+      folly::EventBase* evb,
+      StreamServerCallback* serverCallback) override {
+    serverCallback_ = serverCallback;
+    auto token = getToken(firstResponse.metadata);
+    if (!resuming_) {
+      token_ = std::move(token);
+      clientCallback_->onFirstResponse(std::move(firstResponse), evb, this);
+      return;
+    }
+
+    resuming_ = false;
+    if (cancelled_) {
+      serverCallback_->onStreamCancel();
+      delete this;
+    } else if (token != token_) {
+      // The server started the stream again
+      serverCallback_->onStreamCancel();
+      fail();
+    } else if (auto tokens = std::exchange(pendingCredits_, 0)) {
+      serverCallback_->onStreamRequestN(tokens);
+    }
+  }
+  void onFirstResponseError(folly::exception_wrapper ew) override {
+    if (!resuming_) {
+      clientCallback_->onFirstResponseError(std::move(ew));
+      delete this;
+    } else if (cancelled_) {
+      delete this;
+    } else {
+      fail();
+    }
+  }
+
+  void onStreamNext(StreamPayload&& payload) override {
+    ++received_;
+    if (credits_) {
+      --credits_;
+    }
+    clientCallback_->onStreamNext(std::move(payload));
+  }
+  void onStreamError(folly::exception_wrapper ew) override {
+    serverCallback_ = nullptr;
+    if (token_ && isConnectionLoss(ew)) {
+      error_ = std::move(ew);
+      resuming_ = true;
+      // Out of the callbacks of the closing connection
+      channel_.evb_.runInLoop([this] { resume(); });
+      return;
+    }
+    clientCallback_->onStreamError(std::move(ew));
+    delete this;
+  }
+  void onStreamComplete() override {
+    clientCallback_->onStreamComplete();
+    delete this;
+  }
+  void onStreamHeaders(HeadersPayload&& payload) override {
+    clientCallback_->onStreamHeaders(std::move(payload));
+  }
+  void resetServerCallback(StreamServerCallback& serverCallback) override {
+    serverCallback_ = &serverCallback;
+  }
+
+  // StreamServerCallback implementation, called by the client
+  void onStreamRequestN(uint64_t tokens) override {
+    credits_ += tokens;
+    if (serverCallback_) {
+      serverCallback_->onStreamRequestN(tokens);
+    } else {
+      pendingCredits_ += tokens;
+    }
+  }
+  void onStreamCancel() override {
+    if (serverCallback_) {
+      serverCallback_->onStreamCancel();
+      delete this;
+    } else {
+      // Deleted once resuming is over
+      cancelled_ = true;
+    }
+  }
+  void onSinkHeaders(HeadersPayload&& payload) override {
+    if (serverCallback_) {
+      serverCallback_->onSinkHeaders(std::move(payload));
+    }
+  }
+  void resetClientCallback(StreamClientCallback& clientCallback) override {
+    clientCallback_ = &clientCallback;
+  }
+
+ private:
+  ReconnectingRequestChannel& channel_;
+  folly::DelayedDestruction::DestructorGuard channelGuard_;
+  StreamClientCallback* clientCallback_;
+  StreamServerCallback* serverCallback_{nullptr};
+
+  // To send the request again
+  RpcOptions options_;
+  const std::unique_ptr<folly::IOBuf> buf_;
+  const std::map<std::string, std::string> writeHeaders_;
+  const folly::Optional<uint32_t> crc32c_;
+
+  folly::Optional<std::string> token_;
+  uint64_t received_{0};
+  // Granted to the server and left unused
+  uint64_t credits_;
+  // Granted while resuming, after the request went out
+  uint64_t pendingCredits_{0};
+  bool resuming_{false};
+  bool cancelled_{false};
+  // Of the lost connection, for the client if resuming fails
+  folly::exception_wrapper error_;
+
+  static folly::Optional<std::string> getToken(
+      const ResponseRpcMetadata& metadata) {
+    if (auto otherMetadata = metadata.otherMetadata_ref()) {
+      auto it = otherMetadata->find(kStreamResumeTokenHeader.str());
+      if (it != otherMetadata->end()) {
+        return it->second;
+      }
+    }
+    return folly::none;
+  }
+
+  static bool isConnectionLoss(const folly::exception_wrapper& ew) {
+    bool lost = false;
+    ew.with_exception<transport::TTransportException>([&](const auto& ex) {
+      lost = ex.getType() !=
+              transport::TTransportException::TTransportExceptionType::
+                  TIMED_OUT &&
+          ex.getType() !=
+              transport::TTransportException::TTransportExceptionType::
+                  STREAMING_CONTRACT_VIOLATION;
+    });
+    return lost;
+  }
+
+  void resume() {
+    if (cancelled_) {
+      delete this;
+      return;
+    }
+    auto header = std::make_shared<transport::THeader>();
+    for (const auto& entry : writeHeaders_) {
+      header->setHeader(entry.first, entry.second);
+    }
+    header->setHeader(kStreamResumeTokenHeader.str(), *token_);
+    header->setHeader(
+        kStreamResumeSeqHeader.str(), folly::to<std::string>(received_));
+    header->setCrc32c(crc32c_);
+    // The first response takes one
+    options_.setChunkBufferSize(static_cast<int32_t>(std::min<uint64_t>(
+        credits_ + 1, std::numeric_limits<int32_t>::max())));
+    pendingCredits_ = 0;
+    channel_.impl().sendRequestStream(
+        options_, buf_->clone(), std::move(header), this);
+  }
+
+  void fail() {
+    clientCallback_->onStreamError(std::move(error_));
+    delete this;
+  }
+};
+
 void ReconnectingRequestChannel::sendRequestResponse(
     RpcOptions& options,
     std::unique_ptr<folly::IOBuf> buf,
@@ -63,6 +265,21 @@ void ReconnectingRequestChannel::sendRequestResponse(
       options, std::move(buf), std::move(header), std::move(cob));
 }
 
+void ReconnectingRequestChannel::sendRequestStream(
+    RpcOptions& options,
+    std::unique_ptr<folly::IOBuf> buf,
+    std::shared_ptr<transport::THeader> header,
+    StreamClientCallback* clientCallback) {
+  if (streamResumption_) {
+    header->setHeader(kStreamResumableHeader.str(), "1");
+    clientCallback = new ResumableStream(
+        *this, *clientCallback, options, buf->clone(), *header);
+  }
+
+  return impl().sendRequestStream(
+      options, std::move(buf), std::move(header), clientCallback);
+}
+
 ReconnectingRequestChannel::Impl& ReconnectingRequestChannel::impl() {
   if (!impl_ || !impl_->good()) {
     impl_ = implCreator_(evb_);
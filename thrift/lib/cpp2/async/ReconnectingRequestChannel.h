@@ -41,6 +41,11 @@ class THeader;
 
 // Simple RequestChannel wrapper that automatically re-creates underlying
 // RequestChannel in case request is about to be sent over a bad channel.
+//
+// With stream resumption on, streams that lose their connection are resumed
+// on a new one where the server left them, if the server made them resumable
+// (see ThriftServer::setStreamResumption()). Clients only see the error if
+// that fails.
 class ReconnectingRequestChannel : public RequestChannel {
  public:
   using Impl = ClientChannel;
@@ -60,6 +65,14 @@ class ReconnectingRequestChannel : public RequestChannel {
       std::shared_ptr<transport::THeader> header,
       RequestClientCallback::Ptr cob) override;
 
+  using RequestChannel::sendRequestStream;
+
+  void sendRequestStream(
+      RpcOptions& options,
+      std::unique_ptr<folly::IOBuf> buf,
+      std::shared_ptr<transport::THeader> header,
+      StreamClientCallback* clientCallback) override;
+
   void sendRequestNoResponse(
       RpcOptions&,
       std::unique_ptr<folly::IOBuf>,
@@ -80,6 +93,10 @@ class ReconnectingRequestChannel : public RequestChannel {
     return impl().getProtocolId();
   }
 
+  void setStreamResumption(bool enabled) {
+    streamResumption_ = enabled;
+  }
+
  protected:
   ~ReconnectingRequestChannel() override = default;
 
@@ -87,11 +104,14 @@ class ReconnectingRequestChannel : public RequestChannel {
   ReconnectingRequestChannel(folly::EventBase& evb, ImplCreator implCreator)
       : implCreator_(std::move(implCreator)), evb_(evb) {}
 
+  class ResumableStream;
+
   Impl& impl();
 
   ImplPtr impl_;
   ImplCreator implCreator_;
   folly::EventBase& evb_;
+  bool streamResumption_{false};
 };
 
 } // namespace thrift
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+#include <folly/Optional.h>
+#include <folly/io/async/Request.h>
+
+namespace apache {
+namespace thrift {
+
+/**
+ * Absolute deadline of the server request on behalf of which the code is
+ * running, stored in the folly::RequestContext.
+ *
+ * The generated processors attach it when dispatching a request whose caller
+ * propagated a deadline (requests which only have a client timeout don't pay
+ * for it), and client channels forward it to the servers they call, so that
+ * every server in a call graph can drop work its originator gave up on. A
+ * call graph is entered by attaching a RequestDeadline to the context of the
+ * first call.
+ *
+ * Clocks of different hosts may disagree: the time left until the deadline is
+ * always sent along as the client timeout, which bounds the deadline from the
+ * arrival of the request regardless of the clocks, and propagated deadlines
+ * are relaxed by clockSkewTolerance().
+ */
+class RequestDeadline : public folly::RequestData {
+ public:
+  using Clock = std::chrono::system_clock;
+
+  explicit RequestDeadline(Clock::time_point deadline) : deadline_(deadline) {}
+
+  static const folly::RequestToken& getRequestToken() {
+    static folly::RequestToken token("apache::thrift::RequestDeadline");
+    return token;
+  }
+
+  bool hasCallback() override {
+    return false;
+  }
+
+  Clock::time_point getDeadline() const {
+    return deadline_;
+  }
+
+  /**
+   * Deadline attached to the current folly::RequestContext, if any.
+   */
+  static folly::Optional<Clock::time_point> current() {
+    auto* ctx = folly::RequestContext::get();
+    auto* data = static_cast<RequestDeadline*>(
+        ctx ? ctx->getContextData(getRequestToken()) : nullptr);
+    if (!data) {
+      return folly::none;
+    }
+    return data->getDeadline();
+  }
+
+  /**
+   * How much later than stated a propagated deadline is assumed to be, so
+   * that callers whose clock is somewhat behind ours don't get their
+   * requests dropped.
+   */
+  static constexpr std::chrono::milliseconds clockSkewTolerance() {
+    return std::chrono::milliseconds(1000);
+  }
+
+  /**
+   * Client timeout to send along with a forwarded deadline: the time left
+   * until the deadline (at least 1ms), or the timeout of the call if it is
+   * set and sooner.
+   */
+  static std::chrono::milliseconds forwardedTimeout(
+      Clock::time_point deadline,
+      std::chrono::milliseconds timeout) {
+    auto remaining = std::max(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - Clock::now()),
+        std::chrono::milliseconds(1));
+    return timeout > std::chrono::milliseconds(0) && timeout < remaining
+        ? timeout
+        : remaining;
+  }
+
+  static std::chrono::milliseconds toEpochMs(Clock::time_point deadline) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline.time_since_epoch());
+  }
+
+  static Clock::time_point fromEpochMs(std::chrono::milliseconds deadline) {
+    return Clock::time_point(
+        std::chrono::duration_cast<Clock::duration>(deadline));
+  }
+
+ private:
+  const Clock::time_point deadline_;
+};
+
+} // namespace thrift
+} // namespace apache
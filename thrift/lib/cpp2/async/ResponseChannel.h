@@ -33,6 +33,7 @@
 #endif
 #include <thrift/lib/cpp2/async/StreamCallbacks.h>
 #include <thrift/lib/cpp2/server/AdmissionController.h>
+#include <thrift/lib/cpp2/server/MethodStats.h>
 
 namespace folly {
 class IOBuf;
@@ -59,10 +60,27 @@ extern const std::string kProxyAclCheckExceptionErrorCode;
 extern const std::string kProxyOverloadedErrorCode;
 extern const std::string kProxyLoopbackErrorCode;
 extern const std::string kRequestTypeDoesntMatchServiceFunctionType;
+extern const std::string kStreamResumeErrorCode;
 
 namespace apache {
 namespace thrift {
 
+/**
+ * Timings and sizes of a server request, collected when the server records
+ * per-method stats or slow requests. Time points are left to their default
+ * value if the request didn't reach the corresponding step.
+ */
+struct RequestTimings {
+  // The transport received the request
+  std::chrono::steady_clock::time_point received;
+  // The handler started processing the request
+  std::chrono::steady_clock::time_point processBegin;
+  // The response (or error) was handed back to the transport
+  std::chrono::steady_clock::time_point processEnd;
+  uint64_t requestBytes{0};
+  uint64_t responseBytes{0};
+};
+
 class ResponseChannelRequest {
  public:
   folly::IOBuf* getBuf() {
@@ -136,7 +154,7 @@ class ResponseChannelRequest {
   virtual ~ResponseChannelRequest() {
     if (admissionController_ != nullptr) {
       if (!startedProcessing_) {
-        admissionController_->dequeue();
+        admissionController_->dropped();
       } else {
         auto latency = std::chrono::steady_clock::now() - creationTimestamps_;
         admissionController_->returnedResponse(latency);
@@ -148,10 +166,19 @@ class ResponseChannelRequest {
     startedProcessing_ = true;
     if (admissionController_ != nullptr) {
       admissionController_->dequeue();
+    }
+    if (admissionController_ != nullptr || timingsEnabled_) {
       creationTimestamps_ = std::chrono::steady_clock::now();
+      timings_.processBegin = creationTimestamps_;
     }
   }
 
+  /**
+   * Called when the request is dropped without being processed because its
+   * deadline has passed.
+   */
+  virtual void onDeadlineExceeded() {}
+
   void setAdmissionController(
       std::shared_ptr<AdmissionController> admissionController) {
     admissionController_ = std::move(admissionController);
@@ -161,6 +188,38 @@ class ResponseChannelRequest {
     return admissionController_;
   }
 
+  /**
+   * Collect the timings and sizes of this request, see RequestTimings. Called
+   * by the transport when it receives the request.
+   */
+  void enableTimings(uint64_t requestBytes) {
+    timingsEnabled_ = true;
+    timings_.received = std::chrono::steady_clock::now();
+    timings_.requestBytes = requestBytes;
+  }
+
+  // nullptr unless enableTimings() was called
+  const RequestTimings* getTimings() const {
+    return timingsEnabled_ ? &timings_ : nullptr;
+  }
+
+  /**
+   * Record the queue time, process time and sizes of this request in the
+   * server per-method statistics. Requires the timings to be enabled.
+   */
+  void setMethodStats(ServerMethodStats* methodStats) {
+    methodStats_ = methodStats;
+  }
+
+  /**
+   * Called by implementations (if the timings are enabled) when the response
+   * is handed to the transport, responseBytes is 0 for errors.
+   */
+  void setResponseSent(uint64_t responseBytes) {
+    timings_.processEnd = std::chrono::steady_clock::now();
+    timings_.responseBytes = responseBytes;
+  }
+
   virtual apache::thrift::server::TServerObserver::CallTimestamps&
   getTimestamps() {
     return timestamps_;
@@ -173,6 +232,34 @@ class ResponseChannelRequest {
   std::shared_ptr<apache::thrift::AdmissionController> admissionController_;
   bool startedProcessing_{false};
   std::chrono::steady_clock::time_point creationTimestamps_;
+
+  /**
+   * Must be called by the destructor of implementations which set the method
+   * stats, while the method name is still alive.
+   */
+  void recordMethodStats(const std::string& methodName) {
+    if (methodStats_ == nullptr || !timingsEnabled_ || !startedProcessing_) {
+      return;
+    }
+    // Oneway requests never send a response
+    const auto processEnd =
+        timings_.processEnd == std::chrono::steady_clock::time_point()
+        ? std::chrono::steady_clock::now()
+        : timings_.processEnd;
+    methodStats_->record(
+        methodName,
+        {std::chrono::duration_cast<std::chrono::microseconds>(
+             timings_.processBegin - timings_.received),
+         std::chrono::duration_cast<std::chrono::microseconds>(
+             processEnd - timings_.processBegin),
+         timings_.requestBytes,
+         timings_.responseBytes});
+  }
+
+ private:
+  bool timingsEnabled_{false};
+  RequestTimings timings_;
+  ServerMethodStats* methodStats_{nullptr};
 };
 
 /**
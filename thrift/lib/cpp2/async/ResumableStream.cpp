@@ -0,0 +1,486 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrift/lib/cpp2/async/ResumableStream.h>
+
+#include <deque>
+
+#include <glog/logging.h>
+
+#include <fmt/core.h>
+#include <folly/ExceptionWrapper.h>
+#include <folly/Optional.h>
+#include <folly/Random.h>
+#include <folly/io/async/EventBase.h>
+#include <folly/io/async/HHWheelTimer.h>
+
+#include <thrift/lib/cpp/TApplicationException.h>
+
+namespace apache {
+namespace thrift {
+
+namespace {
+std::string makeToken() {
+  return fmt::format(
+      "{:016x}{:016x}",
+      folly::Random::secureRand64(),
+      folly::Random::secureRand64());
+}
+} // namespace
+
+namespace detail {
+
+class ResumableStreamAttachment;
+
+// Sits between the producer of a stream and the connection the stream is sent
+// on, which changes when the stream is resumed. Lives on the producer's event
+// base.
+class ResumableServerStream final
+    : public StreamClientCallback,
+      public std::enable_shared_from_this<ResumableServerStream>,
+      private folly::HHWheelTimer::Callback {
+ public:
+  ResumableServerStream(
+      std::shared_ptr<ResumableStreamRegistry> registry,
+      folly::EventBase& evb,
+      std::string token)
+      : registry_(std::move(registry)), evb_(evb), token_(std::move(token)) {}
+
+  folly::EventBase& getEventBase() const {
+    return evb_;
+  }
+
+  void start(StreamServerCallback& producer) {
+    producer_ = &producer;
+    producer.resetClientCallback(*this);
+  }
+
+  // 'seq' is the number of payloads the client received, none for the first
+  // connection
+  void attach(
+      std::shared_ptr<ResumableStreamAttachment> attachment,
+      folly::Optional<uint64_t> seq);
+
+  // Called through the attachments
+  void request(ResumableStreamAttachment& attachment, uint64_t tokens);
+  void cancel(ResumableStreamAttachment& attachment);
+  void detach(ResumableStreamAttachment& attachment);
+  void headers(
+      ResumableStreamAttachment& attachment,
+      HeadersPayload&& payload);
+
+  // StreamClientCallback implementation, called by the producer
+  void onFirstResponse(
+      FirstResponsePayload&&,
+      folly::EventBase*,
+      StreamServerCallback*) override {
+    LOG(FATAL) << "First response of a resumable stream sent by the producer";
+  }
+  void onFirstResponseError(folly::exception_wrapper) override {
+    LOG(FATAL) << "First response of a resumable stream sent by the producer";
+  }
+  void onStreamNext(StreamPayload&& payload) override;
+  void onStreamError(folly::exception_wrapper ew) override;
+  void onStreamComplete() override;
+  void onStreamHeaders(HeadersPayload&& payload) override;
+  void resetServerCallback(StreamServerCallback& producer) override {
+    producer_ = &producer;
+  }
+
+ private:
+  struct Entry {
+    StreamPayload payload;
+    size_t bytes;
+  };
+
+  const std::shared_ptr<ResumableStreamRegistry> registry_;
+  folly::EventBase& evb_;
+  const std::string token_;
+
+  StreamServerCallback* producer_{nullptr};
+  std::shared_ptr<ResumableStreamAttachment> attachment_;
+
+  // Payloads [lastSeq_ - buffer_.size() + 1, lastSeq_], by sequence number
+  // starting at 1. The ones up to sentSeq_ were sent on the current or last
+  // connection and are dropped past the size of the replay buffer; the others
+  // are waiting for credits.
+  std::deque<Entry> buffer_;
+  size_t bufferBytes_{0};
+  uint64_t lastSeq_{0};
+  uint64_t sentSeq_{0};
+
+  // Granted by the client of the current connection and left unused
+  uint64_t credits_{0};
+  // Granted to the producer and left unused
+  uint64_t producerCredits_{0};
+
+  bool producerDone_{false};
+  folly::exception_wrapper error_;
+  bool finished_{false};
+
+  void deliver(bool defer);
+  void trim();
+  void cancelProducer();
+  void finish();
+
+  // Expiry of a detached stream
+  void timeoutExpired() noexcept override;
+};
+
+// What a connection sees of a resumable stream. Lives on the connection's
+// event base.
+class ResumableStreamAttachment final
+    : public StreamServerCallback,
+      public std::enable_shared_from_this<ResumableStreamAttachment> {
+ public:
+  ResumableStreamAttachment(
+      std::shared_ptr<ResumableServerStream> stream,
+      StreamClientCallback& transport,
+      folly::EventBase& evb)
+      : stream_(std::move(stream)), transport_(&transport), evb_(evb) {}
+
+  // StreamServerCallback implementation, called by the transport
+  void onStreamRequestN(uint64_t tokens) override {
+    toStream([tokens](auto& stream, auto& self) {
+      stream.request(self, tokens);
+    });
+  }
+  void onStreamCancel() override {
+    transport_ = nullptr;
+    toStream([](auto& stream, auto& self) { stream.cancel(self); });
+  }
+  void onConnectionClosed() override {
+    transport_ = nullptr;
+    toStream([](auto& stream, auto& self) { stream.detach(self); });
+  }
+  void onSinkHeaders(HeadersPayload&& payload) override {
+    toStream([payload = std::move(payload)](auto& stream, auto& self) mutable {
+      stream.headers(self, std::move(payload));
+    });
+  }
+  void resetClientCallback(StreamClientCallback& transport) override {
+    transport_ = &transport;
+  }
+
+  // Called by the stream. Calls into the transport are deferred to the next
+  // turn of the connection's event base if 'defer' is set, or if the stream
+  // is on another one.
+  void next(StreamPayload&& payload, bool defer) {
+    toTransport(
+        [payload = std::move(payload)](StreamClientCallback& t) mutable {
+          t.onStreamNext(std::move(payload));
+        },
+        defer,
+        false);
+  }
+  void headers(HeadersPayload&& payload) {
+    toTransport(
+        [payload = std::move(payload)](StreamClientCallback& t) mutable {
+          t.onStreamHeaders(std::move(payload));
+        },
+        false,
+        false);
+  }
+  void complete(bool defer) {
+    toTransport(
+        [](StreamClientCallback& t) { t.onStreamComplete(); }, defer, true);
+  }
+  void error(folly::exception_wrapper ew, bool defer) {
+    toTransport(
+        [ew = std::move(ew)](StreamClientCallback& t) mutable {
+          t.onStreamError(std::move(ew));
+        },
+        defer,
+        true);
+  }
+
+ private:
+  const std::shared_ptr<ResumableServerStream> stream_;
+  // Until the stream ends on this connection
+  StreamClientCallback* transport_;
+  folly::EventBase& evb_;
+
+  template <class F>
+  void toStream(F&& f) {
+    auto& evb = stream_->getEventBase();
+    if (evb.isInEventBaseThread()) {
+      auto self = shared_from_this();
+      f(*stream_, *this);
+    } else {
+      evb.runInEventBaseThread(
+          [self = shared_from_this(), f = std::forward<F>(f)]() mutable {
+            f(*self->stream_, *self);
+          });
+    }
+  }
+
+  template <class F>
+  void toTransport(F&& f, bool defer, bool last) {
+    auto run = [last](ResumableStreamAttachment& self, F& f) {
+      if (auto* transport = self.transport_) {
+        if (last) {
+          self.transport_ = nullptr;
+        }
+        f(*transport);
+      }
+    };
+    if (!defer && evb_.isInEventBaseThread()) {
+      run(*this, f);
+    } else {
+      evb_.runInEventBaseThread(
+          [self = shared_from_this(), f = std::forward<F>(f), run]() mutable {
+            run(*self, f);
+          });
+    }
+  }
+};
+
+void ResumableServerStream::attach(
+    std::shared_ptr<ResumableStreamAttachment> attachment,
+    folly::Optional<uint64_t> seq) {
+  if (finished_) {
+    // Expired or cancelled while the client was resuming it
+    attachment->error(
+        folly::make_exception_wrapper<TApplicationException>(
+            "Stream can't be resumed"),
+        true);
+    return;
+  }
+  // The client may be back before the old connection noticed it's gone
+  if (auto old = std::exchange(attachment_, nullptr)) {
+    old->error(
+        folly::make_exception_wrapper<TApplicationException>(
+            "Stream resumed on another connection"),
+        false);
+  }
+  cancelTimeout();
+
+  if (seq) {
+    const uint64_t firstSeq = lastSeq_ - buffer_.size() + 1;
+    if (*seq > sentSeq_ || *seq + 1 < firstSeq) {
+      attachment->error(
+          folly::make_exception_wrapper<TApplicationException>(fmt::format(
+              "Can't resume stream after payload {}, replay buffer starts at "
+              "{}",
+              *seq,
+              firstSeq)),
+          true);
+      cancelProducer();
+      finish();
+      return;
+    }
+    sentSeq_ = *seq;
+  }
+  attachment_ = std::move(attachment);
+  credits_ = 0;
+  // Payloads wait for the credits of the new client, but the end of the stream
+  // may be all there is left to send. It's deferred so that the first response
+  // goes first.
+  deliver(true);
+}
+
+void ResumableServerStream::request(
+    ResumableStreamAttachment& attachment,
+    uint64_t tokens) {
+  if (&attachment != attachment_.get()) {
+    return;
+  }
+  credits_ += tokens;
+  deliver(false);
+}
+
+void ResumableServerStream::cancel(ResumableStreamAttachment& attachment) {
+  if (&attachment != attachment_.get()) {
+    return;
+  }
+  attachment_.reset();
+  cancelProducer();
+  finish();
+}
+
+void ResumableServerStream::detach(ResumableStreamAttachment& attachment) {
+  if (&attachment != attachment_.get()) {
+    return;
+  }
+  attachment_.reset();
+  credits_ = 0;
+  evb_.timer().scheduleTimeout(this, registry_->resumeTimeout_);
+}
+
+void ResumableServerStream::headers(
+    ResumableStreamAttachment& attachment,
+    HeadersPayload&& payload) {
+  if (&attachment == attachment_.get() && producer_) {
+    producer_->onSinkHeaders(std::move(payload));
+  }
+}
+
+void ResumableServerStream::onStreamNext(StreamPayload&& payload) {
+  if (producerCredits_) {
+    --producerCredits_;
+  }
+  auto bytes = payload.payload ? payload.payload->computeChainDataLength() : 0;
+  bufferBytes_ += bytes;
+  buffer_.push_back(Entry{std::move(payload), bytes});
+  ++lastSeq_;
+  deliver(false);
+}
+
+void ResumableServerStream::onStreamError(folly::exception_wrapper ew) {
+  producer_ = nullptr;
+  producerDone_ = true;
+  error_ = std::move(ew);
+  deliver(false);
+}
+
+void ResumableServerStream::onStreamComplete() {
+  producer_ = nullptr;
+  producerDone_ = true;
+  deliver(false);
+}
+
+void ResumableServerStream::onStreamHeaders(HeadersPayload&& payload) {
+  if (attachment_) {
+    attachment_->headers(std::move(payload));
+  }
+}
+
+void ResumableServerStream::deliver(bool defer) {
+  auto self = shared_from_this();
+  // A closing connection may detach the stream while it's sending
+  while (attachment_ && credits_ != 0 && sentSeq_ != lastSeq_) {
+    auto attachment = attachment_;
+    const auto& entry = buffer_[buffer_.size() - (lastSeq_ - sentSeq_)];
+    ++sentSeq_;
+    --credits_;
+    auto payload =
+        entry.payload.payload ? entry.payload.payload->clone() : nullptr;
+    attachment->next(
+        StreamPayload(std::move(payload), entry.payload.metadata), defer);
+  }
+  trim();
+
+  if (producerDone_) {
+    if (attachment_ && sentSeq_ == lastSeq_) {
+      auto attachment = std::exchange(attachment_, nullptr);
+      if (error_) {
+        attachment->error(std::move(error_), defer);
+      } else {
+        attachment->complete(defer);
+      }
+      finish();
+    }
+    return;
+  }
+
+  // Payloads waiting for credits count against the credits of the producer,
+  // which can then have at most as many payloads pending as the client
+  // granted
+  const uint64_t pending = lastSeq_ - sentSeq_ + producerCredits_;
+  if (producer_ && credits_ > pending) {
+    const uint64_t tokens = credits_ - pending;
+    producerCredits_ += tokens;
+    producer_->onStreamRequestN(tokens);
+  }
+}
+
+void ResumableServerStream::trim() {
+  const size_t limit = registry_->replayBufferBytes_;
+  while (bufferBytes_ > limit && lastSeq_ - buffer_.size() < sentSeq_) {
+    bufferBytes_ -= buffer_.front().bytes;
+    buffer_.pop_front();
+  }
+}
+
+void ResumableServerStream::cancelProducer() {
+  if (auto* producer = std::exchange(producer_, nullptr)) {
+    producerDone_ = true;
+    producer->onStreamCancel();
+  }
+}
+
+void ResumableServerStream::finish() {
+  auto self = shared_from_this();
+  finished_ = true;
+  cancelTimeout();
+  buffer_.clear();
+  bufferBytes_ = 0;
+  registry_->remove(token_);
+}
+
+void ResumableServerStream::timeoutExpired() noexcept {
+  if (!attachment_) {
+    cancelProducer();
+    finish();
+  }
+}
+
+} // namespace detail
+
+std::pair<StreamServerCallback*, std::string> ResumableStreamRegistry::add(
+    StreamServerCallback& stream,
+    StreamClientCallback& transport,
+    folly::EventBase& evb) {
+  auto token = makeToken();
+  auto resumable = std::make_shared<detail::ResumableServerStream>(
+      shared_from_this(), evb, token);
+  streams_.wlock()->emplace(token, resumable);
+
+  resumable->start(stream);
+  auto attachment = std::make_shared<detail::ResumableStreamAttachment>(
+      resumable, transport, evb);
+  auto* callback = attachment.get();
+  resumable->attach(std::move(attachment), folly::none);
+  return {callback, std::move(token)};
+}
+
+StreamServerCallback* ResumableStreamRegistry::resume(
+    folly::StringPiece token,
+    uint64_t seq,
+    StreamClientCallback& transport,
+    folly::EventBase& evb) {
+  std::shared_ptr<detail::ResumableServerStream> resumable;
+  {
+    auto streams = streams_.rlock();
+    auto it = streams->find(token.str());
+    if (it == streams->end()) {
+      return nullptr;
+    }
+    resumable = it->second;
+  }
+
+  auto attachment = std::make_shared<detail::ResumableStreamAttachment>(
+      resumable, transport, evb);
+  auto* callback = attachment.get();
+  auto& streamEvb = resumable->getEventBase();
+  if (streamEvb.isInEventBaseThread()) {
+    resumable->attach(std::move(attachment), seq);
+  } else {
+    // Queued before the credits the first response makes the transport grant
+    streamEvb.runInEventBaseThread(
+        [resumable, attachment = std::move(attachment), seq]() mutable {
+          resumable->attach(std::move(attachment), seq);
+        });
+  }
+  return callback;
+}
+
+void ResumableStreamRegistry::remove(const std::string& token) {
+  streams_.wlock()->erase(token);
+}
+
+} // namespace thrift
+} // namespace apache
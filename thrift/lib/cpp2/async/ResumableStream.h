@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <folly/Range.h>
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+
+#include <thrift/lib/cpp2/async/StreamCallbacks.h>
+
+namespace folly {
+class EventBase;
+} // namespace folly
+
+namespace apache {
+namespace thrift {
+
+// Request header of a client able to resume its streams
+constexpr folly::StringPiece kStreamResumableHeader("stream_resumable");
+// First response header with the token to resume the stream with, sent back
+// by the client to resume it
+constexpr folly::StringPiece kStreamResumeTokenHeader("stream_resume_token");
+// Number of payloads of the stream the resuming client received
+constexpr folly::StringPiece kStreamResumeSeqHeader("stream_resume_seq");
+
+namespace detail {
+class ResumableServerStream;
+} // namespace detail
+
+/**
+ * Server streams that survive the loss of the connection they're sent on.
+ *
+ * A resumable stream keeps its last payloads in a bounded replay buffer.
+ * When its connection closes, it's parked here for the resume timeout instead
+ * of being cancelled. A client reconnecting with the stream's token and the
+ * number of payloads it received gets the rest of the stream on the new
+ * connection: first the payloads it missed from the replay buffer, then the
+ * ones produced since. Resuming fails once those payloads are out of the
+ * buffer.
+ *
+ * Thread-safe. A stream stays on the event base of its producer, resuming it
+ * on a connection of another event base makes its callbacks hop.
+ */
+class ResumableStreamRegistry
+    : public std::enable_shared_from_this<ResumableStreamRegistry> {
+ public:
+  ResumableStreamRegistry(
+      size_t replayBufferBytes,
+      std::chrono::milliseconds resumeTimeout)
+      : replayBufferBytes_(replayBufferBytes), resumeTimeout_(resumeTimeout) {}
+
+  /**
+   * Makes 'stream' resumable, 'transport' being the connection it's about to
+   * be sent on. Returns the callback to give the transport in place of
+   * 'stream' and the token to resume it with. Must run on 'evb', the event
+   * base of both.
+   */
+  std::pair<StreamServerCallback*, std::string> add(
+      StreamServerCallback& stream,
+      StreamClientCallback& transport,
+      folly::EventBase& evb);
+
+  /**
+   * Resumes the stream of 'token' on 'transport', the client having received
+   * 'seq' payloads. Returns the callback to give the transport, or nullptr if
+   * there's no such stream (anymore). Must run on 'evb', the event base of
+   * 'transport', and be followed by the first response.
+   */
+  StreamServerCallback* resume(
+      folly::StringPiece token,
+      uint64_t seq,
+      StreamClientCallback& transport,
+      folly::EventBase& evb);
+
+  size_t size() const {
+    return streams_.rlock()->size();
+  }
+
+ private:
+  friend class detail::ResumableServerStream;
+
+  void remove(const std::string& token);
+
+  const size_t replayBufferBytes_;
+  const std::chrono::milliseconds resumeTimeout_;
+  folly::Synchronized<folly::F14FastMap<
+      std::string,
+      std::shared_ptr<detail::ResumableServerStream>>>
+      streams_;
+};
+
+} // namespace thrift
+} // namespace apache
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include <boost/variant.hpp>
 
 #include <folly/Portability.h>
@@ -43,6 +45,9 @@ struct SinkConsumerImpl {
   uint64_t bufferSize;
   std::chrono::milliseconds chunkTimeout;
   folly::Executor::KeepAlive<folly::SequencedExecutor> executor;
+  // Throughput mode, see SinkOptions
+  uint64_t batchBytes{0};
+  uint64_t bufferBytes{0};
 
   explicit operator bool() const {
     return (bool)consumer;
@@ -128,7 +133,11 @@ class ServerSinkBridge : public TwoWayBridge<
   }
 
   folly::coro::AsyncGenerator<folly::Try<StreamPayload>&&> makeGenerator() {
-    uint64_t counter = 0;
+    // credits granted to the client and not used yet, and the number to keep
+    // it at, which tracks bufferBytes if set
+    uint64_t credits = consumer_.bufferSize;
+    uint64_t window = consumer_.bufferSize;
+    uint64_t avgPayloadBytes = 0;
     while (true) {
       CoroConsumer consumer;
       if (serverWait(&consumer)) {
@@ -164,11 +173,35 @@ class ServerSinkBridge : public TwoWayBridge<
           co_return;
         }
 
-        co_yield std::move(ele);
-        counter++;
-        if (counter > consumer_.bufferSize / 2) {
-          serverPush(counter);
-          counter = 0;
+        uint64_t payloadBytes = ele->payload->computeChainDataLength();
+        if (ele->metadata.itemSizes_ref()) {
+          auto items = splitSinkBatch(std::move(ele).value());
+          if (items.hasException()) {
+            clientException_ = true;
+            co_yield folly::Try<StreamPayload>(std::move(items).exception());
+            co_return;
+          }
+          for (auto& item : *items) {
+            co_yield folly::Try<StreamPayload>(std::move(item));
+          }
+        } else {
+          co_yield std::move(ele);
+        }
+
+        if (consumer_.bufferBytes > 0) {
+          avgPayloadBytes = avgPayloadBytes == 0
+              ? payloadBytes
+              : (avgPayloadBytes * 7 + payloadBytes) / 8;
+          window = std::max<uint64_t>(
+              consumer_.bufferBytes / std::max<uint64_t>(avgPayloadBytes, 1),
+              1);
+        }
+        if (credits > 0) {
+          credits--;
+        }
+        if (credits < window - window / 2) {
+          serverPush(static_cast<int64_t>(window - credits));
+          credits = window;
         }
       }
     }
@@ -112,6 +112,14 @@ class ClientSink {
 
 struct SinkOptions {
   std::chrono::milliseconds chunkTimeout;
+  // Throughput mode, for sinks pushing many small items. With batchBytes set,
+  // the client coalesces items into payloads of up to that many bytes; a
+  // payload is held until it's full, the client's generator has to wait for
+  // its next item or the sink ends. With bufferBytes set, bufferSize only
+  // sizes the first credit grant and later grants keep about bufferBytes of
+  // payloads in flight.
+  uint64_t batchBytes{0};
+  uint64_t bufferBytes{0};
 };
 
 template <typename SinkElement, typename FinalResponse>
@@ -130,6 +138,22 @@ struct SinkConsumer {
     sinkOptions.chunkTimeout = timeout;
     return this;
   }
+  SinkConsumer&& setBatchBytes(uint64_t bytes) && {
+    sinkOptions.batchBytes = bytes;
+    return std::move(*this);
+  }
+  SinkConsumer& setBatchBytes(uint64_t bytes) & {
+    sinkOptions.batchBytes = bytes;
+    return *this;
+  }
+  SinkConsumer&& setBufferBytes(uint64_t bytes) && {
+    sinkOptions.bufferBytes = bytes;
+    return std::move(*this);
+  }
+  SinkConsumer& setBufferBytes(uint64_t bytes) & {
+    sinkOptions.bufferBytes = bytes;
+    return *this;
+  }
 #endif
 };
 
@@ -19,11 +19,16 @@
 #include <folly/Portability.h>
 
 #ifdef FOLLY_HAS_COROUTINES
+#include <vector>
+
 #include <boost/variant.hpp>
 
 #include <folly/experimental/coro/Baton.h>
 #include <folly/experimental/coro/Task.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBufQueue.h>
 
+#include <thrift/lib/cpp/transport/TTransportException.h>
 #include <thrift/lib/cpp2/async/StreamCallbacks.h>
 
 namespace apache {
@@ -36,6 +41,72 @@ struct SinkComplete {};
 using ServerMessage =
     boost::variant<folly::Try<StreamPayload>, StreamCancel, SinkComplete>;
 
+// Coalesces serialized sink items into a single payload. The item sizes travel
+// in the payload metadata, for the server to split it with splitSinkBatch().
+class SinkBatch {
+ public:
+  void add(StreamPayload&& item) {
+    auto size = item.payload->computeChainDataLength();
+    sizes_.push_back(static_cast<int32_t>(size));
+    bytes_ += size;
+    queue_.append(std::move(item.payload));
+  }
+
+  bool empty() const {
+    return sizes_.empty();
+  }
+
+  size_t bytes() const {
+    return bytes_;
+  }
+
+  StreamPayload finish() {
+    StreamPayloadMetadata metadata;
+    if (sizes_.size() > 1) {
+      metadata.itemSizes_ref() = std::move(sizes_);
+    }
+    sizes_.clear();
+    bytes_ = 0;
+    auto payload = queue_.move();
+    if (!payload) {
+      payload = folly::IOBuf::create(0);
+    }
+    return StreamPayload(std::move(payload), std::move(metadata));
+  }
+
+ private:
+  folly::IOBufQueue queue_;
+  std::vector<int32_t> sizes_;
+  size_t bytes_{0};
+};
+
+inline folly::Try<std::vector<StreamPayload>> splitSinkBatch(
+    StreamPayload&& batch) {
+  const auto& sizes = *batch.metadata.itemSizes_ref();
+  bool valid = true;
+  size_t total = 0;
+  for (auto size : sizes) {
+    valid = valid && size >= 0;
+    total += size;
+  }
+  if (!valid || total != batch.payload->computeChainDataLength()) {
+    return folly::Try<std::vector<StreamPayload>>(
+        folly::make_exception_wrapper<transport::TTransportException>(
+            transport::TTransportException::CORRUPTED_DATA,
+            "sink payload doesn't match its item sizes"));
+  }
+
+  std::vector<StreamPayload> items;
+  items.reserve(sizes.size());
+  folly::io::Cursor cursor(batch.payload.get());
+  for (auto size : sizes) {
+    std::unique_ptr<folly::IOBuf> item;
+    cursor.clone(item, size);
+    items.emplace_back(std::move(item), StreamPayloadMetadata());
+  }
+  return folly::Try<std::vector<StreamPayload>>(std::move(items));
+}
+
 class CoroConsumer {
  public:
   void consume() {
@@ -60,6 +60,11 @@ class StreamServerCallback {
 
   virtual void onStreamRequestN(uint64_t) = 0;
   virtual void onStreamCancel() = 0;
+  // The connection the stream was sent on closed without the client
+  // cancelling it. Resumable streams wait for the client to come back.
+  virtual void onConnectionClosed() {
+    onStreamCancel();
+  }
 
   virtual void onSinkHeaders(HeadersPayload&&) {}
 
@@ -19,6 +19,8 @@
 #include <atomic>
 #include <cassert>
 #include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
 
 #include <folly/lang/Assume.h>
@@ -28,14 +30,22 @@ namespace thrift {
 namespace detail {
 namespace twowaybridge_detail {
 
+template <typename T>
+class NodePool;
+
 template <typename T>
 class Queue {
  public:
   Queue() {}
-  Queue(Queue&& other) : head_(std::exchange(other.head_, nullptr)) {}
+  Queue(Queue&& other)
+      : head_(std::exchange(other.head_, nullptr)),
+        ordered_(std::exchange(other.ordered_, true)),
+        pool_(std::move(other.pool_)) {}
   Queue& operator=(Queue&& other) {
     clear();
     std::swap(head_, other.head_);
+    std::swap(ordered_, other.ordered_);
+    std::swap(pool_, other.pool_);
     return *this;
   }
   ~Queue() {
@@ -47,16 +57,21 @@ class Queue {
   }
 
   T& front() {
-    return head_->value;
+    order();
+    return head_->value();
   }
 
   void pop() {
-    std::unique_ptr<Node>(std::exchange(head_, head_->next));
+    order();
+    auto node = std::exchange(head_, head_->next);
+    NodePool<T>::release(pool_.get(), node);
   }
 
   void clear() {
+    // In any order
     while (!empty()) {
-      pop();
+      auto node = std::exchange(head_, head_->next);
+      NodePool<T>::release(pool_.get(), node);
     }
   }
 
@@ -65,10 +80,16 @@ class Queue {
     template <typename Consumer, typename Message>
     friend class AtomicQueue;
     friend class Queue;
+    friend class NodePool<T>;
+
+    Node() {}
 
-    explicit Node(T&& t) : value(std::move(t)) {}
+    // Storage is reused by the pool, the value only lives while queued
+    T& value() {
+      return *reinterpret_cast<T*>(&storage);
+    }
 
-    T value;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
     Node* next{nullptr};
   };
 
@@ -76,9 +97,111 @@ class Queue {
   template <typename Consumer, typename Message>
   friend class AtomicQueue;
 
-  explicit Queue(Node* head) : head_(head) {}
+  // Takes the messages newest first, as they are pushed
+  Queue(Node* tail, std::shared_ptr<NodePool<T>> pool)
+      : head_(tail), ordered_(!tail->next), pool_(std::move(pool)) {}
+
+  // Reverses the messages on first access rather than when they are taken
+  // from the AtomicQueue, single messages are already in order.
+  void order() {
+    if (ordered_) {
+      return;
+    }
+    ordered_ = true;
+    Node* tail = std::exchange(head_, nullptr);
+    while (tail) {
+      head_ = std::exchange(tail, std::exchange(tail->next, head_));
+    }
+  }
 
   Node* head_{nullptr};
+  bool ordered_{true};
+  std::shared_ptr<NodePool<T>> pool_;
+};
+
+/**
+ * Nodes freed by the consumer of an AtomicQueue, reused by its producer so
+ * that messages don't need an allocation each in steady state.
+ *
+ * Freed nodes are pushed to a lock-free stack, which the producer takes whole
+ * when it runs out of nodes, so that there is no ABA problem. The producer's
+ * own list is guarded by a flag: concurrent pushes, which the bridges don't
+ * make, just allocate.
+ */
+template <typename T>
+class NodePool {
+ public:
+  using Node = typename Queue<T>::Node;
+
+  NodePool() {}
+  NodePool(const NodePool&) = delete;
+  NodePool& operator=(const NodePool&) = delete;
+
+  ~NodePool() {
+    deleteList(producerNodes_);
+    deleteList(freed_.load(std::memory_order_acquire));
+  }
+
+  Node* acquire(T&& value) {
+    Node* node = nullptr;
+    if (!producerLock_.test_and_set(std::memory_order_acquire)) {
+      if (!producerNodes_) {
+        producerNodes_ = freed_.exchange(nullptr, std::memory_order_acquire);
+      }
+      if ((node = producerNodes_)) {
+        producerNodes_ = node->next;
+        size_.fetch_sub(1, std::memory_order_relaxed);
+      }
+      producerLock_.clear(std::memory_order_release);
+    }
+    if (!node) {
+      node = new Node();
+    }
+    try {
+      new (&node->storage) T(std::move(value));
+    } catch (...) {
+      release(this, node, false);
+      throw;
+    }
+    node->next = nullptr;
+    return node;
+  }
+
+  // 'pool' may be null for queues not attached to any
+  static void release(NodePool* pool, Node* node, bool constructed = true) {
+    if (constructed) {
+      node->value().~T();
+    }
+    if (!pool ||
+        pool->size_.load(std::memory_order_relaxed) >= kMaxPooledNodes) {
+      delete node;
+      return;
+    }
+    pool->size_.fetch_add(1, std::memory_order_relaxed);
+    node->next = pool->freed_.load(std::memory_order_relaxed);
+    while (!pool->freed_.compare_exchange_weak(
+        node->next,
+        node,
+        std::memory_order_release,
+        std::memory_order_relaxed)) {
+    }
+  }
+
+ private:
+  // Enough for the batches of a busy stream, without keeping much memory for
+  // idle ones.
+  static constexpr size_t kMaxPooledNodes = 64;
+
+  static void deleteList(Node* node) {
+    while (node) {
+      delete std::exchange(node, node->next);
+    }
+  }
+
+  std::atomic<Node*> freed_{nullptr};
+  std::atomic<size_t> size_{0};
+  std::atomic_flag producerLock_ = ATOMIC_FLAG_INIT;
+  Node* producerNodes_{nullptr};
 };
 
 template <typename Consumer, typename Message>
@@ -106,8 +229,8 @@ class AtomicQueue {
   AtomicQueue& operator=(const AtomicQueue&) = delete;
 
   void push(Message&& value) {
-    std::unique_ptr<typename MessageQueue::Node> node(
-        new typename MessageQueue::Node(std::move(value)));
+    std::unique_ptr<typename MessageQueue::Node, NodeDeleter> node(
+        pool_->acquire(std::move(value)), NodeDeleter{pool_.get()});
     assert(!(reinterpret_cast<intptr_t>(node.get()) & kTypeMask));
 
     auto storage = storage_.load(std::memory_order_relaxed);
@@ -225,19 +348,24 @@ class AtomicQueue {
  private:
   enum class Type : intptr_t { EMPTY = 0, CONSUMER = 1, TAIL = 2, CLOSED = 3 };
 
-  MessageQueue makeQueue(typename MessageQueue::Node* tail) {
-    // Reverse a linked list.
-    typename MessageQueue::Node* head{nullptr};
-    while (tail) {
-      head = std::exchange(tail, std::exchange(tail->next, head));
+  struct NodeDeleter {
+    void operator()(typename MessageQueue::Node* node) const {
+      twowaybridge_detail::NodePool<Message>::release(pool, node);
     }
-    return MessageQueue(head);
+    twowaybridge_detail::NodePool<Message>* pool;
+  };
+
+  MessageQueue makeQueue(typename MessageQueue::Node* tail) {
+    return MessageQueue(tail, pool_);
   }
 
   static constexpr intptr_t kTypeMask = 3;
   static constexpr intptr_t kPointerMask = ~kTypeMask;
 
   std::atomic<intptr_t> storage_{0};
+  // Shared with the queues returned by getMessages(), which may outlive this
+  const std::shared_ptr<NodePool<Message>> pool_{
+      std::make_shared<NodePool<Message>>()};
 };
 } // namespace twowaybridge_detail
 
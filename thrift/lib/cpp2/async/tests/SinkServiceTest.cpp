@@ -40,6 +40,66 @@ TEST_F(SinkServiceTest, SimpleSink) {
       });
 }
 
+TEST_F(SinkServiceTest, SinkBatched) {
+  connectToServer(
+      [](TestSinkServiceAsyncClient& client) -> folly::coro::Task<void> {
+        auto sink = co_await client.co_rangeBatched(0, 1000);
+        bool finalResponse =
+            co_await sink.sink([]() -> folly::coro::AsyncGenerator<int&&> {
+              for (int i = 0; i <= 1000; i++) {
+                co_yield std::move(i);
+              }
+            }());
+        EXPECT_TRUE(finalResponse);
+      });
+}
+
+TEST_F(SinkServiceTest, SinkBatchFlushedWhenGeneratorWaits) {
+  connectToServer(
+      [this](TestSinkServiceAsyncClient& client) -> folly::coro::Task<void> {
+        auto sink = co_await client.co_rangeBatched(0, 1);
+        bool finalResponse = co_await sink.sink(
+            [](folly::coro::Baton& received)
+                -> folly::coro::AsyncGenerator<int&&> {
+              int i = 0;
+              co_yield std::move(i);
+              // The first item doesn't fill a batch, it is sent as the
+              // generator waits for the server to receive it
+              co_await received;
+              i = 1;
+              co_yield std::move(i);
+            }(handler_->batchedItemReceived));
+        EXPECT_TRUE(finalResponse);
+      });
+}
+
+TEST_F(SinkServiceTest, SinkBatchRoundTrip) {
+  detail::SinkBatch batch;
+  for (std::string s : {"a", "bc", "", "def"}) {
+    batch.add(StreamPayload(folly::IOBuf::copyBuffer(s), {}));
+  }
+  EXPECT_EQ(6, batch.bytes());
+  auto payload = batch.finish();
+  EXPECT_TRUE(batch.empty());
+  ASSERT_TRUE(payload.metadata.itemSizes_ref());
+
+  auto items = detail::splitSinkBatch(std::move(payload));
+  ASSERT_TRUE(items.hasValue());
+  std::vector<std::string> strs;
+  for (auto& item : *items) {
+    strs.push_back(item.payload->moveToFbString().toStdString());
+  }
+  EXPECT_EQ((std::vector<std::string>{"a", "bc", "", "def"}), strs);
+
+  StreamPayload corrupted(folly::IOBuf::copyBuffer("abc"), {});
+  corrupted.metadata.itemSizes_ref() = std::vector<int32_t>{1, 1};
+  EXPECT_TRUE(detail::splitSinkBatch(std::move(corrupted)).hasException());
+
+  // a single item goes as is
+  batch.add(StreamPayload(folly::IOBuf::copyBuffer("x"), {}));
+  EXPECT_FALSE(batch.finish().metadata.itemSizes_ref());
+}
+
 TEST_F(SinkServiceTest, SinkThrow) {
   connectToServer(
       [](TestSinkServiceAsyncClient& client) -> folly::coro::Task<void> {
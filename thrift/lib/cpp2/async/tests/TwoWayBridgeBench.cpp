@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrift/lib/cpp2/async/TwoWayBridge.h>
+
+#include <thread>
+
+#include <folly/Benchmark.h>
+#include <folly/fibers/Baton.h>
+#include <folly/init/Init.h>
+#include <folly/io/async/ScopedEventBaseThread.h>
+#include <folly/synchronization/Baton.h>
+
+#include <thrift/lib/cpp2/async/ClientBufferedStream.h>
+#include <thrift/lib/cpp2/async/ServerStream.h>
+
+using namespace apache::thrift;
+using namespace apache::thrift::detail::twowaybridge_detail;
+
+namespace {
+
+struct Consumer {
+  void consume() {
+    baton.post();
+  }
+  void canceled() {}
+  folly::Baton<> baton;
+};
+
+// Moves 'iters' messages between two threads the way stream bridges do: the
+// consumer waits for messages and takes them in batches.
+template <typename Message>
+void transfer(size_t iters, Message message) {
+  AtomicQueue<Consumer, Message> atomicQueue;
+  std::thread producer([&] {
+    for (size_t i = 0; i < iters; ++i) {
+      auto copy = message;
+      atomicQueue.push(std::move(copy));
+    }
+  });
+  size_t received = 0;
+  while (received < iters) {
+    Consumer consumer;
+    if (atomicQueue.wait(&consumer)) {
+      consumer.baton.wait();
+    }
+    for (auto queue = atomicQueue.getMessages(); !queue.empty();
+         queue.pop()) {
+      folly::doNotOptimizeAway(queue.front());
+      ++received;
+    }
+  }
+  producer.join();
+}
+
+#if FOLLY_HAS_COROUTINES
+class FirstResponseCallback
+    : public apache::thrift::detail::ClientStreamBridge::FirstResponseCallback {
+ public:
+  void onFirstResponse(
+      FirstResponsePayload&&,
+      apache::thrift::detail::ClientStreamBridge::ClientPtr ptr) override {
+    clientStreamBridge = std::move(ptr);
+    baton.post();
+  }
+  void onFirstResponseError(folly::exception_wrapper) override {
+    std::terminate();
+  }
+  apache::thrift::detail::ClientStreamBridge::ClientPtr clientStreamBridge;
+  folly::fibers::Baton baton;
+};
+
+folly::Try<StreamPayload> encode(folly::Try<size_t>&& i) {
+  if (i.hasValue()) {
+    return folly::Try<StreamPayload>(
+        StreamPayload{folly::IOBuf::copyBuffer(&*i, sizeof(*i)), {}});
+  } else if (i.hasException()) {
+    return folly::Try<StreamPayload>(i.exception());
+  }
+  return folly::Try<StreamPayload>();
+}
+
+folly::Try<size_t> decode(folly::Try<StreamPayload>&& i) {
+  if (i.hasValue()) {
+    return folly::Try<size_t>(i->payload->computeChainDataLength());
+  } else if (i.hasException()) {
+    return folly::Try<size_t>(i.exception());
+  }
+  return folly::Try<size_t>();
+}
+
+// Streams 'iters' items from a generator on a server thread to a client
+// thread, through both bridges and without a transport.
+void stream(size_t iters, int32_t bufferSize) {
+  folly::BenchmarkSuspender setup;
+  folly::ScopedEventBaseThread clientEb, serverEb;
+  FirstResponseCallback firstResponseCallback;
+  auto clientStreamBridge =
+      apache::thrift::detail::ClientStreamBridge::create(
+          &firstResponseCallback);
+  // The count is a parameter, which unlike a capture outlives the lambda
+  ServerStream<size_t> factory(
+      [](size_t count) -> folly::coro::AsyncGenerator<size_t&&> {
+        for (size_t i = 0; i < count; ++i) {
+          co_yield std::move(i);
+        }
+      }(iters));
+  factory(
+      FirstResponsePayload{nullptr, {}},
+      clientStreamBridge,
+      clientEb.getEventBase(),
+      serverEb.getEventBase(),
+      &encode);
+  firstResponseCallback.baton.wait();
+  ClientBufferedStream<size_t> clientStream(
+      std::move(firstResponseCallback.clientStreamBridge), &decode, bufferSize);
+
+  size_t received = 0;
+  setup.dismissing([&] {
+    std::move(clientStream).subscribeInline([&](folly::Try<size_t>&& next) {
+      if (next.hasValue()) {
+        ++received;
+      }
+    });
+  });
+  CHECK_EQ(iters, received);
+}
+#endif // FOLLY_HAS_COROUTINES
+
+} // namespace
+
+BENCHMARK(transfer_int, iters) {
+  transfer(iters, 42);
+}
+
+BENCHMARK(transfer_string, iters) {
+  transfer(iters, std::string(100, 'x'));
+}
+
+#if FOLLY_HAS_COROUTINES
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(stream_buffer_1, iters) {
+  stream(iters, 1);
+}
+
+BENCHMARK(stream_buffer_100, iters) {
+  stream(iters, 100);
+}
+#endif // FOLLY_HAS_COROUTINES
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -112,6 +112,72 @@ TEST(AtomicQueueTest, Canceled) {
   EXPECT_TRUE(atomicQueue.isClosed());
 }
 
+TEST(AtomicQueueTest, ReusesNodes) {
+  struct Consumer {
+    void consume() {}
+    void canceled() {}
+  };
+  detail::twowaybridge_detail::AtomicQueue<Consumer, int> atomicQueue;
+  atomicQueue.push(1);
+  int* first;
+  {
+    auto q = atomicQueue.getMessages();
+    first = &q.front();
+    q.pop();
+  }
+  atomicQueue.push(2);
+  auto q = atomicQueue.getMessages();
+  EXPECT_EQ(first, &q.front());
+  EXPECT_EQ(2, q.front());
+}
+
+TEST(AtomicQueueTest, QueueOutlivesAtomicQueue) {
+  struct Consumer {
+    void consume() {}
+    void canceled() {}
+  };
+  detail::twowaybridge_detail::Queue<std::unique_ptr<int>> q;
+  {
+    detail::twowaybridge_detail::AtomicQueue<Consumer, std::unique_ptr<int>>
+        atomicQueue;
+    atomicQueue.push(std::make_unique<int>(1));
+    atomicQueue.push(std::make_unique<int>(2));
+    q = atomicQueue.getMessages();
+    atomicQueue.push(std::make_unique<int>(3));
+  }
+  EXPECT_EQ(1, *q.front());
+  q.pop();
+  EXPECT_EQ(2, *q.front());
+}
+
+TEST(AtomicQueueTest, OrderedOnAccess) {
+  struct Consumer {
+    void consume() {}
+    void canceled() {}
+  };
+  detail::twowaybridge_detail::AtomicQueue<Consumer, std::unique_ptr<int>>
+      atomicQueue;
+  for (int i = 0; i < 3; ++i) {
+    atomicQueue.push(std::make_unique<int>(i));
+  }
+  // Moving the queue before reading it keeps the order
+  auto taken = atomicQueue.getMessages();
+  auto q = std::move(taken);
+  EXPECT_TRUE(taken.empty());
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_FALSE(q.empty());
+    EXPECT_EQ(i, *q.front());
+    q.pop();
+  }
+  EXPECT_TRUE(q.empty());
+
+  // Queues dropped unread free their messages
+  atomicQueue.push(std::make_unique<int>(3));
+  atomicQueue.push(std::make_unique<int>(4));
+  atomicQueue.getMessages();
+  EXPECT_TRUE(atomicQueue.getMessages().empty());
+}
+
 TEST(AtomicQueueTest, Stress) {
   struct Consumer {
     void consume() {
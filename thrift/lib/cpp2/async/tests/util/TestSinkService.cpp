@@ -160,5 +160,25 @@ TestSinkService::rangeChunkTimeout() {
       .setChunkTimeout(std::chrono::milliseconds(200));
 }
 
+apache::thrift::SinkConsumer<int32_t, bool> TestSinkService::rangeBatched(
+    int32_t from,
+    int32_t to) {
+  return apache::thrift::SinkConsumer<int32_t, bool>{
+      [this, from, to](folly::coro::AsyncGenerator<int32_t&&> gen)
+          -> folly::coro::Task<bool> {
+        int32_t i = from;
+        while (auto item = co_await gen.next()) {
+          EXPECT_EQ(i++, *item);
+          batchedItemReceived.post();
+        }
+        EXPECT_EQ(i, to + 1);
+        co_return true;
+      },
+      2 /* buffer size */
+  }
+      .setBatchBytes(16)
+      .setBufferBytes(64);
+}
+
 } // namespace testservice
 } // namespace testutil
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <folly/experimental/coro/Baton.h>
+
 #include <thrift/lib/cpp2/async/Sink.h>
 #include <thrift/lib/cpp2/async/tests/util/gen-cpp2/TestSinkService.h>
 
@@ -51,6 +53,13 @@ class TestSinkService : public TestSinkServiceSvIf {
 
   apache::thrift::SinkConsumer<int32_t, bool> rangeChunkTimeout() override;
 
+  apache::thrift::SinkConsumer<int32_t, bool> rangeBatched(
+      int32_t from,
+      int32_t to) override;
+
+  // Posted by rangeBatched as each item is received
+  folly::coro::Baton batchedItemReceived;
+
  private:
   bool sinkUnsubscribed_{false};
 };
@@ -34,4 +34,6 @@ service TestSinkService {
   bool isSinkUnSubscribed();
 
   sink<i32, bool> rangeChunkTimeout();
+  // Same as range, with the sink in throughput mode
+  sink<i32, bool> rangeBatched(1: i32 from, 2: i32 to);
 }
@@ -59,6 +59,8 @@ class TestSetup {
       folly::Function<folly::coro::Task<void>(
           testutil::testservice::TestSinkServiceAsyncClient&)> callMe);
 
+  std::shared_ptr<testutil::testservice::TestSinkService> handler_;
+
  private:
   int numIOThreads_{1};
   int numWorkerThreads_{1};
@@ -66,7 +68,6 @@ class TestSetup {
   std::shared_ptr<folly::IOExecutor> ioThread_{
       std::make_shared<folly::ScopedEventBaseThread>()};
   std::unique_ptr<ThriftServer> server_;
-  std::shared_ptr<testutil::testservice::TestSinkService> handler_;
 };
 
 } // namespace thrift
@@ -16,6 +16,9 @@
 
 #include <thrift/lib/cpp2/frozen/Frozen.h>
 
+#include <array>
+
+#include <folly/compression/Compression.h>
 #include <folly/io/Cursor.h>
 #include <folly/io/IOBuf.h>
 
@@ -73,6 +76,47 @@ void LayoutBase::clear() {
   inlined = false;
 }
 
+size_t LayoutRoot::layoutStringDistance(
+    size_t origin,
+    folly::StringPiece bytes,
+    size_t align) {
+  if (!options_.dedupStrings) {
+    return layoutBytesDistance(origin, bytes.size(), align);
+  }
+  // Distances can't be negative: only copies laid out after the field can be
+  // reused, otherwise a new copy is made and used for the next ones.
+  auto it = strings_.find(bytes);
+  if (it != strings_.end() && it->second >= origin) {
+    return it->second - origin;
+  }
+  size_t dist = layoutBytesDistance(origin, bytes.size(), align);
+  strings_[bytes] = origin + dist;
+  return dist;
+}
+
+bool FreezeRoot::findString(
+    const byte* origin,
+    folly::StringPiece bytes,
+    size_t& dist) {
+  if (!options_.dedupStrings) {
+    return false;
+  }
+  ++stats_.strings;
+  stats_.stringBytes += bytes.size();
+  auto it = strings_.find(bytes);
+  if (it == strings_.end()) {
+    return false;
+  }
+  int64_t offset = offsetBetween(origin, it->second);
+  if (offset < 0) {
+    return false;
+  }
+  dist = offset;
+  ++stats_.dedupedStrings;
+  stats_.dedupedBytes += bytes.size();
+  return true;
+}
+
 void ByteRangeFreezer::doAppendBytes(
     byte* origin,
     size_t n,
@@ -148,6 +192,110 @@ void BufferHelpers<std::unique_ptr<folly::IOBuf>>::thawTo(
   dst = folly::IOBuf::copyBuffer(src.begin(), src.size());
 }
 
+namespace {
+
+folly::io::CodecType defaultCodec() {
+  for (auto type : {folly::io::CodecType::ZSTD, folly::io::CodecType::ZLIB}) {
+    if (folly::io::hasCodec(type)) {
+      return type;
+    }
+  }
+  return folly::io::CodecType::NO_COMPRESSION;
+}
+
+// Last blocks decompressed by a thread, identified by their codec and their
+// compressed bytes. Addresses may be reused once a file is unmapped, so hits
+// compare all the compressed bytes, which costs far less than decompressing.
+struct BlockCache {
+  struct Entry {
+    bool valid{false};
+    int32_t codec{0};
+    std::string compressed;
+    std::string data;
+
+    bool matches(
+        int32_t type,
+        folly::StringPiece bytes,
+        size_t uncompressedSize) const {
+      return valid && codec == type && data.size() == uncompressedSize &&
+          folly::StringPiece(compressed) == bytes;
+    }
+  };
+
+  folly::io::Codec& codec(int32_t type) {
+    auto& codec = codecs[type];
+    if (!codec) {
+      codec = folly::io::getCodec(static_cast<folly::io::CodecType>(type));
+    }
+    return *codec;
+  }
+
+  std::array<Entry, 4> entries;
+  size_t next{0};
+  std::unordered_map<int32_t, std::unique_ptr<folly::io::Codec>> codecs;
+};
+
+} // namespace
+
+CompressedStrings compressStrings(
+    const std::vector<folly::StringPiece>& strings,
+    size_t blockSize) {
+  CompressedStrings ret;
+  auto type = defaultCodec();
+  auto codec = folly::io::getCodec(type);
+  ret.codec = static_cast<int32_t>(type);
+  ret.offsets.reserve(strings.size() + 1);
+
+  std::string block;
+  uint64_t offset = 0;
+  auto flush = [&] {
+    if (!block.empty()) {
+      ret.blocks.push_back(codec->compress(block));
+      block.clear();
+    }
+  };
+  for (auto str : strings) {
+    ret.offsets.push_back(offset);
+    if (str.empty()) {
+      continue;
+    }
+    if (!block.empty() && block.size() + str.size() > blockSize) {
+      flush();
+    }
+    if (block.empty()) {
+      ret.blockStarts.push_back(offset);
+    }
+    block.append(str.data(), str.size());
+    offset += str.size();
+  }
+  flush();
+  ret.offsets.push_back(offset);
+  ret.blockStarts.push_back(offset);
+  return ret;
+}
+
+folly::StringPiece decompressBlock(
+    int32_t codec,
+    folly::StringPiece compressed,
+    size_t uncompressedSize) {
+  static thread_local BlockCache cache;
+  for (const auto& entry : cache.entries) {
+    if (entry.matches(codec, compressed, uncompressedSize)) {
+      return entry.data;
+    }
+  }
+  auto& entry = cache.entries[cache.next];
+  cache.next = (cache.next + 1) % cache.entries.size();
+  // Not a hit for another block while decompressing throws
+  entry.valid = false;
+  entry.data =
+      cache.codec(codec).uncompress(compressed, uint64_t(uncompressedSize));
+  entry.codec = codec;
+  entry.compressed.assign(compressed.data(), compressed.size());
+  entry.valid = true;
+  return entry.data;
+}
+
 } // namespace detail
 } // namespace frozen
 } // namespace thrift
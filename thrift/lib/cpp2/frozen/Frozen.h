@@ -589,12 +589,39 @@ class FieldCycleHolder {
   std::unordered_map<std::type_index, SharedField> cyclicFields_;
 };
 
+/**
+ * Options changing how objects are frozen. Data frozen with any options is
+ * read the same way, with the same layout.
+ */
+struct FreezeOptions {
+  /**
+   * Identical strings are only stored once when possible: later occurrences
+   * point to the bytes of an earlier one through their usual distance field.
+   * Freezing is slower and uses memory for a table of the strings seen.
+   */
+  bool dedupStrings{false};
+};
+
+/**
+ * What string deduplication saved, filled when freezing with
+ * FreezeOptions::dedupStrings.
+ */
+struct FreezeStats {
+  // Non-empty contiguous strings frozen, and their total size
+  size_t strings{0};
+  size_t stringBytes{0};
+  // Strings pointing to an existing copy, and the bytes not written for them
+  size_t dedupedStrings{0};
+  size_t dedupedBytes{0};
+};
+
 /**
  * LayoutRoot calculates the layout necessary to store a given object,
  * recursively. The logic of layout should closely match that of freezing.
  */
 class LayoutRoot : public FieldCycleHolder {
   LayoutRoot() {}
+  explicit LayoutRoot(const FreezeOptions& options) : options_(options) {}
   /**
    * Lays out a given object from the root, repeatedly running layout until a
    * fixed point is reached.
@@ -612,6 +639,7 @@ class LayoutRoot : public FieldCycleHolder {
       // clear the trackers to restart graph traversal
       sharedFields_.clear();
       positions_.clear();
+      strings_.clear();
     }
     assert(false); // layout should always reach a fixed point.
     return 0;
@@ -637,6 +665,16 @@ class LayoutRoot : public FieldCycleHolder {
     return LayoutRoot().doLayout(root, layout, resizes);
   }
 
+  /**
+   * Same as above, for freezing with the given options.
+   */
+  template <class T>
+  static size_t
+  layout(const T& root, Layout<T>& layout, const FreezeOptions& options) {
+    size_t resizes;
+    return LayoutRoot(options).doLayout(root, layout, resizes);
+  }
+
   /**
    * Adjust 'layout' so it is sufficient for freezing root, providing upper
    * bound storage size estimate and indication of whether the layout changed.
@@ -722,6 +760,14 @@ class LayoutRoot : public FieldCycleHolder {
     return worstCaseDistance;
   }
 
+  /**
+   * Same as layoutBytesDistance() for the contents of a string, which may
+   * point to an identical string laid out earlier. Must make the same
+   * decisions as FreezeRoot::findString().
+   */
+  size_t
+  layoutStringDistance(size_t origin, folly::StringPiece bytes, size_t align);
+
   template <typename T>
   void shareField(const T* ptr, std::shared_ptr<Field<T>> field) {
     assert(sharedFieldOf(ptr) == nullptr);
@@ -752,11 +798,30 @@ class LayoutRoot : public FieldCycleHolder {
     return it == positions_.end() ? nullptr : &it->second;
   }
 
+  /**
+   * Value computed from '*ptr' on the first layout pass, kept for the next
+   * passes which would compute it again.
+   */
+  template <typename V, typename T, typename F>
+  const V& memoize(const T* ptr, F&& compute) {
+    auto key = reinterpret_cast<uintptr_t>(ptr);
+    auto& value = memos_[key];
+    if (!value) {
+      value = std::make_shared<V>(compute());
+    }
+    return *static_cast<const V*>(value.get());
+  }
+
  protected:
   bool resized_;
   size_t cursor_;
   std::unordered_map<uintptr_t, std::shared_ptr<FieldBase>> sharedFields_;
   std::unordered_map<uintptr_t, LayoutPosition> positions_;
+  const FreezeOptions options_{};
+  // Position of the last copy of each string, when deduplicating
+  std::unordered_map<folly::StringPiece, size_t> strings_;
+  // Kept across passes, unlike the trackers above
+  std::unordered_map<uintptr_t, std::shared_ptr<void>> memos_;
 }; // namespace frozen
 
 /**
@@ -790,6 +855,9 @@ class LayoutTypeMismatchException : public std::logic_error {
  */
 class FreezeRoot {
  protected:
+  FreezeRoot() {}
+  explicit FreezeRoot(const FreezeOptions& options) : options_(options) {}
+
   std::unordered_map<uintptr_t, FreezePosition> positions_;
 
   template <class T>
@@ -857,6 +925,25 @@ class FreezeRoot {
     doAppendBytes(origin, n, range, distance, align);
   }
 
+  /**
+   * When deduplicating strings, looks for a copy of 'bytes' already frozen
+   * after 'origin', setting its distance from 'origin' if found.
+   */
+  bool findString(const byte* origin, folly::StringPiece bytes, size_t& dist);
+
+  /**
+   * Records that a copy of 'bytes' was frozen at 'at'.
+   */
+  void internString(folly::StringPiece bytes, const byte* at) {
+    if (options_.dedupStrings) {
+      strings_[bytes] = at;
+    }
+  }
+
+  const FreezeStats& getStats() const {
+    return stats_;
+  }
+
  private:
   virtual void doAppendBytes(
       byte* origin,
@@ -864,6 +951,19 @@ class FreezeRoot {
       folly::MutableByteRange& range,
       size_t& distance,
       size_t align) = 0;
+
+  /**
+   * Offset of 'target' from 'origin' in the frozen data, both previously
+   * appended.
+   */
+  virtual int64_t offsetBetween(const byte* origin, const byte* target) const {
+    return target - origin;
+  }
+
+  const FreezeOptions options_{};
+  FreezeStats stats_;
+  // Last copy of each string, when deduplicating
+  std::unordered_map<folly::StringPiece, const byte*> strings_;
 };
 
 inline size_t alignBy(size_t start, size_t alignment) {
@@ -875,7 +975,10 @@ inline size_t alignBy(size_t start, size_t alignment) {
  */
 class ByteRangeFreezer final : public FreezeRoot {
  protected:
-  explicit ByteRangeFreezer(folly::MutableByteRange& write) : write_(write) {}
+  explicit ByteRangeFreezer(
+      folly::MutableByteRange& write,
+      const FreezeOptions& options = FreezeOptions())
+      : FreezeRoot(options), write_(write) {}
 
  public:
   template <class T>
@@ -888,6 +991,25 @@ class ByteRangeFreezer final : public FreezeRoot {
     return view;
   }
 
+  /**
+   * Freezes with the options the layout was computed with, optionally
+   * reporting what deduplication saved.
+   */
+  template <class T>
+  static typename Layout<T>::View freeze(
+      const Layout<T>& layout,
+      const T& root,
+      folly::MutableByteRange& write,
+      const FreezeOptions& options,
+      FreezeStats* stats = nullptr) {
+    ByteRangeFreezer freezer(write, options);
+    auto view = freezer.doFreeze(layout, root);
+    if (stats) {
+      *stats = freezer.getStats();
+    }
+    return view;
+  }
+
  private:
   void doAppendBytes(
       byte* origin,
@@ -1076,3 +1198,5 @@ using View = typename Layout<T>::View;
 #include <thrift/lib/cpp2/frozen/FrozenAssociative-inl.h> // @nolint
 // depends on Integral
 #include <thrift/lib/cpp2/frozen/FrozenEnum-inl.h> // @nolint
+// depends on Range and String
+#include <thrift/lib/cpp2/frozen/FrozenCompressed-inl.h> // @nolint
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// IWYU pragma: private, include "thrift/lib/cpp2/frozen/Frozen.h"
+
+#include <algorithm>
+
+#include <thrift/lib/cpp2/frozen/HintTypes.h>
+
+namespace apache {
+namespace thrift {
+namespace frozen {
+
+namespace detail {
+
+/**
+ * Strings concatenated into blocks of about blockSize bytes, each compressed
+ * on its own. Strings never span blocks, only strings longer than blockSize
+ * have a block of their own.
+ */
+struct CompressedStrings {
+  int32_t codec{0};
+  std::vector<std::string> blocks;
+  // Offset of each block in the concatenation of the strings, followed by the
+  // total size.
+  std::vector<uint64_t> blockStarts;
+  // Offset of each string in the concatenation, followed by the total size.
+  std::vector<uint64_t> offsets;
+};
+
+CompressedStrings compressStrings(
+    const std::vector<folly::StringPiece>& strings,
+    size_t blockSize);
+
+/**
+ * Decompresses a block, through a small cache of the calling thread keyed by
+ * the codec and the compressed bytes. The result is valid until the next call
+ * from the same thread.
+ */
+folly::StringPiece decompressBlock(
+    int32_t codec,
+    folly::StringPiece compressed,
+    size_t uncompressedSize);
+
+/**
+ * Layout for VectorCompressed, which only keeps the offsets of the strings
+ * uncompressed.
+ */
+template <class T, size_t BlockSize>
+struct CompressedStringsLayout : public LayoutBase {
+  typedef LayoutBase Base;
+  typedef CompressedStringsLayout LayoutSelf;
+  typedef typename T::value_type Item;
+  static_assert(IsString<Item>::value, "Only lists of strings are supported");
+
+  Field<int32_t> codecField;
+  Field<std::vector<std::string>> blocksField;
+  Field<std::vector<uint64_t>> blockStartsField;
+  Field<std::vector<uint64_t>> offsetsField;
+
+  CompressedStringsLayout()
+      : LayoutBase(typeid(T)),
+        codecField(1, "codec"),
+        blocksField(2, "blocks"),
+        blockStartsField(3, "blockStarts"),
+        offsetsField(4, "offsets") {}
+
+  static CompressedStrings compress(const T& o) {
+    std::vector<folly::StringPiece> strings;
+    strings.reserve(o.size());
+    for (const auto& item : o) {
+      strings.emplace_back(item.data(), item.size());
+    }
+    return compressStrings(strings, BlockSize);
+  }
+
+  FieldPosition maximize() {
+    FieldPosition pos = startFieldPosition();
+    FROZEN_MAXIMIZE_FIELD(codec);
+    FROZEN_MAXIMIZE_FIELD(blocks);
+    FROZEN_MAXIMIZE_FIELD(blockStarts);
+    FROZEN_MAXIMIZE_FIELD(offsets);
+    return pos;
+  }
+
+  // Compressing is the main cost of freezing, only the first pass does it
+  FieldPosition layout(LayoutRoot& root, const T& o, LayoutPosition self) {
+    const auto& compressed =
+        root.memoize<CompressedStrings>(&o, [&] { return compress(o); });
+    FieldPosition pos = startFieldPosition();
+    pos = root.layoutField(self, pos, codecField, compressed.codec);
+    pos = root.layoutField(self, pos, blocksField, compressed.blocks);
+    pos = root.layoutField(self, pos, blockStartsField, compressed.blockStarts);
+    pos = root.layoutField(self, pos, offsetsField, compressed.offsets);
+    return pos;
+  }
+
+  void freeze(FreezeRoot& root, const T& o, FreezePosition self) const {
+    auto compressed = compress(o);
+    root.freezeField(self, codecField, compressed.codec);
+    root.freezeField(self, blocksField, compressed.blocks);
+    root.freezeField(self, blockStartsField, compressed.blockStarts);
+    root.freezeField(self, offsetsField, compressed.offsets);
+  }
+
+  void thaw(ViewPosition self, T& out) const {
+    auto v = view(self);
+    out.clear();
+    out.reserve(v.size());
+    for (size_t i = 0; i < v.size(); ++i) {
+      auto bytes = v.get(i);
+      out.emplace_back(bytes.begin(), bytes.end());
+    }
+  }
+
+  class View : public ViewBase<View, LayoutSelf, T> {
+    typedef typename Layout<std::vector<std::string>>::View BlocksView;
+    typedef typename Layout<std::vector<uint64_t>>::View OffsetsView;
+
+   public:
+    View() {}
+    View(const LayoutSelf* layout, ViewPosition self)
+        : ViewBase<View, LayoutSelf, T>(layout, self),
+          blocks_(layout->blocksField.layout.view(
+              self(layout->blocksField.pos))),
+          blockStarts_(layout->blockStartsField.layout.view(
+              self(layout->blockStartsField.pos))),
+          offsets_(layout->offsetsField.layout.view(
+              self(layout->offsetsField.pos))) {
+      thawField(self, layout->codecField, codec_);
+    }
+
+    size_t size() const {
+      return offsets_.empty() ? 0 : offsets_.size() - 1;
+    }
+
+    bool empty() const {
+      return size() == 0;
+    }
+
+    /**
+     * Bytes of the string at 'index', valid until the calling thread reads
+     * another compressed string.
+     */
+    folly::StringPiece get(size_t index) const {
+      uint64_t begin = offsets_[index];
+      uint64_t end = offsets_[index + 1];
+      if (begin == end) {
+        return folly::StringPiece();
+      }
+      // Last block starting at or before the string
+      size_t block =
+          std::upper_bound(blockStarts_.begin(), blockStarts_.end(), begin) -
+          blockStarts_.begin() - 1;
+      uint64_t blockStart = blockStarts_[block];
+      auto bytes = decompressBlock(
+          codec_, blocks_[block], blockStarts_[block + 1] - blockStart);
+      return bytes.subpiece(begin - blockStart, end - begin);
+    }
+
+    std::string operator[](size_t index) const {
+      return get(index).str();
+    }
+
+   private:
+    int32_t codec_{0};
+    BlocksView blocks_;
+    OffsetsView blockStarts_;
+    OffsetsView offsets_;
+  };
+
+  View view(ViewPosition self) const {
+    return View(this, self);
+  }
+
+  void print(std::ostream& os, int level) const final {
+    LayoutBase::print(os, level);
+    os << "compressed " << folly::demangle(type.name());
+    codecField.print(os, level + 1);
+    blocksField.print(os, level + 1);
+    blockStartsField.print(os, level + 1);
+    offsetsField.print(os, level + 1);
+  }
+
+  void clear() final {
+    codecField.clear();
+    blocksField.clear();
+    blockStartsField.clear();
+    offsetsField.clear();
+  }
+
+  FROZEN_SAVE_INLINE(FROZEN_SAVE_FIELD(codec) FROZEN_SAVE_FIELD(blocks)
+                         FROZEN_SAVE_FIELD(blockStarts)
+                             FROZEN_SAVE_FIELD(offsets))
+
+  FROZEN_LOAD_INLINE(FROZEN_LOAD_FIELD(codec, 1) FROZEN_LOAD_FIELD(blocks, 2)
+                         FROZEN_LOAD_FIELD(blockStarts, 3)
+                             FROZEN_LOAD_FIELD(offsets, 4))
+};
+
+} // namespace detail
+
+template <class T, size_t BlockSize>
+struct Layout<VectorCompressed<T, BlockSize>>
+    : public detail::
+          CompressedStringsLayout<VectorCompressed<T, BlockSize>, BlockSize> {};
+
+} // namespace frozen
+} // namespace thrift
+} // namespace apache
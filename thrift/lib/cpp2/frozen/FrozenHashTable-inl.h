@@ -301,6 +301,13 @@ struct HashTableLayout : public ArrayLayout<T, Item> {
       return find(key) == this->end() ? 0 : 1;
     }
 
+    /**
+     * Bytes read by every lookup, worth paging in first: the sparse table.
+     */
+    void indexBytes(std::vector<folly::ByteRange>& out) const {
+      out.push_back(table_.bytes());
+    }
+
     T thaw() const {
       T ret;
       static_cast<const HashTableLayout*>(this->layout_)
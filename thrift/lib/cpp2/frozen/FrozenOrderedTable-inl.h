@@ -178,6 +178,22 @@ struct SortedTableLayout : public ArrayLayout<T, Item> {
       return find(key) == this->end() ? 0 : 1;
     }
 
+    /**
+     * Bytes read by most lookups, worth paging in first: the items visited by
+     * the first 'levels' steps of the binary search.
+     */
+    void indexBytes(std::vector<folly::ByteRange>& out, size_t levels = 12)
+        const {
+      size_t n = this->size();
+      for (size_t level = 0; level < levels && (size_t(1) << level) <= n;
+           ++level) {
+        size_t steps = size_t(1) << level;
+        for (size_t k = 0; k < steps; ++k) {
+          out.push_back(this->itemBytes(n * (2 * k + 1) / (2 * steps)));
+        }
+      }
+    }
+
     T thaw() const {
       T ret;
       static_cast<const SortedTableLayout*>(this->layout_)
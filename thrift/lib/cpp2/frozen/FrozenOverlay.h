@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include <folly/Optional.h>
+#include <thrift/lib/cpp2/frozen/FrozenUtil.h>
+
+namespace apache {
+namespace thrift {
+namespace frozen {
+
+/**
+ * A frozen map with a small mutable delta on top of it, so that a few keys can
+ * be updated without freezing the whole map again.
+ *
+ * Map is the thawed type of the base, a hash map (e.g. std::unordered_map) or
+ * an ordered one (std::map). Lookups check the delta first, which holds the
+ * keys inserted or replaced since the base was frozen and tombstones for the
+ * erased ones. Values are returned thawed, since they may come from either.
+ *
+ * Once the delta grows, compactToFile() freezes the merged map, typically on a
+ * copy of the overlay in a background thread. Loading the result with
+ * rebase() then drops the compacted part of the delta.
+ *
+ * Like standard containers, an overlay isn't synchronized: concurrent updates
+ * or updates concurrent with lookups need external locking. The base is
+ * immutable and shared by copies.
+ */
+template <class Map>
+class FrozenOverlay {
+ public:
+  using key_type = typename Map::key_type;
+  using mapped_type = typename Map::mapped_type;
+  using Base = MappedFrozen<Map>;
+
+  explicit FrozenOverlay(std::shared_ptr<const Base> base)
+      : base_(std::move(base)) {
+    if (!base_) {
+      throw std::invalid_argument("FrozenOverlay needs a base");
+    }
+  }
+
+  const std::shared_ptr<const Base>& base() const {
+    return base_;
+  }
+
+  /**
+   * Number of inserted, replaced or erased keys since the base was frozen.
+   */
+  size_t deltaSize() const {
+    return delta_.size();
+  }
+
+  folly::Optional<mapped_type> find(const key_type& key) const {
+    auto it = delta_.find(key);
+    if (it != delta_.end()) {
+      return it->second;
+    }
+    auto found = base_->find(key);
+    if (found == base_->end()) {
+      return folly::none;
+    }
+    return std::move(found.thaw().second);
+  }
+
+  bool contains(const key_type& key) const {
+    auto it = delta_.find(key);
+    if (it != delta_.end()) {
+      return it->second.hasValue();
+    }
+    return base_->find(key) != base_->end();
+  }
+
+  /**
+   * Number of keys, which takes a lookup in the base per key of the delta.
+   */
+  size_t size() const {
+    size_t size = base_->size();
+    for (const auto& entry : delta_) {
+      bool inBase = base_->find(entry.first) != base_->end();
+      if (entry.second && !inBase) {
+        ++size;
+      } else if (!entry.second && inBase) {
+        --size;
+      }
+    }
+    return size;
+  }
+
+  void upsert(const key_type& key, mapped_type value) {
+    delta_[key] = std::move(value);
+  }
+
+  /**
+   * Returns whether the key was present.
+   */
+  bool erase(const key_type& key) {
+    bool inBase = base_->find(key) != base_->end();
+    auto it = delta_.find(key);
+    bool present = it != delta_.end() ? it->second.hasValue() : inBase;
+    if (inBase) {
+      delta_[key] = folly::none;
+    } else if (it != delta_.end()) {
+      delta_.erase(it);
+    }
+    return present;
+  }
+
+  /**
+   * Calls f(key, value) for every key, in key order for ordered maps.
+   */
+  template <class F>
+  void forEach(F&& f) const {
+    forEachImpl(f, IsOrderedMap<Map>());
+  }
+
+  /**
+   * Returns the thawed contents of the overlay.
+   */
+  Map merge() const {
+    Map map;
+    forEach([&](const key_type& key, const mapped_type& value) {
+      map.emplace(key, value);
+    });
+    return map;
+  }
+
+  /**
+   * Replaces the base by 'base', frozen from 'compacted' (a copy of this
+   * overlay), and drops the entries of the delta it includes. Entries changed
+   * since the copy was made are kept.
+   */
+  void rebase(
+      std::shared_ptr<const Base> base,
+      const FrozenOverlay& compacted) {
+    if (!base) {
+      throw std::invalid_argument("FrozenOverlay needs a base");
+    }
+    for (const auto& entry : compacted.delta_) {
+      auto it = delta_.find(entry.first);
+      if (it != delta_.end() && it->second == entry.second) {
+        delta_.erase(it);
+      }
+    }
+    base_ = std::move(base);
+  }
+
+ private:
+  using Delta = typename std::conditional<
+      IsOrderedMap<Map>::value,
+      std::map<key_type, folly::Optional<mapped_type>>,
+      std::unordered_map<key_type, folly::Optional<mapped_type>>>::type;
+
+  // Hash map: base keys missing from the delta, then the delta
+  template <class F>
+  void forEachImpl(F& f, std::false_type) const {
+    for (auto it = base_->begin(); it != base_->end(); ++it) {
+      auto item = it.thaw();
+      if (delta_.find(item.first) == delta_.end()) {
+        f(item.first, item.second);
+      }
+    }
+    for (const auto& entry : delta_) {
+      if (entry.second) {
+        f(entry.first, *entry.second);
+      }
+    }
+  }
+
+  // Ordered map: merges the base and the delta, which are both sorted
+  template <class F>
+  void forEachImpl(F& f, std::true_type) const {
+    auto it = base_->begin();
+    folly::Optional<std::pair<key_type, mapped_type>> item;
+    auto nextItem = [&] {
+      item.clear();
+      if (it != base_->end()) {
+        item.emplace(it.thaw());
+        ++it;
+      }
+    };
+    nextItem();
+    for (const auto& entry : delta_) {
+      for (; item && item->first < entry.first; nextItem()) {
+        f(item->first, item->second);
+      }
+      if (item && !(entry.first < item->first)) {
+        nextItem(); // replaced or erased by the delta
+      }
+      if (entry.second) {
+        f(entry.first, *entry.second);
+      }
+    }
+    for (; item; nextItem()) {
+      f(item->first, item->second);
+    }
+  }
+
+  std::shared_ptr<const Base> base_;
+  // folly::none for erased keys
+  Delta delta_;
+};
+
+/**
+ * Freezes the contents of an overlay to a file, to be loaded as the base of a
+ * new overlay. Meant to run in the background on a copy of the overlay.
+ */
+template <class Map>
+void compactToFile(const FrozenOverlay<Map>& overlay, folly::File file) {
+  freezeToFile(overlay.merge(), std::move(file));
+}
+
+} // namespace frozen
+} // namespace thrift
+} // namespace apache
@@ -175,6 +175,16 @@ struct ArrayLayout : public LayoutBase {
       return this->layout_->itemField.layout;
     }
 
+    // Bytes taken by the first 'n' items. Bit-packed items may end mid-byte,
+    // the result is then rounded up if 'end', down otherwise.
+    size_t bytesOffset(size_t n, bool end) const {
+      const auto& layout = itemLayout();
+      if (layout.size) {
+        return layout.size * n;
+      }
+      return (layout.bits * n + (end ? 7 : 0)) / 8;
+    }
+
    public:
     typedef ItemView value_type;
     typedef ItemView reference_type;
@@ -231,6 +241,23 @@ struct ArrayLayout : public LayoutBase {
       return {data, data + count_};
     }
 
+    /**
+     * Storage of the items themselves, without any out of line data they
+     * point to (e.g. the bytes of strings).
+     */
+    folly::ByteRange bytes() const {
+      return {data_, data_ + bytesOffset(count_, true)};
+    }
+
+    /**
+     * Storage of the item at 'index', see bytes().
+     */
+    folly::ByteRange itemBytes(size_t index) const {
+      assert(index < count_);
+      return {data_ + bytesOffset(index, false),
+              data_ + bytesOffset(index + 1, true)};
+    }
+
    private:
     /**
      * Simple iterator on a range, with additional '.thaw()' member for thawing
@@ -39,6 +39,12 @@ struct BufferHelpers {
   static void thawTo(folly::Range<const Item*> src, T& dst) {
     dst.assign(src.begin(), src.end());
   }
+  // Contents as a single range of bytes, used to deduplicate strings
+  static bool contiguousBytes(const T& src, folly::StringPiece& bytes) {
+    bytes.reset(
+        reinterpret_cast<const char*>(src.data()), src.size() * sizeof(Item));
+    return true;
+  }
 };
 
 template <>
@@ -50,6 +56,11 @@ struct BufferHelpers<std::unique_ptr<folly::IOBuf>> {
       const std::unique_ptr<folly::IOBuf>& src,
       folly::MutableByteRange dst);
   static void thawTo(folly::ByteRange src, std::unique_ptr<folly::IOBuf>& dst);
+  static bool contiguousBytes(
+      const std::unique_ptr<folly::IOBuf>&,
+      folly::StringPiece&) {
+    return false;
+  }
 };
 
 /**
@@ -81,8 +92,10 @@ struct StringLayout : public LayoutBase {
     if (!n) {
       return pos;
     }
-    size_t dist =
-        root.layoutBytesDistance(self.start, n * sizeof(Item), alignof(Item));
+    folly::StringPiece bytes;
+    size_t dist = Helper::contiguousBytes(o, bytes)
+        ? root.layoutStringDistance(self.start, bytes, alignof(Item))
+        : root.layoutBytesDistance(self.start, n * sizeof(Item), alignof(Item));
     pos = root.layoutField(self, pos, distanceField, dist);
     pos = root.layoutField(self, pos, countField, n);
     return pos;
@@ -90,13 +103,23 @@ struct StringLayout : public LayoutBase {
 
   void freeze(FreezeRoot& root, const T& o, FreezePosition self) const {
     size_t n = Helper::size(o);
-    folly::MutableByteRange range;
+    folly::StringPiece bytes;
+    bool contiguous = n && Helper::contiguousBytes(o, bytes);
     size_t dist;
+    if (contiguous && root.findString(self.start, bytes, dist)) {
+      root.freezeField(self, distanceField, dist);
+      root.freezeField(self, countField, n);
+      return;
+    }
+    folly::MutableByteRange range;
     root.appendBytes(self.start, n * sizeof(Item), range, dist, alignof(Item));
     root.freezeField(self, distanceField, dist);
     root.freezeField(self, countField, n);
     folly::Range<Item*> target(reinterpret_cast<Item*>(range.begin()), n);
     Helper::copyTo(o, target);
+    if (contiguous) {
+      root.internString(bytes, range.begin());
+    }
   }
 
   void thaw(ViewPosition self, T& out) const {
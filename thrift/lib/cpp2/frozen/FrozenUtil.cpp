@@ -16,15 +16,25 @@
 
 #include <thrift/lib/cpp2/frozen/FrozenUtil.h>
 
+#include <algorithm>
 #include <cstdlib>
 
 #include <folly/Conv.h>
+#include <folly/hash/Hash.h>
+#include <folly/hash/SpookyHashV2.h>
+#include <folly/io/IOBuf.h>
+#include <folly/portability/SysMman.h>
+#include <folly/portability/SysResource.h>
+#include <folly/portability/Unistd.h>
+#include <thrift/lib/cpp2/protocol/CompactProtocol.h>
 
 // clang-format off
 DEFINE_bool(thrift_frozen_util_disable_mlock, false,
     "Don't mlock() files mmaped by mapFrozen() call.");
 DEFINE_bool(thrift_frozen_util_mlock_on_fault, false,
     "Use mlock2(MLOCK_ONFAULT) instead of mlock().");
+DEFINE_int32(thrift_frozen_layout_cache_size, 1024,
+    "Number of layouts mapFrozen() keeps for reuse, 0 to disable.");
 // clang-format on
 
 namespace apache {
@@ -40,6 +50,190 @@ FrozenFileForwardIncompatible::FrozenFileForwardIncompatible(int fileVersion)
           " are supported.")),
       fileVersion_(fileVersion) {}
 
+LayoutCache& LayoutCache::instance() {
+  static auto* cache = new LayoutCache(
+      std::max(0, FLAGS_thrift_frozen_layout_cache_size));
+  return *cache;
+}
+
+LayoutCache::LayoutCache(size_t maxSize)
+    : enabled_(maxSize > 0), entries_(std::max<size_t>(maxSize, 1)) {}
+
+size_t LayoutCache::keyOf(std::type_index type, int64_t fingerprint) {
+  return folly::hash::hash_combine(type.hash_code(), fingerprint);
+}
+
+int64_t LayoutCache::peekFingerprint(folly::ByteRange schema) {
+  folly::IOBuf buf(folly::IOBuf::WRAP_BUFFER, schema);
+  CompactProtocolReader reader;
+  reader.setInput(&buf);
+  std::string name;
+  protocol::TType type;
+  int16_t id;
+  int64_t fingerprint = 0;
+  try {
+    reader.readStructBegin(name);
+    reader.readFieldBegin(name, type, id);
+    if (id == 5 && type == protocol::T_I64) {
+      reader.readI64(fingerprint);
+    }
+  } catch (const std::exception&) {
+    // Not a schema, left to the full decoding to report
+    return 0;
+  }
+  return fingerprint;
+}
+
+int64_t LayoutCache::computeFingerprint(folly::ByteRange schema) {
+  int64_t fingerprint =
+      folly::hash::SpookyHashV2::Hash64(schema.data(), schema.size(), 0);
+  // 0 stands for a schema without a fingerprint
+  return fingerprint ? fingerprint : 1;
+}
+
+std::shared_ptr<const void> LayoutCache::find(
+    std::type_index type,
+    folly::ByteRange range,
+    size_t& schemaSize) {
+  if (!enabled_) {
+    return nullptr;
+  }
+  int64_t fingerprint = peekFingerprint(range);
+  if (!fingerprint) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = entries_.find(keyOf(type, fingerprint));
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+  const Entry& entry = it->second;
+  // A complete serialized struct ends with its stop field, so the schema can't
+  // be a prefix of a different one.
+  if (entry.type != type ||
+      !range.startsWith(folly::ByteRange(folly::StringPiece(entry.schema)))) {
+    return nullptr;
+  }
+  schemaSize = entry.schema.size();
+  return entry.layout;
+}
+
+void LayoutCache::insert(
+    std::type_index type,
+    folly::ByteRange schema,
+    std::shared_ptr<const void> layout) {
+  if (!enabled_) {
+    return;
+  }
+  int64_t fingerprint = peekFingerprint(schema);
+  if (!fingerprint) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  entries_.set(
+      keyOf(type, fingerprint),
+      Entry{type, folly::StringPiece(schema).str(), std::move(layout)});
+}
+
+size_t LayoutCache::size() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return entries_.size();
+}
+
+void LayoutCache::clear() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  entries_.clear();
+}
+
+namespace {
+
+size_t pageSize() {
+  static const size_t size = sysconf(_SC_PAGESIZE);
+  return size;
+}
+
+// Page-aligned range containing 'range'
+std::pair<uintptr_t, uintptr_t> pagesOf(folly::ByteRange range) {
+  auto page = pageSize();
+  auto begin = reinterpret_cast<uintptr_t>(range.begin());
+  auto end = reinterpret_cast<uintptr_t>(range.end());
+  return {begin / page * page, (end + page - 1) / page * page};
+}
+
+} // namespace
+
+void adviseWillNeed(const std::vector<folly::ByteRange>& ranges) {
+  std::vector<std::pair<uintptr_t, uintptr_t>> pages;
+  pages.reserve(ranges.size());
+  for (auto range : ranges) {
+    if (!range.empty()) {
+      pages.push_back(pagesOf(range));
+    }
+  }
+  std::sort(pages.begin(), pages.end());
+  // One call per run of adjacent pages
+  for (size_t i = 0; i < pages.size();) {
+    auto begin = pages[i].first;
+    auto end = pages[i].second;
+    for (++i; i < pages.size() && pages[i].first <= end; ++i) {
+      end = std::max(end, pages[i].second);
+    }
+    // Only a hint, failures don't matter
+    madvise(reinterpret_cast<void*>(begin), end - begin, MADV_WILLNEED);
+  }
+}
+
+MappingStats getMappingStats(folly::ByteRange range) {
+  MappingStats stats;
+  stats.mappedBytes = range.size();
+  if (!range.empty()) {
+    auto pages = pagesOf(range);
+    auto page = pageSize();
+    std::vector<unsigned char> resident((pages.second - pages.first) / page);
+    auto rangeBegin = reinterpret_cast<uintptr_t>(range.begin());
+    auto rangeEnd = reinterpret_cast<uintptr_t>(range.end());
+    if (mincore(
+            reinterpret_cast<void*>(pages.first),
+            pages.second - pages.first,
+            resident.data()) == 0) {
+      for (size_t i = 0; i < resident.size(); ++i) {
+        if (resident[i] & 1) {
+          // The first and last pages may be partially in the range
+          auto begin = std::max(pages.first + i * page, rangeBegin);
+          auto end = std::min(pages.first + (i + 1) * page, rangeEnd);
+          stats.residentBytes += end - begin;
+        }
+      }
+    }
+  }
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    stats.majorFaults = usage.ru_majflt;
+    stats.minorFaults = usage.ru_minflt;
+  }
+  return stats;
+}
+
+namespace detail {
+
+void adviseHugePages(folly::ByteRange range) {
+#ifdef MADV_HUGEPAGE
+  if (!range.empty()) {
+    auto pages = pagesOf(range);
+    // Fails with EINVAL if the filesystem doesn't support huge pages for
+    // mappings, which just leaves regular pages.
+    madvise(
+        reinterpret_cast<void*>(pages.first),
+        pages.second - pages.first,
+        MADV_HUGEPAGE);
+  }
+#else
+  (void)range;
+#endif
+}
+
+} // namespace detail
+
 MallocFreezer::Segment::Segment(size_t _size)
     : size(_size),
       // NB: All allocations rounded up to next multiple of 8 due to packed
@@ -68,6 +262,22 @@ size_t MallocFreezer::offsetOf(const byte* ptr) const {
   return ptr - offsetIt->first;
 }
 
+size_t MallocFreezer::globalOffsetOf(const byte* ptr) const {
+  auto offsetIt = offsets_.upper_bound(ptr);
+  if (offsetIt == offsets_.begin()) {
+    throw std::runtime_error("offset");
+  }
+  --offsetIt;
+  return offsetIt->second + (ptr - offsetIt->first);
+}
+
+int64_t MallocFreezer::offsetBetween(const byte* origin, const byte* target)
+    const {
+  // Segments are separate allocations, pointers can't be subtracted
+  return static_cast<int64_t>(globalOffsetOf(target)) -
+      static_cast<int64_t>(globalOffsetOf(origin));
+}
+
 size_t MallocFreezer::distanceToEnd(const byte* ptr) const {
   if (offsets_.empty()) {
     return 0;
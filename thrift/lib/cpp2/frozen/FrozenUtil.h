@@ -16,9 +16,14 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <typeindex>
+#include <vector>
 
 #include <folly/File.h>
+#include <folly/container/EvictingCacheMap.h>
 #include <folly/portability/GFlags.h>
 #include <folly/system/MemoryMapping.h>
 #include <thrift/lib/cpp2/frozen/Frozen.h>
@@ -27,6 +32,7 @@
 
 DECLARE_bool(thrift_frozen_util_disable_mlock);
 DECLARE_bool(thrift_frozen_util_mlock_on_fault);
+DECLARE_int32(thrift_frozen_layout_cache_size);
 
 namespace apache {
 namespace thrift {
@@ -52,7 +58,8 @@ class FrozenFileForwardIncompatible : public std::runtime_error {
  */
 class MallocFreezer final : public FreezeRoot {
  public:
-  explicit MallocFreezer() {}
+  explicit MallocFreezer(const FreezeOptions& options = FreezeOptions())
+      : FreezeRoot(options) {}
 
   template <class T>
   void freeze(const Layout<T>& layout, const T& root) {
@@ -69,6 +76,9 @@ class MallocFreezer final : public FreezeRoot {
  private:
   size_t distanceToEnd(const byte* origin) const;
   size_t offsetOf(const byte* origin) const;
+  size_t globalOffsetOf(const byte* ptr) const;
+
+  int64_t offsetBetween(const byte* origin, const byte* target) const override;
 
   folly::MutableByteRange appendBuffer(size_t size);
 
@@ -95,6 +105,64 @@ class MallocFreezer final : public FreezeRoot {
   size_t size_{0};
 };
 
+/**
+ * Process-wide cache of the layouts loaded by mapFrozen(), so that mapping
+ * many files frozen with the same schema builds its layout tree only once.
+ *
+ * Entries are found through the fingerprint stored at the beginning of the
+ * serialized schema, which avoids decoding it, and are only used if the whole
+ * serialized schema matches byte for byte. Files written before fingerprints
+ * existed are never cached. Holds up to --thrift_frozen_layout_cache_size
+ * layouts, evicting the least recently used ones.
+ */
+class LayoutCache {
+ public:
+  static LayoutCache& instance();
+
+  explicit LayoutCache(size_t maxSize);
+
+  /**
+   * Returns the cached layout for 'type' if 'range' starts with its schema,
+   * setting the size of that schema.
+   */
+  std::shared_ptr<const void>
+  find(std::type_index type, folly::ByteRange range, size_t& schemaSize);
+
+  /**
+   * Caches the layout of 'type' loaded from the serialized 'schema'.
+   */
+  void insert(
+      std::type_index type,
+      folly::ByteRange schema,
+      std::shared_ptr<const void> layout);
+
+  size_t size() const;
+  void clear();
+
+  /**
+   * Fingerprint stored at the beginning of a serialized schema, 0 if none.
+   */
+  static int64_t peekFingerprint(folly::ByteRange schema);
+
+  /**
+   * Fingerprint to store in a schema serialized with a zero fingerprint.
+   */
+  static int64_t computeFingerprint(folly::ByteRange schema);
+
+ private:
+  struct Entry {
+    std::type_index type;
+    std::string schema;
+    std::shared_ptr<const void> layout;
+  };
+
+  static size_t keyOf(std::type_index type, int64_t fingerprint);
+
+  const bool enabled_;
+  mutable std::mutex mutex_;
+  folly::EvictingCacheMap<size_t, Entry> entries_;
+};
+
 /**
  * Returns an upper bound estimate of the number of bytes required to freeze
  * this object with a minimal layout. Actual bytes required will depend on the
@@ -133,6 +201,10 @@ void serializeRootLayout(const Layout<T>& layout, std::string& out) {
   schema.fileVersion = schema::frozen_constants::kCurrentFrozenFileVersion();
   out.clear();
   CompactSerializer::serialize(schema, &out);
+  schema.fingerprint =
+      LayoutCache::computeFingerprint(folly::StringPiece(out));
+  out.clear();
+  CompactSerializer::serialize(schema, &out);
 }
 
 template <class T>
@@ -151,11 +223,39 @@ void deserializeRootLayout(folly::ByteRange& range, Layout<T>& layoutOut) {
   range.advance(schemaSize);
 }
 
+/**
+ * Same as deserializeRootLayout(), sharing the layout through LayoutCache.
+ */
+template <class T>
+std::shared_ptr<const Layout<T>> loadRootLayout(folly::ByteRange& range) {
+  auto& cache = LayoutCache::instance();
+  const std::type_index type(typeid(Layout<T>));
+  size_t schemaSize;
+  if (auto cached = cache.find(type, range, schemaSize)) {
+    range.advance(schemaSize);
+    return std::static_pointer_cast<const Layout<T>>(cached);
+  }
+  folly::ByteRange schema = range;
+  auto layout = std::make_shared<Layout<T>>();
+  deserializeRootLayout(range, *layout);
+  schema.reset(schema.begin(), range.begin() - schema.begin());
+  cache.insert(type, schema, layout);
+  return layout;
+}
+
+/**
+ * Freezes x into file. With FreezeOptions::dedupStrings, 'stats' (if given)
+ * reports how much deduplication saved.
+ */
 template <class T>
-void freezeToFile(const T& x, folly::File file) {
+void freezeToFile(
+    const T& x,
+    folly::File file,
+    const FreezeOptions& options = FreezeOptions(),
+    FreezeStats* stats = nullptr) {
   std::string schemaStr;
   auto layout = std::make_unique<Layout<T>>();
-  auto contentSize = LayoutRoot::layout(x, *layout);
+  auto contentSize = LayoutRoot::layout(x, *layout, options);
 
   serializeRootLayout(*layout, schemaStr);
 
@@ -166,16 +266,23 @@ void freezeToFile(const T& x, folly::File file) {
   auto writeRange = mapping.writableRange();
   std::copy(schemaStr.begin(), schemaStr.end(), writeRange.begin());
   writeRange.advance(schemaStr.size());
-  ByteRangeFreezer::freeze(*layout, x, writeRange);
+  ByteRangeFreezer::freeze(*layout, x, writeRange, options, stats);
   size_t finalBufferSize = writeRange.begin() - mappingRange.begin();
   ftruncate(file.fd(), finalBufferSize);
 }
 
+/**
+ * Same as freezeToFile(), writing to a string.
+ */
 template <class T>
-void freezeToString(const T& x, std::string& out) {
+void freezeToString(
+    const T& x,
+    std::string& out,
+    const FreezeOptions& options = FreezeOptions(),
+    FreezeStats* stats = nullptr) {
   out.clear();
   Layout<T> layout;
-  size_t contentSize = LayoutRoot::layout(x, layout);
+  size_t contentSize = LayoutRoot::layout(x, layout, options);
   serializeRootLayout(layout, out);
 
   size_t schemaSize = out.size();
@@ -183,7 +290,7 @@ void freezeToString(const T& x, std::string& out) {
   out.resize(bufferSize, 0);
   folly::MutableByteRange writeRange(
       reinterpret_cast<byte*>(&out[schemaSize]), contentSize);
-  ByteRangeFreezer::freeze(layout, x, writeRange);
+  ByteRangeFreezer::freeze(layout, x, writeRange, options, stats);
   out.resize(out.size() - writeRange.size());
 }
 
@@ -224,6 +331,9 @@ void freezeToStringMalloc(const T& x, std::string& out) {
  * Depending on which overload is used, this bundle will hold references to
  * different associated data:
  *
+ * The layout tree is shared with other objects mapped with the same schema,
+ * see LayoutCache.
+ *
  *  - mapFrozen<T>(ByteRange): Only the layout tree associated with the object.
  *  - mapFrozen<T>(StringPiece): Same as mapFrozen<T>(ByteRange).
  *  - mapFrozen<T>(MemoryMapping): Takes ownership of the memory mapping
@@ -236,8 +346,7 @@ using MappedFrozen = Bundled<typename Layout<T>::View>;
 
 template <class T>
 MappedFrozen<T> mapFrozen(folly::ByteRange range) {
-  auto layout = std::make_unique<Layout<T>>();
-  deserializeRootLayout(range, *layout);
+  auto layout = loadRootLayout<T>(range);
   MappedFrozen<T> ret(layout->view({range.begin(), 0}));
   ret.hold(std::move(layout));
   return ret;
@@ -262,12 +371,11 @@ MappedFrozen<T> mapFrozen(folly::MemoryMapping mapping) {
  */
 template <class T>
 MappedFrozen<T> mapFrozen(std::string&& str, bool trim = true) {
-  auto layout = std::make_unique<Layout<T>>();
   auto holder = std::make_unique<HolderImpl<std::string>>(std::move(str));
   auto& ownedStr = holder->t_;
   folly::ByteRange rangeBefore = folly::StringPiece(ownedStr);
   folly::ByteRange range = rangeBefore;
-  deserializeRootLayout(range, *layout);
+  auto layout = loadRootLayout<T>(range);
   if (trim) {
     size_t trimSize = range.begin() - rangeBefore.begin();
     ownedStr.erase(ownedStr.begin(), ownedStr.begin() + trimSize);
@@ -286,15 +394,97 @@ template <class T>
     "passed through non-owning StringPiece")]] MappedFrozen<T>
 mapFrozen(const std::string& str) = delete;
 
+/**
+ * How mapFrozen(File) maps the file. By default the whole file is locked in
+ * memory, which faults it in, but only if allowed by RLIMIT_MEMLOCK.
+ */
+struct MapFrozenOptions {
+  // mlock() the mapping, see folly::MemoryMapping::mlock()
+  bool lock{true};
+  folly::MemoryMapping::LockMode lockMode{
+      folly::MemoryMapping::LockMode::TRY_LOCK};
+  // Fault the whole file in before returning (MAP_POPULATE)
+  bool prefault{false};
+  // Start reading the whole file in the background (MADV_WILLNEED)
+  bool willNeed{false};
+  // Use transparent huge pages, if the filesystem supports them for mappings
+  bool hugePages{false};
+};
+
+/**
+ * Residency of a mapping. Fault counts are those of the whole process, to be
+ * compared before and after a workload.
+ */
+struct MappingStats {
+  size_t mappedBytes{0};
+  size_t residentBytes{0};
+  size_t majorFaults{0};
+  size_t minorFaults{0};
+};
+
+/**
+ * Asks the kernel to start reading the pages holding the given ranges of a
+ * mapping, without waiting for them.
+ */
+void adviseWillNeed(const std::vector<folly::ByteRange>& ranges);
+
+/**
+ * Returns the residency of the given range of a mapping, through mincore().
+ */
+MappingStats getMappingStats(folly::ByteRange range);
+
+/**
+ * Residency of the file mapped by mapFrozen(), empty if it wasn't mapped from
+ * a file.
+ */
+template <class T>
+MappingStats getMappingStats(const MappedFrozen<T>& frozen) {
+  auto mapping = frozen.template findFirstOfType<folly::MemoryMapping>();
+  return mapping ? getMappingStats(mapping->range()) : MappingStats();
+}
+
+/**
+ * Pages in the index of a frozen hash table or ordered table in the
+ * background, so that the first lookups don't all wait for the disk. Other
+ * pages are still read on demand.
+ */
+template <class View>
+void warmIndex(const View& view) {
+  std::vector<folly::ByteRange> ranges;
+  view.indexBytes(ranges);
+  adviseWillNeed(ranges);
+}
+
+namespace detail {
+void adviseHugePages(folly::ByteRange range);
+} // namespace detail
+
+template <class T>
+MappedFrozen<T> mapFrozen(folly::File file, const MapFrozenOptions& options) {
+  folly::MemoryMapping::Options mapOptions;
+  mapOptions.setPrefault(options.prefault);
+  folly::MemoryMapping mapping(std::move(file), 0, -1, mapOptions);
+  if (options.hugePages) {
+    detail::adviseHugePages(mapping.range());
+  }
+  if (options.willNeed) {
+    adviseWillNeed({mapping.range()});
+  }
+  if (options.lock) {
+    folly::MemoryMapping::LockFlags flags{};
+    flags.lockOnFault = FLAGS_thrift_frozen_util_mlock_on_fault;
+    mapping.mlock(options.lockMode, flags);
+  }
+  return mapFrozen<T>(std::move(mapping));
+}
+
 template <class T>
 MappedFrozen<T> mapFrozen(
     folly::File file,
     folly::MemoryMapping::LockMode lockMode) {
-  folly::MemoryMapping mapping(std::move(file), 0);
-  folly::MemoryMapping::LockFlags flags{};
-  flags.lockOnFault = FLAGS_thrift_frozen_util_mlock_on_fault;
-  mapping.mlock(lockMode, flags);
-  return mapFrozen<T>(std::move(mapping));
+  MapFrozenOptions options;
+  options.lockMode = lockMode;
+  return mapFrozen<T>(std::move(file), options);
 }
 
 template <class T>
@@ -45,6 +45,27 @@ class VectorUnpacked : public std::vector<T> {
       "Unpacked storage is only available for simple item types");
   using std::vector<T>::vector;
 };
+
+/*
+ * For representing large lists of strings, frozen in compressed blocks of
+ * about BlockSize bytes. Reading a string decompresses its whole block, and
+ * threads keep the last few blocks they used.
+ *
+ * Use this in Thrift IDL like:
+ *
+ *   cpp_include "thrift/lib/cpp2/frozen/HintTypes.h"
+ *
+ *   struct MyStruct {
+ *     8: list<string>
+ *        (cpp.template = "apache::thrift::frozen::VectorCompressed")
+ *        descriptions,
+ *   }
+ */
+template <class T, size_t BlockSize = 32 * 1024>
+class VectorCompressed : public std::vector<T> {
+  static_assert(BlockSize > 0, "Blocks can't be empty");
+  using std::vector<T>::vector;
+};
 } // namespace frozen
 } // namespace thrift
 } // namespace apache
@@ -249,6 +249,54 @@ BENCHMARK_RELATIVE_PARAM(benchmarkOldFreezeDataToString, strings)
 BENCHMARK_PARAM(benchmarkFreezeDataToString, hashMap_i32)
 BENCHMARK_RELATIVE_PARAM(benchmarkOldFreezeDataToString, hashMap_i32)
 
+BENCHMARK_DRAW_LINE();
+
+constexpr size_t kShards = 500;
+
+// Shards with the same shape and value ranges, which share one schema
+const std::vector<std::string>& makeShards() {
+  static const auto shards = [] {
+    std::vector<std::string> ret;
+    for (size_t shard = 0; shard < kShards; ++shard) {
+      EveryLayout x;
+      x.aInt = shard;
+      for (int i = 0; i < 100; ++i) {
+        x.aList.push_back((i + shard) % 100);
+        x.aMap[i] = (i + shard) % 100;
+        x.aHashMap[i] = (i + shard) % 100;
+      }
+      ret.push_back(freezeToString(x));
+    }
+    return ret;
+  }();
+  return shards;
+}
+
+// Time to map every shard and do a first lookup in each, as on startup
+void benchmarkMapShards(size_t iters, bool cached) {
+  folly::BenchmarkSuspender setup;
+  const auto& shards = makeShards();
+  setup.dismiss();
+  int s = 0;
+  while (iters--) {
+    for (const auto& shard : shards) {
+      if (cached) {
+        auto frozen = mapFrozen<EveryLayout>(folly::StringPiece(shard));
+        s += frozen.aMap().at(42);
+      } else {
+        folly::ByteRange range = folly::StringPiece(shard);
+        Layout<EveryLayout> layout;
+        deserializeRootLayout(range, layout);
+        s += layout.view({range.begin(), 0}).aMap().at(42);
+      }
+    }
+  }
+  folly::doNotOptimizeAway(s);
+}
+
+BENCHMARK_NAMED_PARAM(benchmarkMapShards, uncached, false)
+BENCHMARK_RELATIVE_NAMED_PARAM(benchmarkMapShards, cached, true)
+
 #if 0
 ============================================================================
 thrift/lib/cpp2/frozen/test/FrozenBench.cpp     relative  time/iter  iters/s
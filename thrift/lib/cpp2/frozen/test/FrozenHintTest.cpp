@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <folly/Conv.h>
+#include <folly/compression/Compression.h>
 #include <folly/portability/GTest.h>
 
 #include <thrift/lib/cpp2/frozen/FrozenTestUtil.h>
@@ -33,6 +35,55 @@ TEST(FrozenVectorTypes, Unpacked) {
   const int* raw = fiu.begin();
   EXPECT_EQ(raw[3], 7);
 }
+
+TEST(FrozenVectorTypes, Compressed) {
+  VectorCompressed<std::string, 1024> vc;
+  for (int i = 0; i < 1000; ++i) {
+    vc.push_back(folly::to<std::string>("description of item ", i % 10));
+  }
+  vc.push_back("");
+  vc.push_back(std::string(5000, 'x')); // larger than a block
+  vc.push_back("last");
+  std::vector<std::string> vs(vc.begin(), vc.end());
+  if (folly::io::hasCodec(folly::io::CodecType::ZSTD) ||
+      folly::io::hasCodec(folly::io::CodecType::ZLIB)) {
+    EXPECT_LT(frozenSize(vc) * 4, frozenSize(vs));
+  }
+
+  auto fvc = freeze(vc);
+  ASSERT_EQ(vc.size(), fvc.size());
+  EXPECT_EQ("description of item 3", fvc[3]);
+  EXPECT_EQ("description of item 9", fvc[999]);
+  EXPECT_EQ("", fvc[1000]);
+  EXPECT_EQ(std::string(5000, 'x'), fvc[1001]);
+  EXPECT_EQ("last", fvc[1002]);
+  EXPECT_EQ("description of item 0", fvc[0]);
+  EXPECT_EQ(vc, fvc.thaw());
+
+  auto empty = freeze(VectorCompressed<std::string>());
+  EXPECT_EQ(0, empty.size());
+}
+
+TEST(FrozenVectorTypes, CompressedCopies) {
+  VectorCompressed<std::string> a{"a0", "a1"};
+  VectorCompressed<std::string> b{"b0", "b1"};
+  // Blocks of distinct copies are cached apart
+  auto fa = freeze(a);
+  auto fb = freeze(b);
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ("a1", fa[1]);
+    EXPECT_EQ("b1", fb[1]);
+  }
+}
+
+TEST(FrozenVectorTypes, CompressedBlockReused) {
+  auto codec = static_cast<int32_t>(folly::io::CodecType::NO_COMPRESSION);
+  // A block overwritten in place with the same ends isn't a cache hit
+  std::string block = "aaaaaaaaXaaaaaaaa";
+  EXPECT_EQ(block, detail::decompressBlock(codec, block, block.size()));
+  block[8] = 'Y';
+  EXPECT_EQ(block, detail::decompressBlock(codec, block, block.size()));
+}
 } // namespace frozen
 } // namespace thrift
 } // namespace apache
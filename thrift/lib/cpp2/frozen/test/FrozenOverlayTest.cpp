@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrift/lib/cpp2/frozen/FrozenOverlay.h>
+
+#include <folly/Conv.h>
+#include <folly/experimental/TestUtil.h>
+#include <folly/portability/GTest.h>
+
+using namespace apache::thrift;
+using namespace frozen;
+
+namespace {
+
+template <class Map>
+std::shared_ptr<const MappedFrozen<Map>> makeBase(const Map& map) {
+  return std::make_shared<MappedFrozen<Map>>(
+      mapFrozen<Map>(freezeToString(map)));
+}
+
+template <class Map>
+class FrozenOverlayTest : public ::testing::Test {};
+
+using Maps = ::testing::Types<
+    std::unordered_map<std::string, int>,
+    std::map<std::string, int>>;
+TYPED_TEST_CASE(FrozenOverlayTest, Maps);
+
+} // namespace
+
+TYPED_TEST(FrozenOverlayTest, lookups) {
+  TypeParam base{{"a", 1}, {"b", 2}, {"c", 3}};
+  FrozenOverlay<TypeParam> overlay(makeBase(base));
+  EXPECT_EQ(3, overlay.size());
+  EXPECT_EQ(2, overlay.find("b").value());
+
+  overlay.upsert("b", 20);
+  overlay.upsert("d", 4);
+  EXPECT_TRUE(overlay.erase("c"));
+  EXPECT_FALSE(overlay.erase("e"));
+  EXPECT_TRUE(overlay.erase("d"));
+  overlay.upsert("0", 0);
+
+  EXPECT_EQ(1, overlay.find("a").value());
+  EXPECT_EQ(20, overlay.find("b").value());
+  EXPECT_FALSE(overlay.find("c").hasValue());
+  EXPECT_FALSE(overlay.contains("c"));
+  EXPECT_FALSE(overlay.contains("d"));
+  EXPECT_TRUE(overlay.contains("0"));
+  EXPECT_EQ(3, overlay.size());
+  // "d" was never in the base, so it isn't tracked anymore
+  EXPECT_EQ(3, overlay.deltaSize());
+
+  TypeParam expected{{"0", 0}, {"a", 1}, {"b", 20}};
+  EXPECT_EQ(expected, overlay.merge());
+}
+
+TYPED_TEST(FrozenOverlayTest, compaction) {
+  TypeParam base;
+  for (int i = 0; i < 1000; ++i) {
+    base[folly::to<std::string>(i)] = i;
+  }
+  FrozenOverlay<TypeParam> overlay(makeBase(base));
+  overlay.upsert("1", -1);
+  overlay.erase("2");
+
+  // Compacts a copy while the overlay keeps changing
+  auto compacted = overlay;
+  folly::test::TemporaryFile tmp;
+  compactToFile(compacted, folly::File(tmp.fd()));
+  overlay.upsert("1", -2);
+  overlay.upsert("new", 1);
+
+  overlay.rebase(
+      std::make_shared<MappedFrozen<TypeParam>>(
+          mapFrozen<TypeParam>(folly::File(tmp.fd()))),
+      compacted);
+  EXPECT_EQ(2, overlay.deltaSize());
+  EXPECT_EQ(-2, overlay.find("1").value());
+  EXPECT_FALSE(overlay.contains("2"));
+  EXPECT_EQ(1, overlay.find("new").value());
+  EXPECT_EQ(1000, overlay.size());
+  EXPECT_EQ(999, overlay.base()->size());
+}
+
+TEST(FrozenOverlay, orderedIteration) {
+  using Map = std::map<int, int>;
+  FrozenOverlay<Map> overlay(makeBase(Map{{1, 1}, {3, 3}, {5, 5}}));
+  overlay.upsert(0, 0);
+  overlay.upsert(3, 30);
+  overlay.erase(5);
+  overlay.upsert(6, 6);
+  std::vector<std::pair<int, int>> items;
+  overlay.forEach([&](int key, int value) { items.emplace_back(key, value); });
+  std::vector<std::pair<int, int>> expected{{0, 0}, {1, 1}, {3, 30}, {6, 6}};
+  EXPECT_EQ(expected, items);
+}
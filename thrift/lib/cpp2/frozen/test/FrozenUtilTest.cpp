@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <folly/Conv.h>
 #include <folly/portability/GTest.h>
 
 #include <thrift/lib/cpp2/frozen/FrozenTestUtil.h>
@@ -48,6 +49,42 @@ TEST(FrozenUtil, FreezeAndMap) {
   EXPECT_NE(original, thawed);
 }
 
+TEST(FrozenUtil, MapOptions) {
+  using Tables =
+      std::pair<std::unordered_map<int, int>, std::map<int, std::string>>;
+  Tables original;
+  for (int i = 0; i < 100000; ++i) {
+    original.first[i] = i * 2;
+    original.second[i] = folly::to<std::string>(i);
+  }
+  folly::test::TemporaryFile tmp;
+  freezeToFile(original, folly::File(tmp.fd()));
+  struct stat st;
+  ASSERT_EQ(0, fstat(tmp.fd(), &st));
+
+  MapFrozenOptions options;
+  options.lock = false;
+  options.prefault = true;
+  options.hugePages = true;
+  auto mapped = mapFrozen<Tables>(folly::File(tmp.fd()), options);
+  auto stats = getMappingStats(mapped);
+  EXPECT_EQ(size_t(st.st_size), stats.mappedBytes);
+  EXPECT_EQ(stats.mappedBytes, stats.residentBytes);
+
+  warmIndex(mapped.first());
+  warmIndex(mapped.second());
+  std::vector<folly::ByteRange> index;
+  mapped.second().indexBytes(index, 3);
+  EXPECT_EQ(7, index.size());
+  EXPECT_EQ(mapped.first().at(1234), 2468);
+  EXPECT_EQ(mapped.second().at(1234), "1234");
+
+  // Not mapped from a file
+  auto str = freezeToString(original);
+  EXPECT_EQ(
+      0, getMappingStats(mapFrozen<Tables>(std::move(str))).mappedBytes);
+}
+
 TEST(FrozenUtil, FutureVersion) {
   folly::test::TemporaryFile tmp;
 
@@ -121,6 +158,41 @@ TEST(FrozenUtil, FreezeToString) {
   EXPECT_EQ(frozen.at(3).at(5), 15);
 }
 
+TEST(FrozenUtil, LayoutCache) {
+  using Table = std::vector<std::string>;
+  using SharedLayout = std::shared_ptr<const Layout<Table>>;
+  auto& cache = LayoutCache::instance();
+  cache.clear();
+
+  auto str = freezeToString(Table{"abc", "def"});
+  EXPECT_NE(0, LayoutCache::peekFingerprint(folly::StringPiece(str)));
+  auto a = mapFrozen<Table>(folly::StringPiece(str));
+  auto b = mapFrozen<Table>(folly::StringPiece(str));
+  EXPECT_EQ(1, cache.size());
+  EXPECT_EQ(
+      a.findFirstOfType<SharedLayout>()->get(),
+      b.findFirstOfType<SharedLayout>()->get());
+  EXPECT_EQ("def", b[1]);
+
+  // Same data, different type
+  auto c = mapFrozen<std::vector<folly::fbstring>>(folly::StringPiece(str));
+  EXPECT_EQ(2, cache.size());
+  EXPECT_EQ("abc", c[0]);
+
+  // Different schema
+  auto other = freezeToString(Table{"a much longer string"});
+  auto d = mapFrozen<Table>(std::move(other));
+  EXPECT_EQ(3, cache.size());
+  EXPECT_NE(
+      a.findFirstOfType<SharedLayout>()->get(),
+      d.findFirstOfType<SharedLayout>()->get());
+  EXPECT_EQ("a much longer string", d[0]);
+
+  // The cached layout outlives the cache entry
+  cache.clear();
+  EXPECT_EQ("abc", a[0]);
+}
+
 TEST(Frozen, WorstCasePadding) {
   using Doubles = std::vector<double>;
   using Entry = std::pair<Doubles, std::string>;
@@ -190,3 +262,29 @@ TEST(Frozen, FreezeDataToString) {
   EXPECT_EQ(view[1], "123");
   EXPECT_EQ(view[2], "xyz");
 }
+
+TEST(Frozen, DedupStrings) {
+  using Table = std::vector<std::string>;
+  Table value;
+  for (int i = 0; i < 100; ++i) {
+    value.push_back(i % 2 ? "some repeated value" : "another repeated value");
+  }
+  value.push_back("unique");
+  std::string plain, deduped;
+  freezeToString(value, plain);
+  FreezeOptions options;
+  options.dedupStrings = true;
+  FreezeStats stats;
+  freezeToString(value, deduped, options, &stats);
+  EXPECT_LT(deduped.size(), plain.size() / 4);
+
+  EXPECT_EQ(101, stats.strings);
+  EXPECT_EQ(98, stats.dedupedStrings);
+  EXPECT_EQ(
+      49 * std::string("some repeated value").size() +
+          49 * std::string("another repeated value").size(),
+      stats.dedupedBytes);
+
+  auto frozen = mapFrozen<Table>(std::move(deduped));
+  EXPECT_EQ(value, frozen.thaw());
+}
@@ -17,17 +17,25 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
+#include <functional>
 #include <initializer_list>
 #include <memory>
 #include <type_traits>
+#include <utility>
 
 #include <thrift/lib/cpp2/Thrift.h>
 #include <thrift/lib/cpp2/TypeClass.h>
 #include <thrift/lib/cpp2/protocol/Cpp2Ops.h>
 #include <thrift/lib/cpp2/protocol/Protocol.h>
+#include <thrift/lib/cpp2/protocol/detail/fixed_serialized_size.h>
 
 #include <folly/CPortability.h>
+#include <folly/Optional.h>
+#include <folly/Range.h>
 #include <folly/Traits.h>
+#include <folly/hash/Hash.h>
+#include <folly/io/IOBuf.h>
 
 //  all members are logically private to fbthrift; external use is deprecated
 //
@@ -186,6 +194,171 @@ FOLLY_ERASE constexpr S make_constant(
   return s;
 }
 
+namespace st {
+
+//  containers, hashed element-wise by struct_hasher
+template <typename T, typename = void>
+struct is_hashed_range : std::false_type {};
+template <typename T>
+struct is_hashed_range<T, folly::void_t<typename T::const_iterator>>
+    : std::integral_constant<
+          bool,
+          !std::is_convertible<const T&, folly::StringPiece>::value> {};
+
+//  unordered containers, whose iteration order says nothing about equality
+template <typename T, typename = void>
+struct is_unordered_range : std::false_type {};
+template <typename T>
+struct is_unordered_range<T, folly::void_t<typename T::hasher>>
+    : std::true_type {};
+
+//  hashing and equality of structs annotated with cpp.define_hash
+//
+//  numbers and enums are folded into the hash as they are and the result is
+//  only mixed once at the end, strings and binaries are hashed bytewise,
+//  containers element by element and other fields with std::hash
+class struct_hasher {
+ public:
+  template <typename T>
+  FOLLY_ERASE void add(const T& value) {
+    combine(hash_value(value));
+  }
+  template <typename R>
+  FOLLY_ERASE void add_optional(const R& ref) {
+    combine(ref.has_value());
+    if (ref.has_value()) {
+      add(ref.value_unchecked());
+    }
+  }
+  template <typename P>
+  FOLLY_ERASE void add_ref(const P& ptr) {
+    combine(!!ptr);
+    if (ptr) {
+      add(*ptr);
+    }
+  }
+  FOLLY_ERASE std::size_t finish() const {
+    return folly::hash::twang_mix64(hash_);
+  }
+
+ private:
+  FOLLY_ERASE void combine(uint64_t value) {
+    hash_ = (hash_ ^ value) * 0x9ddfea08eb382d69ULL;
+  }
+
+  template <
+      typename T,
+      std::enable_if_t<std::is_integral<T>::value || std::is_enum<T>::value,
+                       int> = 0>
+  FOLLY_ERASE static uint64_t hash_value(T value) {
+    return static_cast<uint64_t>(value);
+  }
+  template <
+      typename T,
+      std::enable_if_t<std::is_floating_point<T>::value, int> = 0>
+  FOLLY_ERASE static uint64_t hash_value(T value) {
+    // -0.0 == 0.0
+    uint64_t bits = 0;
+    if (value != 0) {
+      std::memcpy(&bits, &value, sizeof(value));
+    }
+    return bits;
+  }
+  template <
+      typename T,
+      std::enable_if_t<
+          std::is_convertible<const T&, folly::StringPiece>::value,
+          int> = 0>
+  FOLLY_ERASE static uint64_t hash_value(const T& value) {
+    return folly::hasher<folly::StringPiece>()(folly::StringPiece(value));
+  }
+  template <
+      typename T,
+      std::enable_if_t<
+          !std::is_arithmetic<T>::value && !std::is_enum<T>::value &&
+              !std::is_convertible<const T&, folly::StringPiece>::value &&
+              !is_hashed_range<T>::value,
+          int> = 0>
+  FOLLY_ERASE static uint64_t hash_value(const T& value) {
+    return std::hash<T>()(value);
+  }
+  //  lists, sets and maps in order, unordered ones with a sum of mixed
+  //  element hashes so that it doesn't depend on their iteration order
+  template <
+      typename T,
+      std::enable_if_t<is_hashed_range<T>::value, int> = 0>
+  static uint64_t hash_value(const T& value) {
+    struct_hasher hasher;
+    hasher.combine(value.size());
+    if (is_unordered_range<T>::value) {
+      uint64_t sum = 0;
+      for (const auto& element : value) {
+        sum += folly::hash::twang_mix64(hash_value(element));
+      }
+      hasher.combine(sum);
+    } else {
+      for (const auto& element : value) {
+        hasher.combine(hash_value(element));
+      }
+    }
+    return hasher.hash_;
+  }
+  template <typename K, typename V>
+  FOLLY_ERASE static uint64_t hash_value(const std::pair<K, V>& value) {
+    struct_hasher hasher;
+    hasher.add(value.first);
+    hasher.add(value.second);
+    return hasher.hash_;
+  }
+  template <typename T>
+  FOLLY_ERASE static uint64_t hash_value(const folly::Optional<T>& value) {
+    struct_hasher hasher;
+    hasher.combine(value.has_value());
+    if (value.has_value()) {
+      hasher.add(*value);
+    }
+    return hasher.hash_;
+  }
+  FOLLY_ERASE static uint64_t hash_value(const folly::IOBuf& value) {
+    return folly::IOBufHash()(value);
+  }
+  FOLLY_ERASE static uint64_t hash_value(
+      const std::unique_ptr<folly::IOBuf>& value) {
+    return value ? folly::IOBufHash()(*value) : 0;
+  }
+
+  uint64_t hash_ = 0;
+};
+
+template <typename T>
+FOLLY_ERASE bool field_equal(const T& lhs, const T& rhs) {
+  return lhs == rhs;
+}
+FOLLY_ERASE inline bool field_equal(
+    const folly::IOBuf& lhs,
+    const folly::IOBuf& rhs) {
+  return folly::IOBufEqualTo()(lhs, rhs);
+}
+FOLLY_ERASE inline bool field_equal(
+    const std::unique_ptr<folly::IOBuf>& lhs,
+    const std::unique_ptr<folly::IOBuf>& rhs) {
+  return lhs == rhs || (lhs && rhs && folly::IOBufEqualTo()(*lhs, *rhs));
+}
+
+template <typename R>
+FOLLY_ERASE bool optional_field_equal(const R& lhs, const R& rhs) {
+  return lhs.has_value() == rhs.has_value() &&
+      (!lhs.has_value() ||
+       field_equal(lhs.value_unchecked(), rhs.value_unchecked()));
+}
+
+template <typename P>
+FOLLY_ERASE bool ref_field_equal(const P& lhs, const P& rhs) {
+  return lhs == rhs || (lhs && rhs && field_equal(*lhs, *rhs));
+}
+
+} // namespace st
+
 } // namespace detail
 } // namespace thrift
 } // namespace apache
@@ -312,6 +312,11 @@ class BinaryProtocolReader {
       return iprot->advanceToNextField(nextFieldId, nextFieldType, *this);
     }
 
+    template <typename... Fields, typename... T>
+    bool readFieldRun(BinaryProtocolReader* /*iprot*/, T&... /*out*/) {
+      return false;
+    }
+
     /*
      * This is used in generated deserialization code only. When deserializing
      * fields in "non-advanceToNextField" case, we delegate the type check to
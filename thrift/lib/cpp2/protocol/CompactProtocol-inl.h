@@ -19,8 +19,13 @@
 
 #include <thrift/lib/cpp2/protocol/CompactProtocol.h>
 
+#include <array>
+#include <initializer_list>
 #include <limits>
+#include <tuple>
+#include <utility>
 
+#include <folly/lang/Bits.h>
 #include <thrift/lib/cpp/util/VarintUtils.h>
 
 namespace apache {
@@ -86,6 +91,149 @@ const TType CTypeToTType[14] = {
     TType::T_FLOAT, // CT_FLOAT
 };
 
+// Helpers for CompactProtocolReader::readFieldRun. They decode straight from
+// a buffer known to hold the longest possible encoding of the whole run, and
+// fold every check into `ok` instead of branching on it.
+
+// Upper bound on the encoded size of a field of type `type`, header included
+constexpr size_t runFieldMaxSize(TType type) {
+  return type == TType::T_BOOL || type == TType::T_STOP
+      ? 1
+      : type == TType::T_BYTE
+          ? 1 + 1
+          : type == TType::T_I16
+              ? 1 + 3
+              : type == TType::T_I32
+                  ? 1 + 5
+                  : type == TType::T_FLOAT
+                      ? 1 + sizeof(float)
+                      : type == TType::T_DOUBLE ? 1 + sizeof(double) : 1 + 10;
+}
+
+constexpr size_t runMaxSize(std::initializer_list<size_t> sizes) {
+  size_t total = 0;
+  for (auto size : sizes) {
+    total += size;
+  }
+  return total;
+}
+
+template <size_t MaxBytes>
+FOLLY_ALWAYS_INLINE uint64_t readRunVarint(const uint8_t*& p, bool& ok) {
+  uint64_t result = 0;
+  for (size_t i = 0; i < MaxBytes; i++) {
+    uint64_t byte = *p++;
+    result |= (byte & 0x7f) << (7 * i);
+    if (!(byte & 0x80)) {
+      return result;
+    }
+  }
+  ok = false;
+  return result;
+}
+
+template <TType Type>
+struct RunValue {
+  static_assert(
+      Type == TType::T_I64,
+      "readFieldRun only handles numbers, enums and bools");
+
+  template <typename T>
+  static void read(const uint8_t*& p, uint8_t header, bool& ok, T& value) {
+    ok &= *p++ == (header | CT_I64);
+    value = static_cast<T>(util::zigzagToI64(readRunVarint<10>(p, ok)));
+  }
+};
+
+template <>
+struct RunValue<TType::T_I32> {
+  template <typename T>
+  static void read(const uint8_t*& p, uint8_t header, bool& ok, T& value) {
+    ok &= *p++ == (header | CT_I32);
+    value = static_cast<T>(util::zigzagToI32(
+        static_cast<uint32_t>(readRunVarint<5>(p, ok))));
+  }
+};
+
+template <>
+struct RunValue<TType::T_I16> {
+  template <typename T>
+  static void read(const uint8_t*& p, uint8_t header, bool& ok, T& value) {
+    ok &= *p++ == (header | CT_I16);
+    value = static_cast<T>(util::zigzagToI32(
+        static_cast<uint32_t>(readRunVarint<3>(p, ok))));
+  }
+};
+
+template <>
+struct RunValue<TType::T_BYTE> {
+  template <typename T>
+  static void read(const uint8_t*& p, uint8_t header, bool& ok, T& value) {
+    ok &= *p++ == (header | CT_BYTE);
+    value = static_cast<T>(static_cast<int8_t>(*p++));
+  }
+};
+
+template <>
+struct RunValue<TType::T_BOOL> {
+  // the value is the type of the header
+  template <typename T>
+  static void read(const uint8_t*& p, uint8_t header, bool& ok, T& value) {
+    uint8_t byte = *p++;
+    uint8_t type = byte & 0x0f;
+    ok &= ((byte & 0xf0) == header) &
+        ((type == CT_BOOLEAN_TRUE) | (type == CT_BOOLEAN_FALSE));
+    value = type == CT_BOOLEAN_TRUE;
+  }
+};
+
+template <>
+struct RunValue<TType::T_DOUBLE> {
+  template <typename T>
+  static void read(const uint8_t*& p, uint8_t header, bool& ok, T& value) {
+    ok &= *p++ == (header | CT_DOUBLE);
+    value = bitwise_cast<double>(
+        folly::Endian::big(folly::loadUnaligned<uint64_t>(p)));
+    p += sizeof(uint64_t);
+  }
+};
+
+template <>
+struct RunValue<TType::T_FLOAT> {
+  template <typename T>
+  static void read(const uint8_t*& p, uint8_t header, bool& ok, T& value) {
+    ok &= *p++ == (header | CT_FLOAT);
+    value = bitwise_cast<float>(
+        folly::Endian::big(folly::loadUnaligned<uint32_t>(p)));
+    p += sizeof(uint32_t);
+  }
+};
+
+template <typename Field, int16_t PrevId, typename T>
+FOLLY_ALWAYS_INLINE void
+readRunField(const uint8_t*& p, bool& ok, T& value) {
+  static_assert(
+      Field::id > PrevId && Field::id - PrevId <= 15,
+      "fields of a run must be encoded as deltas from the previous one");
+  RunValue<Field::type>::read(
+      p, static_cast<uint8_t>((Field::id - PrevId) << 4), ok, value);
+}
+
+template <typename... Fields, typename Values, size_t... I>
+FOLLY_ALWAYS_INLINE void readRunFields(
+    const uint8_t*& p,
+    bool& ok,
+    Values& values,
+    std::index_sequence<I...>) {
+  using fields = std::tuple<Fields...>;
+  constexpr int16_t prevIds[] = {0, Fields::id...};
+  using expand = int[];
+  (void)expand{0,
+               (readRunField<std::tuple_element_t<I, fields>, prevIds[I]>(
+                    p, ok, std::get<I>(values)),
+                0)...};
+}
+
 } // namespace compact
 } // namespace detail
 
@@ -324,6 +472,19 @@ uint32_t CompactProtocolWriter::writeBinary(const folly::IOBuf& str) {
   return result + size;
 }
 
+uint32_t CompactProtocolWriter::writeSerializedData(
+    const std::unique_ptr<folly::IOBuf>& buf) {
+  if (!buf) {
+    return 0;
+  }
+  auto clone = buf->clone();
+  if (sharing_ != SHARE_EXTERNAL_BUFFER) {
+    clone->makeManaged();
+  }
+  out_.insert(std::move(clone));
+  return buf->computeChainDataLength();
+}
+
 /**
  * Functions that return the serialized size
  */
@@ -462,6 +623,13 @@ uint32_t CompactProtocolWriter::serializedSizeZCBinary(IOBuf const& v) const {
       : size + serializedSizeI32(); // size + packed data
 }
 
+uint32_t CompactProtocolWriter::serializedSizeSerializedData(
+    std::unique_ptr<IOBuf> const& /*buf*/) const {
+  // writeSerializedData's implementation just chains IOBufs together. Thus
+  // we don't expect external buffer space for it.
+  return 0;
+}
+
 /**
  * Reading functions
  */
@@ -804,6 +972,53 @@ bool CompactProtocolReader::advanceToNextField(
   return false;
 }
 
+template <typename... Fields, typename... T>
+bool CompactProtocolReader::readFieldRun(T&... out) {
+  constexpr bool kEndsStruct = sizeof...(Fields) == sizeof...(T) + 1;
+  static_assert(
+      kEndsStruct || sizeof...(Fields) == sizeof...(T),
+      "readFieldRun needs one output per field");
+  constexpr size_t kMaxSize = detail::compact::runMaxSize(
+      {detail::compact::runFieldMaxSize(Fields::type)...});
+
+  // Decoding never looks further than kMaxSize bytes, which saves bounds
+  // checks on every byte. When fewer are left in this buffer, e.g. for a
+  // struct at the very end of the input, decode from a zero padded copy of
+  // what is left instead; a run that reads into the padding is rejected.
+  const uint8_t* begin = in_.data();
+  size_t available = kMaxSize;
+  std::array<uint8_t, kMaxSize> padded;
+  const bool isPadded = in_.length() < kMaxSize;
+  if (UNLIKELY(isPadded)) {
+    padded.fill(0);
+    auto cursor = in_;
+    available = cursor.pullAtMost(padded.data(), kMaxSize);
+    begin = padded.data();
+  }
+
+  const uint8_t* p = begin;
+  bool ok = true;
+  std::tuple<T...> values;
+  detail::compact::readRunFields<Fields...>(
+      p, ok, values, std::index_sequence_for<T...>{});
+  if (kEndsStruct) {
+    ok &= *p++ == detail::compact::CT_STOP;
+  }
+  const size_t consumed = p - begin;
+  ok &= consumed <= available;
+  if (!ok) {
+    return false;
+  }
+
+  if (UNLIKELY(isPadded)) {
+    in_.skip(consumed);
+  } else {
+    in_.skipNoAdvance(consumed);
+  }
+  std::tie(out...) = std::move(values);
+  return true;
+}
+
 void CompactProtocolReader::readStructBeginWithState(
     StructReadState& /* state */) {}
 
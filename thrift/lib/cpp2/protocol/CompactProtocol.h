@@ -167,10 +167,7 @@ class CompactProtocolWriter {
   inline uint32_t writeBinary(const std::unique_ptr<IOBuf>& str);
   inline uint32_t writeBinary(const IOBuf& str);
   inline uint32_t writeSerializedData(
-      const std::unique_ptr<folly::IOBuf>& /*data*/) {
-    // TODO
-    return 0;
-  }
+      const std::unique_ptr<folly::IOBuf>& data);
 
   /**
    * Functions that return the serialized size
@@ -217,10 +214,7 @@ class CompactProtocolWriter {
       std::unique_ptr<IOBuf> const& /*v*/) const;
   inline uint32_t serializedSizeZCBinary(IOBuf const& /*v*/) const;
   inline uint32_t serializedSizeSerializedData(
-      std::unique_ptr<folly::IOBuf> const& /*data*/) const {
-    // TODO (kek)
-    return 0;
-  }
+      std::unique_ptr<folly::IOBuf> const& data) const;
 
  protected:
   /**
@@ -389,6 +383,13 @@ class CompactProtocolReader {
           currFieldId, nextFieldId, nextFieldType, *this);
     }
 
+    template <typename... Fields, typename... T>
+    FOLLY_ALWAYS_INLINE bool readFieldRun(
+        CompactProtocolReader* iprot,
+        T&... out) {
+      return iprot->readFieldRun<Fields...>(out...);
+    }
+
     void afterAdvanceFailure(CompactProtocolReader* /*iprot*/) {}
 
     void beforeSubobject(CompactProtocolReader* /* iprot */) {}
@@ -451,6 +452,9 @@ class CompactProtocolReader {
       TType type,
       StructReadState& state);
 
+  template <typename... Fields, typename... T>
+  FOLLY_ALWAYS_INLINE bool readFieldRun(T&... out);
+
   [[noreturn]] static void throwBadProtocolIdentifier();
   [[noreturn]] static void throwBadProtocolVersion();
   [[noreturn]] static void throwBadType(uint8_t type);
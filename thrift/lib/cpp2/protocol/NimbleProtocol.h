@@ -284,6 +284,11 @@ class NimbleProtocolReader {
       return false;
     }
 
+    template <typename... Fields, typename... T>
+    bool readFieldRun(NimbleProtocolReader* /*iprot*/, T&... /*out*/) {
+      return false;
+    }
+
     FOLLY_ALWAYS_INLINE
     void afterAdvanceFailure(NimbleProtocolReader* iprot) {
       returnFieldPtrs(iprot);
@@ -23,6 +23,16 @@ namespace apache {
 namespace thrift {
 namespace detail {
 
+/**
+ * Names one field expected by `readFieldRun`: its id and wire type. An entry
+ * of type `T_STOP` stands for the end of the struct.
+ */
+template <int16_t Id, protocol::TType Type>
+struct FieldRunEntry {
+  static constexpr int16_t id = Id;
+  static constexpr protocol::TType type = Type;
+};
+
 /**
  * Default stub implementation for StructReadState for protocols that don't
  * support it.
@@ -84,6 +94,24 @@ struct ProtocolReaderStructReadState {
     return false;
   }
 
+  /**
+   * Reads the leading fields of a struct, named by `Fields`, into `out` in one
+   * go. Called right after readStructBegin, instead of advancing to the first
+   * field.
+   *
+   * Only succeeds if the wire holds exactly these fields, in this order, with
+   * these types. A trailing `T_STOP` entry also requires (and consumes) the
+   * end of the struct.
+   *
+   * Like advanceToNextField this is BEST EFFORT: on `false` neither the read
+   * state, the input nor `out` has changed, and reading continues field by
+   * field.
+   */
+  template <typename... Fields, typename... T>
+  FOLLY_ALWAYS_INLINE bool readFieldRun(Protocol* /*iprot*/, T&... /*out*/) {
+    return false;
+  }
+
   /*
    * This is used in generated deserialization code only. When deserializing
    * fields in "non-advanceToNextField" case, we delegate the type check to
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <type_traits>
+
+#include <thrift/lib/cpp2/TypeClass.h>
+
+namespace apache {
+namespace thrift {
+
+class BinaryProtocolWriter;
+
+namespace detail {
+namespace pm {
+
+/**
+ * Serialized size of every value of Type with Protocol, when it doesn't
+ * depend on the value, 0 otherwise.
+ *
+ * That's the case of numbers, enums, and generated structs whose fields are
+ * all of such types and always written, with the Binary protocol. Containers
+ * use it to size their elements all at once.
+ */
+template <
+    typename Protocol,
+    typename TypeClass,
+    typename Type,
+    typename = void>
+struct fixed_serialized_size : std::integral_constant<uint32_t, 0> {};
+
+template <typename Protocol, typename TypeClass, typename Type>
+struct fixed_serialized_size<const Protocol, TypeClass, Type>
+    : fixed_serialized_size<Protocol, TypeClass, Type> {};
+
+template <typename Type>
+struct fixed_serialized_size<
+    BinaryProtocolWriter,
+    type_class::integral,
+    Type,
+    std::enable_if_t<std::is_integral<Type>::value>>
+    : std::integral_constant<uint32_t, sizeof(Type)> {};
+
+template <typename Type>
+struct fixed_serialized_size<
+    BinaryProtocolWriter,
+    type_class::floating_point,
+    Type,
+    std::enable_if_t<std::is_floating_point<Type>::value>>
+    : std::integral_constant<uint32_t, sizeof(Type)> {};
+
+template <typename Type>
+struct fixed_serialized_size<
+    BinaryProtocolWriter,
+    type_class::enumeration,
+    Type>
+    // Written as i32
+    : std::integral_constant<uint32_t, 4> {};
+
+// Generated structs declare their size when all of their fields may have
+// fixed sizes.
+template <typename Type>
+struct fixed_serialized_size<
+    BinaryProtocolWriter,
+    type_class::structure,
+    Type,
+    decltype(void(Type::__fbthrift_binary_serialized_size))>
+    : std::integral_constant<
+          uint32_t,
+          Type::__fbthrift_binary_serialized_size> {};
+
+/**
+ * Binary size of a struct given the sizes of its fields, all written: field
+ * headers, values and stop. 0 if the size of a field isn't fixed.
+ */
+constexpr uint32_t binary_struct_size(
+    std::initializer_list<uint32_t> fieldSizes) {
+  uint32_t size = 1; // stop
+  for (auto fieldSize : fieldSizes) {
+    if (fieldSize == 0) {
+      return 0;
+    }
+    size += 3 + fieldSize; // type and id, value
+  }
+  return size;
+}
+
+} // namespace pm
+} // namespace detail
+} // namespace thrift
+} // namespace apache
@@ -36,6 +36,7 @@
 #include <thrift/lib/cpp2/protocol/Cpp2Ops.h>
 #include <thrift/lib/cpp2/protocol/Protocol.h>
 #include <thrift/lib/cpp2/protocol/ProtocolReaderWireTypeInfo.h>
+#include <thrift/lib/cpp2/protocol/detail/fixed_serialized_size.h>
 
 /**
  * Specializations of `protocol_methods` encapsulate a collection of
@@ -569,8 +570,15 @@ struct protocol_methods<type_class::list<ElemClass>, Type> {
 
     xfer +=
         protocol.serializedSizeListBegin(elem_methods::ttype_value, out.size());
-    for (auto const& elem : out) {
-      xfer += elem_methods::template serializedSize<ZeroCopy>(protocol, elem);
+    constexpr uint32_t kElemSize =
+        fixed_serialized_size<Protocol, ElemClass, elem_type>::value;
+    if (kElemSize != 0) {
+      xfer += out.size() * kElemSize;
+    } else {
+      for (auto const& elem : out) {
+        xfer +=
+            elem_methods::template serializedSize<ZeroCopy>(protocol, elem);
+      }
     }
     xfer += protocol.serializedSizeListEnd();
     return xfer;
@@ -659,8 +667,15 @@ struct protocol_methods<type_class::set<ElemClass>, Type> {
 
     xfer +=
         protocol.serializedSizeSetBegin(elem_methods::ttype_value, out.size());
-    for (auto const& elem : out) {
-      xfer += elem_methods::template serializedSize<ZeroCopy>(protocol, elem);
+    constexpr uint32_t kElemSize =
+        fixed_serialized_size<Protocol, ElemClass, elem_type>::value;
+    if (kElemSize != 0) {
+      xfer += out.size() * kElemSize;
+    } else {
+      for (auto const& elem : out) {
+        xfer +=
+            elem_methods::template serializedSize<ZeroCopy>(protocol, elem);
+      }
     }
     xfer += protocol.serializedSizeSetEnd();
     return xfer;
@@ -767,11 +782,19 @@ struct protocol_methods<type_class::map<KeyClass, MappedClass>, Type> {
 
     xfer += protocol.serializedSizeMapBegin(
         key_methods::ttype_value, mapped_methods::ttype_value, out.size());
-    for (auto const& elem_pair : out) {
-      xfer += key_methods::template serializedSize<ZeroCopy>(
-          protocol, elem_pair.first);
-      xfer += mapped_methods::template serializedSize<ZeroCopy>(
-          protocol, elem_pair.second);
+    constexpr uint32_t kKeySize =
+        fixed_serialized_size<Protocol, KeyClass, key_type>::value;
+    constexpr uint32_t kMappedSize =
+        fixed_serialized_size<Protocol, MappedClass, mapped_type>::value;
+    if (kKeySize != 0 && kMappedSize != 0) {
+      xfer += out.size() * (kKeySize + kMappedSize);
+    } else {
+      for (auto const& elem_pair : out) {
+        xfer += key_methods::template serializedSize<ZeroCopy>(
+            protocol, elem_pair.first);
+        xfer += mapped_methods::template serializedSize<ZeroCopy>(
+            protocol, elem_pair.second);
+      }
     }
     xfer += protocol.serializedSizeMapEnd();
     return xfer;
@@ -0,0 +1,424 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include <fatal/type/apply.h>
+#include <fatal/type/find.h>
+#include <fatal/type/foreach.h>
+#include <fatal/type/search.h>
+#include <fatal/type/size.h>
+#include <fatal/type/sort.h>
+#include <fatal/type/transform.h>
+#include <fatal/type/trie.h>
+#include <folly/Range.h>
+#include <folly/Traits.h>
+#include <thrift/lib/cpp/protocol/TProtocolException.h>
+#include <thrift/lib/cpp2/reflection/reflection.h>
+#include <thrift/lib/cpp2/reflection/serializer.h>
+
+#include <thrift/lib/cpp2/reflection/internal/columnar-inl-pre.h>
+
+namespace apache {
+namespace thrift {
+
+/**
+ * A list of Thrift structs stored column by column: each member of `Struct`
+ * lives in its own contiguous array, and optional members additionally keep
+ * a bitmap of the rows in which they are set.
+ *
+ * `read()` and `write()` use the wire format of `list<Struct>`, so a
+ * `ColumnarList<Event>` can stand in for a `std::vector<Event>` on either end
+ * of a connection. Reading decodes each field straight into its column and
+ * never materializes a `Struct`.
+ *
+ * Queries that touch a few members of every row can then scan just those
+ * columns, which the compiler is free to vectorize.
+ *
+ * Example:
+ *
+ *  // MyModule.thrift
+ *
+ *  struct Event {
+ *    1: i64 timestamp
+ *    2: i32 latency
+ *    3: optional string tag
+ *  }
+ *
+ *  // MyModule.cpp
+ *
+ *  ColumnarList<Event> events;
+ *  events.read(reader);
+ *
+ *  std::int64_t total = 0;
+ *  for (auto latency : events.column<2>()) {
+ *    total += latency;
+ *  }
+ *
+ *  // `true` if the third event was sent with a tag
+ *  bool tagged = events.is_set<3>(2);
+ *
+ * Members stored as `cpp.ref` pointers are not supported. Columns of `bool`
+ * members hold `std::uint8_t` so that they, too, are flat arrays.
+ *
+ * This requires the reflection metadata for `Struct` to be available.
+ */
+template <typename Struct>
+class ColumnarList {
+  using traits = reflect_struct<Struct>;
+  using members = typename traits::members;
+  using columns = fatal::apply_to<members, columnar_detail::columns>;
+  using sorted_fids =
+      fatal::sort<fatal::transform<members, fatal::get_type::id>>;
+  using found_set = std::bitset<fatal::size<members>::value>;
+
+ public:
+  /**
+   * The reflection metadata of the member with field id `Id`.
+   */
+  template <field_id_t Id>
+  using member = fatal::get<
+      members,
+      std::integral_constant<field_id_t, Id>,
+      fatal::get_type::id>;
+
+  /**
+   * The type of the elements in the column of the member with field id `Id`.
+   */
+  template <field_id_t Id>
+  using element_type =
+      typename columnar_detail::column<member<Id>>::element_type;
+
+  using size_type = std::size_t;
+
+  size_type size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  void reserve(size_type rows) {
+    fatal::foreach<members>(reserve_member(), columns_, rows);
+  }
+
+  void clear() {
+    fatal::foreach<members>(clear_member(), columns_);
+    size_ = 0;
+  }
+
+  /**
+   * Appends a row holding a copy of every member of `in`.
+   */
+  void push_back(Struct const& in) {
+    fatal::foreach<members>(append_member(), columns_, in);
+    ++size_;
+  }
+
+  /**
+   * Materializes the struct stored at `row`.
+   */
+  Struct row(size_type row) const {
+    DCHECK_LT(row, size_);
+    Struct out;
+    fatal::foreach<members>(load_member(), columns_, row, out);
+    return out;
+  }
+
+  /**
+   * The values of the member with field id `Id`, one per row. Rows in which
+   * an optional member is unset hold the member's default value.
+   */
+  template <field_id_t Id>
+  folly::Range<element_type<Id> const*> column() const {
+    auto const& values = get<Id>().values;
+    return {values.data(), values.size()};
+  }
+
+  /**
+   * The presence bitmap of the optional member with field id `Id`: bit
+   * `row % 64` of word `row / 64` is set when the member is set in `row`.
+   */
+  template <field_id_t Id>
+  folly::Range<std::uint64_t const*> isset() const {
+    static_assert(
+        columnar_detail::column<member<Id>>::is_optional,
+        "only optional members keep a presence bitmap");
+    auto const& bits = get<Id>().isset;
+    return {bits.data(), bits.size()};
+  }
+
+  /**
+   * Whether the member with field id `Id` is set in `row`. Always `true` for
+   * non-optional members.
+   */
+  template <field_id_t Id>
+  bool is_set(size_type row) const {
+    DCHECK_LT(row, size_);
+    return get<Id>().is_set(row);
+  }
+
+  /**
+   * Replaces the contents with a `list<Struct>` read from `protocol`.
+   */
+  template <typename Protocol>
+  void read(Protocol& protocol) {
+    std::uint32_t list_size = -1;
+    protocol::TType reported_type = protocol::T_STOP;
+
+    clear();
+    protocol.readListBegin(reported_type, list_size);
+
+    if (detail::is_unknown_container_size(list_size)) {
+      while (protocol.peekList()) {
+        read_row(protocol);
+      }
+    } else {
+      if (reported_type != protocol::T_STRUCT) {
+        throw protocol::TProtocolException(
+            protocol::TProtocolException::INVALID_DATA,
+            "ColumnarList can only be read from a list of structs");
+      }
+      reserve(list_size);
+      for (decltype(list_size) i = 0; i < list_size; i++) {
+        read_row(protocol);
+      }
+    }
+
+    protocol.readListEnd();
+  }
+
+  /**
+   * Writes the rows to `protocol` as a `list<Struct>`.
+   */
+  template <typename Protocol>
+  std::size_t write(Protocol& protocol) const {
+    std::size_t xfer = 0;
+    xfer += protocol.writeListBegin(protocol::T_STRUCT, size_);
+    for (size_type row = 0; row < size_; row++) {
+      xfer += protocol.writeStructBegin(
+          fatal::z_data<typename traits::name>());
+      fatal::foreach<members>(write_member(), protocol, columns_, row, xfer);
+      xfer += protocol.writeFieldStop();
+      xfer += protocol.writeStructEnd();
+    }
+    xfer += protocol.writeListEnd();
+    return xfer;
+  }
+
+ private:
+  template <field_id_t Id>
+  columnar_detail::column<member<Id>> const& get() const {
+    return std::get<fatal::index_of<members, member<Id>>::value>(columns_);
+  }
+
+  struct reserve_member {
+    template <typename Member, std::size_t Index>
+    void operator()(
+        fatal::indexed<Member, Index>,
+        columns& cols,
+        size_type rows) const {
+      std::get<Index>(cols).reserve(rows);
+    }
+  };
+
+  struct clear_member {
+    template <typename Member, std::size_t Index>
+    void operator()(fatal::indexed<Member, Index>, columns& cols) const {
+      std::get<Index>(cols).clear();
+    }
+  };
+
+  struct append_member {
+    template <typename Member, std::size_t Index>
+    void operator()(
+        fatal::indexed<Member, Index>,
+        columns& cols,
+        Struct const& in) const {
+      auto& col = std::get<Index>(cols);
+      col.append(Member::getter::ref(in));
+      if (Member::is_set(in)) {
+        col.mark_set(col.values.size() - 1);
+      }
+    }
+  };
+
+  struct load_member {
+    template <typename Member, std::size_t Index>
+    void operator()(
+        fatal::indexed<Member, Index>,
+        columns const& cols,
+        size_type row,
+        Struct& out) const {
+      auto const& col = std::get<Index>(cols);
+      using column_type = folly::remove_cvref_t<decltype(col)>;
+      Member::getter::ref(out) = column_type::traits::load(col.values[row]);
+      Member::mark_set(out, col.is_set(row));
+    }
+  };
+
+  // every row starts out with the members' default values, which the fields
+  // present on the wire then overwrite
+  struct append_default {
+    template <typename Member, std::size_t Index>
+    void operator()(
+        fatal::indexed<Member, Index>,
+        columns& cols,
+        Struct const& defaults) const {
+      std::get<Index>(cols).append(Member::getter::ref(defaults));
+    }
+  };
+
+  // mapping member fname -> fid, for protocols that don't send field ids
+  struct member_fname_to_fid {
+    template <typename Member>
+    void
+    operator()(fatal::tag<Member>, field_id_t& fid, protocol::TType& ftype) {
+      fid = Member::id::value;
+      ftype =
+          protocol_methods<typename Member::type_class, typename Member::type>::
+              ttype_value;
+    }
+  };
+
+  // match on member field id -> read that field into the last row
+  struct read_member {
+    template <typename Fid, std::size_t Index, typename Protocol>
+    void operator()(
+        fatal::indexed<Fid, Index>,
+        const protocol::TType ftype,
+        Protocol& protocol,
+        columns& cols,
+        found_set& found) const {
+      using Member = fatal::get<members, Fid, fatal::get_type::id>;
+      using member_methods =
+          protocol_methods<typename Member::type_class, typename Member::type>;
+      constexpr auto idx = fatal::index_of<members, Member>::value;
+
+      if (ftype == member_methods::ttype_value) {
+        auto& col = std::get<idx>(cols);
+        using column_type = folly::remove_cvref_t<decltype(col)>;
+        column_type::traits::template read<typename Member::type_class>(
+            protocol, col.values.back());
+        col.mark_set(col.values.size() - 1);
+        found.set(idx);
+      } else {
+        protocol.skip(ftype);
+      }
+    }
+  };
+
+  struct check_required {
+    template <typename Member, std::size_t Index>
+    void operator()(fatal::indexed<Member, Index>, found_set const& found)
+        const {
+      if (Member::optional::value == optionality::required && !found[Index]) {
+        throw protocol::TProtocolException(
+            protocol::TProtocolException::MISSING_REQUIRED_FIELD,
+            "Required field was not found in serialized data!");
+      }
+    }
+  };
+
+  struct write_member {
+    template <typename Member, std::size_t Index, typename Protocol>
+    void operator()(
+        fatal::indexed<Member, Index>,
+        Protocol& protocol,
+        columns const& cols,
+        size_type row,
+        std::size_t& xfer) const {
+      using member_methods =
+          protocol_methods<typename Member::type_class, typename Member::type>;
+
+      auto const& col = std::get<Index>(cols);
+      using column_type = folly::remove_cvref_t<decltype(col)>;
+      if (!col.is_set(row)) {
+        return;
+      }
+      xfer += protocol.writeFieldBegin(
+          fatal::z_data<typename Member::name>(),
+          member_methods::ttype_value,
+          Member::id::value);
+      xfer += member_methods::write(
+          protocol, column_type::traits::load(col.values[row]));
+      xfer += protocol.writeFieldEnd();
+    }
+  };
+
+  static Struct const& defaults() {
+    static Struct const instance;
+    return instance;
+  }
+
+  template <typename Protocol>
+  void read_row(Protocol& protocol) {
+    std::string fname;
+    protocol::TType ftype = protocol::T_STOP;
+    std::int16_t fid = -1;
+    found_set found;
+
+    fatal::foreach<members>(append_default(), columns_, defaults());
+    ++size_;
+
+    protocol.readStructBegin(fname);
+    while (true) {
+      protocol.readFieldBegin(fname, ftype, fid);
+      if (ftype == protocol::T_STOP) {
+        break;
+      }
+
+      // fid might not be known, such as in the case of SimpleJSON protocol
+      if (fid == std::numeric_limits<int16_t>::min()) {
+        bool const found_ = fatal::trie_find<members, fatal::get_type::name>(
+            fname.begin(), fname.end(), member_fname_to_fid(), fid, ftype);
+        if (!found_) {
+          protocol.skip(ftype);
+          protocol.readFieldEnd();
+          continue;
+        }
+      }
+
+      if (!fatal::sorted_search<sorted_fids>(
+              fid, read_member(), ftype, protocol, columns_, found)) {
+        DVLOG(3) << "didn't find field, fid: " << fid << ", fname: " << fname;
+        protocol.skip(ftype);
+      }
+
+      protocol.readFieldEnd();
+    }
+    protocol.readStructEnd();
+
+    fatal::foreach<members>(check_required(), found);
+  }
+
+  columns columns_;
+  size_type size_ = 0;
+};
+
+} // namespace thrift
+} // namespace apache
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+namespace apache {
+namespace thrift {
+namespace columnar_detail {
+
+// Maps a field type to the type stored in its column. `bool` fields are kept
+// as bytes since `std::vector<bool>` can't be handed out as a flat array.
+template <typename T>
+struct element {
+  using type = T;
+
+  template <typename TypeClass, typename Protocol>
+  static void read(Protocol& protocol, type& out) {
+    protocol_methods<TypeClass, T>::read(protocol, out);
+  }
+
+  static T const& load(type const& in) {
+    return in;
+  }
+};
+
+template <>
+struct element<bool> {
+  using type = std::uint8_t;
+
+  template <typename TypeClass, typename Protocol>
+  static void read(Protocol& protocol, type& out) {
+    bool value = false;
+    protocol_methods<TypeClass, bool>::read(protocol, value);
+    out = value;
+  }
+
+  static bool load(type in) {
+    return in != 0;
+  }
+};
+
+// The values of a single member, one per row, plus a bitmap of the rows in
+// which an optional member is set. Non-optional members keep no bitmap.
+template <typename Member>
+struct column {
+  using type = typename Member::type;
+  using traits = element<type>;
+  using element_type = typename traits::type;
+
+  static constexpr bool is_optional =
+      Member::optional::value == optionality::optional;
+
+  static_assert(
+      !detail::is_smart_pointer<type>::value,
+      "ColumnarList does not support cpp.ref fields");
+
+  std::vector<element_type> values;
+  std::vector<std::uint64_t> isset;
+
+  void reserve(std::size_t rows) {
+    values.reserve(rows);
+    if (is_optional) {
+      isset.reserve((rows + 63) / 64);
+    }
+  }
+
+  void clear() {
+    values.clear();
+    isset.clear();
+  }
+
+  template <typename U>
+  void append(U&& value) {
+    if (is_optional && values.size() % 64 == 0) {
+      isset.push_back(0);
+    }
+    values.emplace_back(std::forward<U>(value));
+  }
+
+  bool is_set(std::size_t row) const {
+    return !is_optional || ((isset[row / 64] >> (row % 64)) & 1);
+  }
+
+  void mark_set(std::size_t row) {
+    if (is_optional) {
+      isset[row / 64] |= std::uint64_t(1) << (row % 64);
+    }
+  }
+};
+
+template <typename... Members>
+using columns = std::tuple<column<Members>...>;
+
+} // namespace columnar_detail
+} // namespace thrift
+} // namespace apache
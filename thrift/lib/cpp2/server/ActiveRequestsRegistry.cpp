@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrift/lib/cpp2/server/ActiveRequestsRegistry.h>
+
+#include <thrift/lib/cpp2/async/ResponseChannel.h>
+#include <thrift/lib/cpp2/server/Cpp2ConnContext.h>
+
+namespace apache {
+namespace thrift {
+
+void ActiveRequestsRegistry::onRequestFinished(const DebugStub& stub) {
+  if (!slowRequestsLog_.isEnabled()) {
+    return;
+  }
+  const auto* timings = stub.getRequest().getTimings();
+  if (!timings) {
+    return;
+  }
+  const auto now = std::chrono::steady_clock::now();
+  if (!slowRequestsLog_.shouldRecord(now - stub.getTimestamp(), now)) {
+    return;
+  }
+  SlowRequestsLog::Entry entry;
+  entry.methodName = stub.getRequestContext().getMethodName();
+  entry.received = stub.getTimestamp();
+  entry.processBegin = timings->processBegin;
+  entry.processEnd = timings->processEnd;
+  entry.finished = now;
+  entry.requestBytes = timings->requestBytes;
+  entry.responseBytes = timings->responseBytes;
+  slowRequestsLog_.record(std::move(entry));
+}
+
+} // namespace thrift
+} // namespace apache
@@ -20,11 +20,14 @@
 #include <folly/io/IOBuf.h>
 #include <chrono>
 
+#include <thrift/lib/cpp2/server/SlowRequestsLog.h>
+
 namespace apache {
 namespace thrift {
 
 class Cpp2RequestContext;
 class ResponseChannelRequest;
+struct RequestTimings;
 
 /**
  * Stores a list of request stubs in memory.
@@ -80,6 +83,7 @@ class ActiveRequestsRegistry {
         DCHECK(activeRequestsPayloadHook_.is_linked());
         registry_->onStubPayloadUnlinked(*this);
       }
+      registry_->onRequestFinished(*this);
     }
 
     const ResponseChannelRequest& getRequest() const {
@@ -131,14 +135,32 @@ class ActiveRequestsRegistry {
   using ActiveRequestPayloadList =
       folly::IntrusiveList<DebugStub, &DebugStub::activeRequestsPayloadHook_>;
 
-  ActiveRequestsRegistry(uint64_t requestPayloadMem, uint64_t totalPayloadMem)
+  ActiveRequestsRegistry(
+      uint64_t requestPayloadMem,
+      uint64_t totalPayloadMem,
+      size_t slowRequestsLogSize = 0,
+      std::chrono::steady_clock::duration slowRequestsLogWindow =
+          std::chrono::minutes(1))
       : payloadMemoryLimitPerRequest_(requestPayloadMem),
-        payloadMemoryLimitTotal_(totalPayloadMem) {}
+        payloadMemoryLimitTotal_(totalPayloadMem),
+        slowRequestsLog_(slowRequestsLogSize, slowRequestsLogWindow) {}
 
   const ActiveRequestDebugStubList& getDebugStubList() {
     return reqDebugStubList_;
   }
 
+  /**
+   * If enabled, requests should collect their timings (see
+   * ResponseChannelRequest::enableTimings) to be considered by the log.
+   */
+  bool isSlowRequestsLogEnabled() const {
+    return slowRequestsLog_.isEnabled();
+  }
+
+  const SlowRequestsLog& getSlowRequestsLog() const {
+    return slowRequestsLog_;
+  }
+
   void registerStub(DebugStub& req) {
     uint64_t payloadSize = req.getPayloadSize();
     reqDebugStubList_.push_back(req);
@@ -169,9 +191,12 @@ class ActiveRequestsRegistry {
     DCHECK(payloadMemoryUsage_ >= payloadSize);
     payloadMemoryUsage_ -= payloadSize;
   }
+  void onRequestFinished(const DebugStub& stub);
+
   uint64_t payloadMemoryLimitPerRequest_;
   uint64_t payloadMemoryLimitTotal_;
   uint64_t payloadMemoryUsage_{0};
+  SlowRequestsLog slowRequestsLog_;
   ActiveRequestDebugStubList reqDebugStubList_;
   ActiveRequestPayloadList reqPayloadList_;
 };
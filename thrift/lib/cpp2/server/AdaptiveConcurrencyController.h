@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+#include <glog/logging.h>
+
+#include <thrift/lib/cpp2/server/AdmissionController.h>
+
+namespace apache {
+namespace thrift {
+
+/**
+ * AdmissionController which limits the number of concurrent requests (queued
+ * or being processed), and continuously adapts that limit based on the
+ * processing latency, similarly to TCP Vegas or Netflix's gradient limiter.
+ *
+ * The controller tracks the minimum latency observed over `minLatencyWindow`
+ * (the latency of the server when it isn't contended) and the average
+ * latency over each `sampleInterval`. Every interval, the limit is updated
+ * as follows:
+ *   gradient = clamp(tolerance * minLatency / recentLatency, 0.5, 1.0)
+ *   newLimit = limit * gradient + sqrt(limit)
+ *   limit = (1 - smoothing) * limit + smoothing * newLimit
+ * i.e. as long as the recent latency stays close to the minimum latency, the
+ * limit grows by sqrt(limit) per interval, and it shrinks proportionally to
+ * the latency degradation otherwise.
+ *
+ * The limit only grows if the server actually used at least half of it
+ * during the interval, so that an idle server doesn't end up with an
+ * unbounded limit.
+ */
+template <class Clock = std::chrono::steady_clock>
+class AdaptiveConcurrencyController : public AdmissionController {
+ public:
+  using Duration = typename Clock::duration;
+  using TimePoint = typename Clock::time_point;
+
+  struct Config {
+    size_t initialLimit{20};
+    size_t minLimit{1};
+    size_t maxLimit{1000};
+    // How much latency increase is tolerated before the limit is decreased
+    double tolerance{1.5};
+    // Weight of the new limit estimation in the smoothed limit
+    double smoothing{0.2};
+    Duration sampleInterval{std::chrono::milliseconds(100)};
+    Duration minLatencyWindow{std::chrono::seconds(30)};
+  };
+
+  AdaptiveConcurrencyController() : AdaptiveConcurrencyController(Config()) {}
+
+  explicit AdaptiveConcurrencyController(Config config)
+      : config_(std::move(config)),
+        limit_(clampLimit(config_.initialLimit)),
+        nextUpdate_(Clock::now() + config_.sampleInterval),
+        minLatencyReset_(Clock::now() + config_.minLatencyWindow) {
+    CHECK_GE(config_.maxLimit, config_.minLimit);
+    CHECK_GE(config_.tolerance, 1.0);
+    CHECK(config_.smoothing > 0.0 && config_.smoothing <= 1.0);
+    publishedLimit_.store(
+        static_cast<int64_t>(limit_), std::memory_order_relaxed);
+  }
+
+  ~AdaptiveConcurrencyController() override {}
+
+  /**
+   * Return true if the message should be admitted, in which case it is
+   * accounted for as inflight until its response is returned (or it is
+   * dropped).
+   */
+  bool admit() override {
+    const auto limit = publishedLimit_.load(std::memory_order_relaxed);
+    const auto inflight = inflight_.fetch_add(1, std::memory_order_relaxed);
+    if (inflight >= limit) {
+      inflight_.fetch_sub(1, std::memory_order_relaxed);
+      FB_LOG_EVERY_MS(INFO, 1000) << "LoadShedding: inflight(" << inflight
+                                  << ") >= limit(" << limit << ")";
+      return false;
+    }
+    auto maxInflight = maxInflight_.load(std::memory_order_relaxed);
+    while (inflight + 1 > maxInflight &&
+           !maxInflight_.compare_exchange_weak(
+               maxInflight, inflight + 1, std::memory_order_relaxed)) {
+    }
+    return true;
+  }
+
+  /**
+   * The request stays inflight while it is processed, there is nothing to do.
+   */
+  void dequeue() override {}
+
+  void dropped() override {
+    inflight_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void returnedResponse(std::chrono::nanoseconds latency) override {
+    inflight_.fetch_sub(1, std::memory_order_relaxed);
+    const auto latencyUs =
+        std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+    latencySumUs_.fetch_add(latencyUs, std::memory_order_relaxed);
+    latencyCount_.fetch_add(1, std::memory_order_relaxed);
+    auto minLatency = intervalMinLatencyUs_.load(std::memory_order_relaxed);
+    while (latencyUs < minLatency &&
+           !intervalMinLatencyUs_.compare_exchange_weak(
+               minLatency, latencyUs, std::memory_order_relaxed)) {
+    }
+    maybeUpdate(Clock::now());
+  }
+
+  /**
+   * Current concurrency limit
+   */
+  size_t getLimit() const {
+    return publishedLimit_.load(std::memory_order_relaxed);
+  }
+
+  size_t getInflight() const {
+    return std::max<int64_t>(0, inflight_.load(std::memory_order_relaxed));
+  }
+
+  void reportMetrics(
+      const AdmissionController::MetricReportFn& report,
+      const std::string& prefix,
+      const std::unordered_map<std::string, double>& metrics,
+      uint32_t count) override {
+    double minLatencyUs;
+    double recentLatencyUs;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      minLatencyUs = minLatencyUs_;
+      recentLatencyUs = recentLatencyUs_;
+    }
+    reportAggregate(
+        prefix + "concurrency_limit",
+        metrics,
+        report,
+        AdmissionController::AggregationType::SUM,
+        getLimit(),
+        count);
+    reportAggregate(
+        prefix + "inflight",
+        metrics,
+        report,
+        AdmissionController::AggregationType::SUM,
+        getInflight(),
+        count);
+    reportAggregate(
+        prefix + "min_latency_us",
+        metrics,
+        report,
+        AdmissionController::AggregationType::AVG,
+        minLatencyUs,
+        count);
+    reportAggregate(
+        prefix + "recent_latency_us",
+        metrics,
+        report,
+        AdmissionController::AggregationType::AVG,
+        recentLatencyUs,
+        count);
+  }
+
+ private:
+  /**
+   * Recompute the limit if the sample interval elapsed. Only one thread does
+   * it, the others simply keep accumulating samples.
+   */
+  void maybeUpdate(TimePoint now) {
+    std::unique_lock<std::mutex> guard(mutex_, std::try_to_lock);
+    if (!guard.owns_lock() || now < nextUpdate_) {
+      return;
+    }
+    nextUpdate_ = now + config_.sampleInterval;
+
+    const auto count = latencyCount_.exchange(0, std::memory_order_relaxed);
+    const auto sumUs = latencySumUs_.exchange(0, std::memory_order_relaxed);
+    const auto intervalMinUs = intervalMinLatencyUs_.exchange(
+        std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+    const auto maxInflight = maxInflight_.exchange(
+        inflight_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    if (count == 0) {
+      return;
+    }
+
+    // Periodically forget the minimum latency, so that the controller can
+    // adapt to a server which got permanently slower (e.g. new code path).
+    if (now >= minLatencyReset_) {
+      minLatencyReset_ = now + config_.minLatencyWindow;
+      minLatencyUs_ = 0;
+    }
+    const auto intervalMin = static_cast<double>(std::max<int64_t>(
+        1, intervalMinUs));
+    minLatencyUs_ =
+        minLatencyUs_ == 0 ? intervalMin : std::min(minLatencyUs_, intervalMin);
+    recentLatencyUs_ = std::max(1.0, static_cast<double>(sumUs) / count);
+
+    const auto gradient = std::max(
+        0.5,
+        std::min(1.0, config_.tolerance * minLatencyUs_ / recentLatencyUs_));
+    auto newLimit = limit_ * gradient + std::sqrt(limit_);
+    if (newLimit > limit_ && maxInflight < limit_ / 2) {
+      // The server is not using its current limit, we have no evidence that
+      // it can sustain more.
+      newLimit = limit_;
+    }
+    limit_ = clampLimit(
+        (1 - config_.smoothing) * limit_ + config_.smoothing * newLimit);
+    publishedLimit_.store(
+        static_cast<int64_t>(limit_), std::memory_order_relaxed);
+  }
+
+  double clampLimit(double limit) const {
+    return std::max<double>(
+        config_.minLimit, std::min<double>(config_.maxLimit, limit));
+  }
+
+  const Config config_;
+
+  // Updated on the request path without locking
+  std::atomic<int64_t> publishedLimit_{0};
+  std::atomic<int64_t> inflight_{0};
+  std::atomic<int64_t> maxInflight_{0};
+  std::atomic<int64_t> latencySumUs_{0};
+  std::atomic<int64_t> latencyCount_{0};
+  std::atomic<int64_t> intervalMinLatencyUs_{
+      std::numeric_limits<int64_t>::max()};
+
+  std::mutex mutex_;
+  // Accesses to the following members should lock mutex_
+  double limit_;
+  double minLatencyUs_{0};
+  double recentLatencyUs_{0};
+  TimePoint nextUpdate_;
+  TimePoint minLatencyReset_;
+};
+
+} // namespace thrift
+} // namespace apache
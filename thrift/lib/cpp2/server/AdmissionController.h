@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <string>
 #include <unordered_map>
@@ -45,6 +46,15 @@ class AdmissionController {
    */
   virtual void dequeue() = 0;
 
+  /**
+   * Indicate to the controller that an admitted request left the queue
+   * without being processed (e.g. it expired or its connection was closed).
+   * By default this is accounted for as a regular dequeue.
+   */
+  virtual void dropped() {
+    dequeue();
+  }
+
   /**
    * Indicate to the controller that the server has finished processing the
    * request, and it returned a response to the client.
@@ -61,6 +71,39 @@ class AdmissionController {
       const std::string& /*prefix*/,
       const std::unordered_map<std::string, double>& /*previousValues*/ = {},
       uint32_t /*previousValueCount*/ = 0) {}
+
+ protected:
+  /**
+   * Report the metrics and aggregate it with the previous value if metrics is
+   * non-empty.
+   * This can be useful for aggregating metrics accros similar admission
+   * controllers, e.g. the priority admission controller creates *many*
+   * sub-controllers (controller.A.1.xyz, controller.A.2.xyz, ...,
+   * controller.A.128.xyz)
+   * Those metrics are aggregated under controller.A.xyz
+   */
+  static void reportAggregate(
+      const std::string& metricName,
+      const std::unordered_map<std::string, double>& metrics,
+      const AdmissionController::MetricReportFn& report,
+      AdmissionController::AggregationType aggType,
+      double newValue,
+      uint32_t count) {
+    auto value = 0.0;
+    auto it = metrics.find(metricName);
+    if (it != metrics.end()) {
+      value = it->second;
+    }
+    switch (aggType) {
+      case AdmissionController::AggregationType::SUM:
+        value = value + newValue;
+        break;
+      case AdmissionController::AggregationType::AVG:
+        value = (value * (count - 1) + newValue) / std::max(1U, count);
+        break;
+    }
+    report(metricName, value);
+  }
 };
 
 class DenyAllAdmissionController : public AdmissionController {
@@ -41,6 +41,8 @@ using namespace apache::thrift::async;
 using namespace std;
 using std::shared_ptr;
 
+constexpr folly::StringPiece BaseThriftServer::kEventLoopLagLoadCounter;
+
 const size_t BaseThriftServer::T_ASYNC_DEFAULT_WORKER_THREADS =
     std::thread::hardware_concurrency();
 
@@ -142,6 +144,10 @@ int64_t BaseThriftServer::getLoad(const std::string& counter, bool check_custom)
     return getLoad_(counter);
   }
 
+  if (counter == kEventLoopLagLoadCounter) {
+    return getMaxEventLoopLag().count();
+  }
+
   const auto activeRequests = getActiveRequests();
 
   if (VLOG_IS_ON(1)) {
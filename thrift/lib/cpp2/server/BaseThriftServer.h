@@ -26,6 +26,7 @@
 #include <vector>
 
 #include <folly/Memory.h>
+#include <folly/Range.h>
 #include <folly/SocketAddress.h>
 #include <folly/Synchronized.h>
 #include <folly/io/async/EventBase.h>
@@ -223,6 +224,25 @@ class BaseThriftServer : public apache::thrift::concurrency::Runnable,
    */
   ServerAttribute<uint64_t> maxDebugPayloadMemoryPerWorker_{0x1000000}; // 16MB
 
+  /**
+   * The number of slowest recent requests each worker keeps with their timing
+   * breakdown, 0 disables the slow requests log.
+   */
+  ServerAttribute<size_t> slowRequestsLogSizePerWorker_{0};
+
+  /**
+   * How long a slow request stays in the log at least (and at most twice).
+   */
+  ServerAttribute<std::chrono::milliseconds> slowRequestsLogWindow_{
+      std::chrono::minutes(1)};
+
+  /**
+   * How often each IO thread measures its event loop lag, 0 disables the
+   * probe.
+   */
+  ServerAttribute<std::chrono::milliseconds> eventLoopProbeInterval_{
+      std::chrono::milliseconds(0)};
+
  protected:
   //! The server's listening address
   folly::SocketAddress address_;
@@ -466,6 +486,11 @@ class BaseThriftServer : public apache::thrift::concurrency::Runnable,
     useClientTimeout_.set(useClientTimeout, source);
   }
 
+  // Load counter reporting the highest IO event loop lag (us) instead of the
+  // number of active requests, see setEventLoopProbeInterval.
+  static constexpr folly::StringPiece kEventLoopLagLoadCounter =
+      "event_loop_lag_us";
+
   // Get load of the server.
   int64_t getLoad(const std::string& counter = "", bool check_custom = true)
       const final;
@@ -875,6 +900,14 @@ class BaseThriftServer : public apache::thrift::concurrency::Runnable,
     isOverloaded_ = std::move(isOverloaded);
   }
 
+  /**
+   * Whether a custom isOverloaded function is set. When it isn't, the read
+   * headers passed to isOverloaded() are unused.
+   */
+  bool hasIsOverloaded() const {
+    return static_cast<bool>(isOverloaded_);
+  }
+
   void setGetLoad(std::function<int64_t(const std::string&)> getLoad) {
     getLoad_ = getLoad;
   }
@@ -946,7 +979,7 @@ class BaseThriftServer : public apache::thrift::concurrency::Runnable,
   /**
    * Return the admission strategy associated with the Thrift Server
    */
-  std::shared_ptr<AdmissionStrategy> getAdmissionStrategy() const {
+  std::shared_ptr<AdmissionStrategy> getAdmissionStrategy() const final {
     return admissionStrategy_.get();
   }
 
@@ -991,6 +1024,61 @@ class BaseThriftServer : public apache::thrift::concurrency::Runnable,
     CHECK(configMutable());
     maxDebugPayloadMemoryPerWorker_.set(limit, source);
   }
+
+  /**
+   * Return the number of slowest recent requests logged by each worker.
+   */
+  size_t getSlowRequestsLogSizePerWorker() const {
+    return slowRequestsLogSizePerWorker_.get();
+  }
+
+  /**
+   * Set the number of slowest recent requests logged by each worker, see
+   * ThriftServer::snapshotSlowRequests. 0 (default) disables the log.
+   */
+  void setSlowRequestsLogSizePerWorker(
+      size_t size,
+      AttributeSource source = AttributeSource::OVERRIDE) {
+    CHECK(configMutable());
+    slowRequestsLogSizePerWorker_.set(size, source);
+  }
+
+  std::chrono::milliseconds getSlowRequestsLogWindow() const {
+    return slowRequestsLogWindow_.get();
+  }
+
+  /**
+   * Set how long a slow request stays in the log at least.
+   */
+  void setSlowRequestsLogWindow(
+      std::chrono::milliseconds window,
+      AttributeSource source = AttributeSource::OVERRIDE) {
+    CHECK(configMutable());
+    slowRequestsLogWindow_.set(window, source);
+  }
+
+  std::chrono::milliseconds getEventLoopProbeInterval() const {
+    return eventLoopProbeInterval_.get();
+  }
+
+  /**
+   * Set how often each IO thread measures its event loop lag and busy ratio,
+   * see ThriftServer::getEventLoopStats. 0 (default) disables the probe.
+   */
+  void setEventLoopProbeInterval(
+      std::chrono::milliseconds interval,
+      AttributeSource source = AttributeSource::OVERRIDE) {
+    CHECK(configMutable());
+    eventLoopProbeInterval_.set(interval, source);
+  }
+
+  /**
+   * The highest event loop lag last measured by the IO threads, zero if the
+   * probe is disabled. Also reported by getLoad(kEventLoopLagLoadCounter).
+   */
+  virtual std::chrono::microseconds getMaxEventLoopLag() const {
+    return std::chrono::microseconds::zero();
+  }
 };
 } // namespace thrift
 } // namespace apache
@@ -18,6 +18,8 @@
 
 #include <folly/String.h>
 
+#include <thrift/lib/cpp2/async/RequestDeadline.h>
+
 #ifdef __APPLE__
 #include <sys/ucred.h> // @manual
 #endif
@@ -90,5 +92,27 @@ folly::Optional<std::string> Cpp2ConnContext::PeerCred::getError() const {
   }
 }
 
+folly::Optional<std::chrono::system_clock::time_point>
+Cpp2RequestContext::computeDeadline() const {
+  folly::Optional<std::chrono::system_clock::time_point> deadline;
+  if (!header_) {
+    return deadline;
+  }
+  auto propagated = header_->getDeadline();
+  if (propagated > std::chrono::milliseconds(0)) {
+    deadline = RequestDeadline::fromEpochMs(propagated) +
+        RequestDeadline::clockSkewTolerance();
+    deadlinePropagated_ = true;
+  }
+  auto clientTimeout = header_->getClientTimeout();
+  if (clientTimeout > std::chrono::milliseconds(0)) {
+    auto timeoutDeadline = receivedTime_ + clientTimeout;
+    if (!deadline || timeoutDeadline < *deadline) {
+      deadline = timeoutDeadline;
+    }
+  }
+  return deadline;
+}
+
 } // namespace thrift
 } // namespace apache
@@ -17,6 +17,7 @@
 #ifndef THRIFT_ASYNC_CPP2CONNCONTEXT_H_
 #define THRIFT_ASYNC_CPP2CONNCONTEXT_H_ 1
 
+#include <chrono>
 #include <memory>
 
 #include <folly/Optional.h>
@@ -304,7 +305,8 @@ class Cpp2RequestContext : public apache::thrift::server::TConnectionContext {
       : TConnectionContext(header),
         ctx_(ctx),
         requestData_(nullptr, no_op_destructor),
-        startedProcessing_(false) {}
+        startedProcessing_(false),
+        receivedTime_(std::chrono::system_clock::now()) {}
 
   void setConnectionContext(Cpp2ConnContext* ctx) {
     ctx_ = ctx;
@@ -380,6 +382,33 @@ class Cpp2RequestContext : public apache::thrift::server::TConnectionContext {
     requestTimeout_ = requestTimeout;
   }
 
+  /**
+   * Absolute time after which the caller won't wait for the response anymore:
+   * the deadline propagated by the caller if any (relaxed by the tolerated
+   * clock skew), capped by the client timeout counted from the reception of
+   * the request.
+   */
+  const folly::Optional<std::chrono::system_clock::time_point>& getDeadline()
+      const {
+    if (!deadlineComputed_) {
+      deadline_ = computeDeadline();
+      deadlineComputed_ = true;
+    }
+    return deadline_;
+  }
+
+  // Whether the caller propagated its deadline, which is then forwarded to
+  // the calls made on behalf of this request
+  bool isDeadlinePropagated() const {
+    getDeadline();
+    return deadlinePropagated_;
+  }
+
+  bool isDeadlineExceeded() const {
+    const auto& deadline = getDeadline();
+    return deadline && std::chrono::system_clock::now() >= *deadline;
+  }
+
   void setMethodName(std::string methodName) {
     methodName_ = std::move(methodName);
   }
@@ -408,9 +437,16 @@ class Cpp2RequestContext : public apache::thrift::server::TConnectionContext {
   static void no_op_destructor(void* /*ptr*/) {}
 
  private:
+  folly::Optional<std::chrono::system_clock::time_point> computeDeadline()
+      const;
+
   Cpp2ConnContext* ctx_;
   RequestDataPtr requestData_;
   bool startedProcessing_ = false;
+  const std::chrono::system_clock::time_point receivedTime_;
+  mutable bool deadlineComputed_{false};
+  mutable bool deadlinePropagated_{false};
+  mutable folly::Optional<std::chrono::system_clock::time_point> deadline_;
   std::chrono::milliseconds requestTimeout_{0};
   folly::Optional<std::chrono::steady_clock::time_point> processingStartTime_;
   std::string methodName_;
@@ -138,14 +138,12 @@ void Cpp2Connection::setServerHeaders(
     request.getHeader()->setHeader("connection", "goaway");
   }
 
-  const auto& headers = request.getHeader()->getHeaders();
-  std::string loadHeaderFound;
-  auto it = headers.find(THeader::QUERY_LOAD_HEADER);
-  if (it != headers.end()) {
-    loadHeaderFound = it->second;
-  } else {
+  auto loadHeader =
+      request.getHeader()->getReadHeader(THeader::QUERY_LOAD_HEADER);
+  if (!loadHeader) {
     return;
   }
+  std::string loadHeaderFound = loadHeader->str();
 
   auto load = getWorker()->getServer()->getLoad(loadHeaderFound);
 
@@ -294,7 +292,10 @@ void Cpp2Connection::requestReceived(unique_ptr<ResponseChannelRequest>&& req) {
       hreq->getHeader()->getProtocolId());
   auto methodName =
       apache::thrift::detail::ap::deserializeMethodName(req, protoId);
-  if (server->isOverloaded(&hreq->getHeader()->getHeaders(), &methodName)) {
+  // Only build the read headers map for a custom isOverloaded function
+  auto readHeaders =
+      server->hasIsOverloaded() ? &hreq->getHeader()->getHeaders() : nullptr;
+  if (server->isOverloaded(readHeaders, &methodName)) {
     killRequest(
         *req,
         TApplicationException::TApplicationExceptionType::LOADSHEDDING,
@@ -347,6 +348,11 @@ void Cpp2Connection::requestReceived(unique_ptr<ResponseChannelRequest>&& req) {
   if (admissionController) {
     t2r->setAdmissionController(std::move(admissionController));
   }
+  auto* methodStats = server->getMethodStats();
+  if (methodStats || worker_->isSlowRequestsLogEnabled()) {
+    t2r->enableTimings(buf->computeChainDataLength());
+    t2r->setMethodStats(methodStats);
+  }
   auto up2r = std::unique_ptr<ResponseChannelRequest>(t2r);
   activeRequests_.insert(t2r);
   ++worker_->activeRequests_;
@@ -452,8 +458,14 @@ void Cpp2Connection::Cpp2Request::sendReply(
     auto* observer = connection_->getWorker()->getServer()->getObserver();
     auto maxResponseSize =
         connection_->getWorker()->getServer()->getMaxResponseSize();
-    if (maxResponseSize != 0 &&
-        buf->computeChainDataLength() > maxResponseSize) {
+    uint64_t responseSize = 0;
+    if (maxResponseSize != 0 || getTimings()) {
+      responseSize = buf->computeChainDataLength();
+    }
+    if (getTimings()) {
+      setResponseSent(responseSize);
+    }
+    if (maxResponseSize != 0 && responseSize > maxResponseSize) {
       req_->sendErrorWrapped(
           folly::make_exception_wrapper<TApplicationException>(
               TApplicationException::TApplicationExceptionType::INTERNAL_ERROR,
@@ -480,6 +492,9 @@ void Cpp2Connection::Cpp2Request::sendErrorWrapped(
   if (req_->isActive()) {
     setServerHeaders();
     markProcessEnd();
+    if (getTimings()) {
+      setResponseSent(0);
+    }
     auto* observer = connection_->getWorker()->getServer()->getObserver();
     req_->sendErrorWrapped(
         std::move(ew),
@@ -506,6 +521,14 @@ void Cpp2Connection::Cpp2Request::sendTimeoutResponse(
   cancelTimeout();
 }
 
+void Cpp2Connection::Cpp2Request::onDeadlineExceeded() {
+  auto server = connection_->getWorker()->getServer();
+  server->incDeadlineExceededRequests();
+  if (auto* observer = server->getObserver()) {
+    observer->deadlineExceeded();
+  }
+}
+
 void Cpp2Connection::Cpp2Request::TaskTimeout::timeoutExpired() noexcept {
   request_->req_->cancel();
   request_->sendTimeoutResponse(
@@ -566,6 +589,7 @@ void Cpp2Connection::Cpp2Request::setLatencyHeader(
 }
 
 Cpp2Connection::Cpp2Request::~Cpp2Request() {
+  recordMethodStats(reqContext_.getMethodName());
   connection_->removeRequest(this);
   cancelTimeout();
   if (--connection_->getWorker()->activeRequests_ == 0 &&
@@ -178,6 +178,7 @@ class Cpp2Connection : public ResponseChannel::Callback,
     void sendTimeoutResponse(
         apache::thrift::HeaderServerChannel::HeaderRequest::TimeoutResponseType
             responseType);
+    void onDeadlineExceeded() override;
 
     ~Cpp2Request() override;
 
@@ -298,12 +298,45 @@ wangle::AcceptorHandshakeHelper::UniquePtr Cpp2Worker::getHelper(
   }
 }
 
+Cpp2Worker::~Cpp2Worker() {
+  // The probe is normally stopped by requestStop(). Otherwise its timeout
+  // may only be cancelled in the IO thread, unless the loop has stopped.
+  if (eventLoopProbe_) {
+    auto evb = getEventBase();
+    if (evb && evb->isRunning()) {
+      evb->runImmediatelyOrRunInEventBaseThreadAndWait(
+          [&] { stopEventLoopProbe(); });
+    } else {
+      stopEventLoopProbe();
+    }
+  }
+}
+
+void Cpp2Worker::stopEventLoopProbe() {
+  if (eventLoopProbe_) {
+    server_->eventLoopProbes_.wlock()->erase(eventLoopProbe_.get());
+    eventLoopProbe_.reset();
+  }
+}
+
+void Cpp2Worker::startEventLoopProbe(folly::EventBase& eventBase) {
+  const auto interval = server_->getEventLoopProbeInterval();
+  if (interval <= std::chrono::milliseconds::zero()) {
+    return;
+  }
+  eventLoopProbe_ = std::make_unique<EventLoopProbe>(eventBase, interval);
+  eventBase.runImmediatelyOrRunInEventBaseThreadAndWait(
+      [&] { eventLoopProbe_->start(); });
+  server_->eventLoopProbes_.wlock()->insert(eventLoopProbe_.get());
+}
+
 void Cpp2Worker::requestStop() {
   getEventBase()->runInEventBaseThreadAndWait([&] {
     if (stopping_) {
       return;
     }
     stopping_ = true;
+    stopEventLoopProbe();
     if (activeRequests_ == 0) {
       stopBaton_.post();
     }
@@ -25,6 +25,7 @@
 #include <thrift/lib/cpp/async/TAsyncSSLSocket.h>
 #include <thrift/lib/cpp2/security/FizzPeeker.h>
 #include <thrift/lib/cpp2/server/ActiveRequestsRegistry.h>
+#include <thrift/lib/cpp2/server/EventLoopProbe.h>
 #include <thrift/lib/cpp2/server/ThriftServer.h>
 #include <thrift/lib/cpp2/server/peeking/TLSHelper.h>
 #include <wangle/acceptor/Acceptor.h>
@@ -122,6 +123,10 @@ class Cpp2Worker : public wangle::Acceptor,
     return requestsRegistry_;
   }
 
+  bool isSlowRequestsLogEnabled() const {
+    return requestsRegistry_->isSlowRequestsLogEnabled();
+  }
+
   bool isStopping() {
     return stopping_;
   }
@@ -136,7 +141,9 @@ class Cpp2Worker : public wangle::Acceptor,
         activeRequests_(0),
         requestsRegistry_(std::make_shared<ActiveRequestsRegistry>(
             server_->getMaxDebugPayloadMemoryPerRequest(),
-            server_->getMaxDebugPayloadMemoryPerWorker())) {
+            server_->getMaxDebugPayloadMemoryPerWorker(),
+            server_->getSlowRequestsLogSizePerWorker(),
+            server_->getSlowRequestsLogWindow())) {
     setGracefulShutdownTimeout(server->workersJoinTimeout_);
   }
 
@@ -161,6 +168,8 @@ class Cpp2Worker : public wangle::Acceptor,
     if (observer) {
       eventBase->setObserver(observer);
     }
+
+    startEventLoopProbe(*eventBase);
   }
 
   void onNewConnection(
@@ -182,6 +191,8 @@ class Cpp2Worker : public wangle::Acceptor,
       wangle::SecureTransportType secureTransportType,
       wangle::TransportInfo& tinfo) override;
 
+  ~Cpp2Worker() override;
+
   void requestStop();
 
   void waitForStop(std::chrono::system_clock::time_point deadline);
@@ -233,8 +244,13 @@ class Cpp2Worker : public wangle::Acceptor,
   void useExistingChannel(
       const std::shared_ptr<HeaderServerChannel>& serverChannel);
 
+  void startEventLoopProbe(folly::EventBase& eventBase);
+  // Must run in the IO thread, or once its loop stopped
+  void stopEventLoopProbe();
+
   uint32_t activeRequests_;
   std::shared_ptr<ActiveRequestsRegistry> requestsRegistry_;
+  std::unique_ptr<EventLoopProbe> eventLoopProbe_;
   bool stopping_{false};
   folly::Baton<> stopBaton_;
 
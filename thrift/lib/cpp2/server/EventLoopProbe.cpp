@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrift/lib/cpp2/server/EventLoopProbe.h>
+
+#include <algorithm>
+
+#include <folly/portability/Time.h>
+
+namespace apache {
+namespace thrift {
+
+namespace {
+
+std::chrono::nanoseconds threadCpuTime() {
+  timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+    return std::chrono::nanoseconds(0);
+  }
+  return std::chrono::seconds(ts.tv_sec) +
+      std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+} // namespace
+
+EventLoopProbe::EventLoopProbe(
+    folly::EventBase& evb,
+    std::chrono::milliseconds interval)
+    : folly::AsyncTimeout(&evb), interval_(interval) {}
+
+void EventLoopProbe::start() {
+  lastWallTime_ = std::chrono::steady_clock::now();
+  lastCpuTime_ = threadCpuTime();
+  schedule();
+}
+
+void EventLoopProbe::schedule() {
+  expected_ = std::chrono::steady_clock::now() + interval_;
+  scheduleTimeout(interval_);
+}
+
+void EventLoopProbe::timeoutExpired() noexcept {
+  const auto now = std::chrono::steady_clock::now();
+  const auto lag = std::max<int64_t>(
+      0,
+      std::chrono::duration_cast<std::chrono::microseconds>(now - expected_)
+          .count());
+  lagUs_.record(lag);
+  lastLagUs_.store(lag, std::memory_order_relaxed);
+
+  const auto cpuTime = threadCpuTime();
+  const auto wallTime = now - lastWallTime_;
+  if (wallTime.count() > 0) {
+    busyRatio_.store(
+        std::min(
+            1.0,
+            static_cast<double>((cpuTime - lastCpuTime_).count()) /
+                std::chrono::duration_cast<std::chrono::nanoseconds>(wallTime)
+                    .count()),
+        std::memory_order_relaxed);
+  }
+  lastWallTime_ = now;
+  lastCpuTime_ = cpuTime;
+
+  schedule();
+}
+
+EventLoopProbe::Stats EventLoopProbe::getStats() const {
+  Stats stats;
+  lagUs_.addTo(stats.lagUs);
+  stats.lastLag = getLastLag();
+  stats.busyRatio = busyRatio_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+} // namespace thrift
+} // namespace apache
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+#include <folly/io/async/AsyncTimeout.h>
+#include <folly/io/async/EventBase.h>
+
+#include <thrift/lib/cpp/util/LogLinearHistogram.h>
+
+namespace apache {
+namespace thrift {
+
+/**
+ * Periodically measures how late an IO thread runs its callbacks (the event
+ * loop lag) and how busy it is.
+ *
+ * Every interval the probe schedules a timeout and records how late it fired:
+ * a loop blocked by a slow handler or saturated with work delays every
+ * request waiting on this thread by about as much. The busy ratio is the CPU
+ * time used by the thread over the last interval.
+ *
+ * The probe must be started and destroyed in its event base thread, its
+ * stats can be read from any thread.
+ */
+class EventLoopProbe : private folly::AsyncTimeout {
+ public:
+  struct Stats {
+    // Lag of every probe so far, in microseconds
+    util::LogLinearHistogram lagUs;
+    // Lag of the last probe
+    std::chrono::microseconds lastLag{0};
+    // CPU time over wall time during the last interval, in [0, 1]
+    double busyRatio{0};
+  };
+
+  EventLoopProbe(folly::EventBase& evb, std::chrono::milliseconds interval);
+
+  void start();
+
+  Stats getStats() const;
+
+  std::chrono::microseconds getLastLag() const {
+    return std::chrono::microseconds(
+        lastLagUs_.load(std::memory_order_relaxed));
+  }
+
+ private:
+  void timeoutExpired() noexcept override;
+  void schedule();
+
+  const std::chrono::milliseconds interval_;
+  std::chrono::steady_clock::time_point expected_;
+  std::chrono::steady_clock::time_point lastWallTime_;
+  std::chrono::nanoseconds lastCpuTime_{0};
+
+  util::LogLinearHistogram::Recorder lagUs_;
+  std::atomic<int64_t> lastLagUs_{0};
+  std::atomic<double> busyRatio_{0};
+};
+
+} // namespace thrift
+} // namespace apache
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrift/lib/cpp2/server/MethodStats.h>
+
+#include <algorithm>
+
+#include <folly/Likely.h>
+
+namespace apache {
+namespace thrift {
+
+void MethodStats::merge(const MethodStats& other) {
+  queueTimeUs.merge(other.queueTimeUs);
+  processTimeUs.merge(other.processTimeUs);
+  requestBytes.merge(other.requestBytes);
+  responseBytes.merge(other.responseBytes);
+}
+
+void ServerMethodStats::Recorders::addTo(MethodStats& stats) const {
+  queueTimeUs.addTo(stats.queueTimeUs);
+  processTimeUs.addTo(stats.processTimeUs);
+  requestBytes.addTo(stats.requestBytes);
+  responseBytes.addTo(stats.responseBytes);
+}
+
+ServerMethodStats::Shard::~Shard() {
+  std::lock_guard<std::mutex> guard(parent.orphansMutex_);
+  for (const auto& entry : methods) {
+    entry.second->addTo(parent.orphans_[entry.first]);
+  }
+}
+
+ServerMethodStats::ServerMethodStats()
+    : shards_([this] { return new Shard(*this); }) {}
+
+ServerMethodStats::~ServerMethodStats() {}
+
+void ServerMethodStats::record(
+    const std::string& methodName,
+    const Sample& sample) {
+  auto& shard = *shards_;
+  Recorders* recorders;
+  auto it = shard.methods.find(methodName);
+  if (LIKELY(it != shard.methods.end())) {
+    recorders = it->second.get();
+  } else {
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    recorders = shard.methods
+                    .emplace(methodName, std::make_unique<Recorders>())
+                    .first->second.get();
+  }
+  recorders->queueTimeUs.record(std::max<int64_t>(0, sample.queueTime.count()));
+  recorders->processTimeUs.record(
+      std::max<int64_t>(0, sample.processTime.count()));
+  recorders->requestBytes.record(sample.requestBytes);
+  recorders->responseBytes.record(sample.responseBytes);
+}
+
+folly::F14FastMap<std::string, MethodStats> ServerMethodStats::getStats()
+    const {
+  // Read the orphans first: a thread exiting concurrently may be missed by
+  // this read, but it is never counted twice.
+  folly::F14FastMap<std::string, MethodStats> stats;
+  {
+    std::lock_guard<std::mutex> guard(orphansMutex_);
+    stats = orphans_;
+  }
+  for (auto& shard : shards_.accessAllThreads()) {
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    for (const auto& entry : shard.methods) {
+      entry.second->addTo(stats[entry.first]);
+    }
+  }
+  return stats;
+}
+
+} // namespace thrift
+} // namespace apache
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <folly/ThreadLocal.h>
+#include <folly/container/F14Map.h>
+
+#include <thrift/lib/cpp/util/LogLinearHistogram.h>
+
+namespace apache {
+namespace thrift {
+
+/**
+ * Aggregated statistics of one method, times are in microseconds.
+ */
+struct MethodStats {
+  util::LogLinearHistogram queueTimeUs;
+  util::LogLinearHistogram processTimeUs;
+  util::LogLinearHistogram requestBytes;
+  util::LogLinearHistogram responseBytes;
+
+  void merge(const MethodStats& other);
+};
+
+/**
+ * Per-method latency and size statistics of a server.
+ *
+ * Every thread recording samples has its own set of histograms, so that the
+ * request path never takes a lock nor writes to a shared cache line (the
+ * per-thread lock is only taken the first time a thread sees a method).
+ * Statistics are aggregated when they are read.
+ *
+ * Only requests which started processing are recorded: requests for unknown
+ * methods never create histograms.
+ */
+class ServerMethodStats {
+ public:
+  struct Sample {
+    std::chrono::microseconds queueTime;
+    std::chrono::microseconds processTime;
+    uint64_t requestBytes;
+    uint64_t responseBytes;
+  };
+
+  ServerMethodStats();
+  ~ServerMethodStats();
+
+  void record(const std::string& methodName, const Sample& sample);
+
+  /**
+   * Aggregate the statistics of every thread, since the creation of the
+   * server.
+   */
+  folly::F14FastMap<std::string, MethodStats> getStats() const;
+
+ private:
+  struct Recorders {
+    util::LogLinearHistogram::Recorder queueTimeUs;
+    util::LogLinearHistogram::Recorder processTimeUs;
+    util::LogLinearHistogram::Recorder requestBytes;
+    util::LogLinearHistogram::Recorder responseBytes;
+
+    void addTo(MethodStats& stats) const;
+  };
+
+  /**
+   * Histograms of one thread. The map is only modified by its thread, under
+   * `mutex`, which lets that thread look methods up without locking. The
+   * statistics of an exiting thread are handed over to `orphans_`.
+   */
+  struct Shard {
+    explicit Shard(ServerMethodStats& stats) : parent(stats) {}
+    ~Shard();
+
+    std::mutex mutex;
+    folly::F14FastMap<std::string, std::unique_ptr<Recorders>> methods;
+    ServerMethodStats& parent;
+  };
+
+  struct ShardTag {};
+
+  mutable std::mutex orphansMutex_;
+  // orphans_ must outlive shards_, see Shard::~Shard
+  folly::F14FastMap<std::string, MethodStats> orphans_;
+  mutable folly::ThreadLocal<Shard, ShardTag> shards_;
+};
+
+} // namespace thrift
+} // namespace apache
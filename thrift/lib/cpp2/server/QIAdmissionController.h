@@ -17,12 +17,15 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <mutex>
 #include <thread>
 
 #include <glog/logging.h>
 
+#include <folly/ThreadLocal.h>
+#include <folly/lang/Align.h>
 #include <folly/stats/BucketedTimeSeries.h>
 #include <thrift/lib/cpp2/async/ResponseChannel.h>
 #include <thrift/lib/cpp2/server/AdmissionController.h>
@@ -35,12 +38,14 @@ namespace thrift {
  * This admission controller uses the Q-Integral algorithm to shed load based on
  * the length of the queue of unprocessed messages.
  *
- * It is configured by three parameters (two of them have reasonable defaults)
+ * It is configured by four parameters (three of them have reasonable defaults)
  * - `processTimeout` indicates the avergae latency the server wants to stay
  *    below
  * - `window` indicates the sliding window on which the statistics are computed
  * - `minQueueLength` indicates the minimum size of the queue, the server will
  *    never decrease the queue limit below that value.
+ * - `aggregationInterval` indicates how often the per-thread counters are
+ *    folded into the statistics and the queue limit is recomputed.
  *
  * It works by measuring the rate of responses and using it to
  * dynamically configure the maximum number of queued messages. It also
@@ -49,6 +54,13 @@ namespace thrift {
  *
  * It is somewhat inspired by a PID controller which would be continuously
  * and dynamically tuned (without a derivative component).
+ *
+ * The request path (admit/dequeue/returnedResponse) doesn't take any lock:
+ * events are recorded in per-thread counters, and one of the admitting
+ * threads periodically aggregates them and publishes a new queue limit. The
+ * integral stays exact because every event records its timestamp; only the
+ * queue size itself is a shared atomic, so that admission decisions are made
+ * against the real number of queued requests.
  */
 template <class Clock = std::chrono::steady_clock>
 class QIAdmissionController : public AdmissionController {
@@ -61,30 +73,39 @@ class QIAdmissionController : public AdmissionController {
   explicit QIAdmissionController(
       Duration processTimeout,
       Duration window = std::chrono::seconds(10),
-      size_t minQueueLength = 10)
+      size_t minQueueLength = 10,
+      Duration aggregationInterval = std::chrono::milliseconds(10))
       : windowSec_(toDoubleSecond(window)),
         processTimeoutSec_(toDoubleSecond(processTimeout)),
         minQueueLength_(minQueueLength),
+        aggregationIntervalUs_(toMicroseconds(aggregationInterval)),
+        start_(Clock::now()),
+        shards_([this] { return new Shard(orphans_); }),
         outgoingRate_(folly::BucketedTimeSeries<double, Clock>(128U, window)),
-        integral_(folly::BucketedTimeSeries<double, Clock>(128U, window)),
-        queueSize_(0) {}
+        integral_(folly::BucketedTimeSeries<double, Clock>(128U, window)) {
+    queueLimit_.store(getQueueLimit(), std::memory_order_relaxed);
+  }
 
   /**
    * Return true if the message should be admitted.
    * If true is returned, the queue size has been incremented, otherwise the
    * queueSize is unchanged.
+   *
+   * The limit check and the increment are not atomic with each other, so
+   * concurrent admissions may overshoot the limit by (at most) the number of
+   * admitting threads.
    */
   bool admit() override {
-    std::lock_guard<std::mutex> guard(mutex_);
-    auto now = Clock::now();
-    updateIntegral(queueSize_, now);
-    const auto qLimit = getQueueLimit();
-    if (queueSize_ >= qLimit) {
-      FB_LOG_EVERY_MS(INFO, 1000) << "LoadShedding: q(" << queueSize_
+    const auto now = Clock::now();
+    maybeAggregate(now);
+    const auto queueSize = queueSize_.load(std::memory_order_relaxed);
+    const auto qLimit = queueLimit_.load(std::memory_order_relaxed);
+    if (queueSize >= qLimit) {
+      FB_LOG_EVERY_MS(INFO, 1000) << "LoadShedding: q(" << queueSize
                                   << ") >= qlimit(" << qLimit << ")";
       return reject();
     }
-    return accept();
+    return accept(now);
   }
 
   /**
@@ -92,11 +113,12 @@ class QIAdmissionController : public AdmissionController {
    * currently processing it.
    */
   void dequeue() override {
-    std::lock_guard<std::mutex> guard(mutex_);
-    auto now = Clock::now();
-    CHECK(queueSize_ >= 1);
-    updateIntegral(queueSize_, now);
-    queueSize_ -= 1;
+    const auto now = Clock::now();
+    const auto previous = queueSize_.fetch_sub(1, std::memory_order_relaxed);
+    DCHECK_GE(previous, 1);
+    auto& shard = *shards_;
+    increment(shard.dequeued, 1);
+    increment(shard.dequeuedTimeSumUs, sinceStartUs(now));
   }
 
   /**
@@ -104,9 +126,7 @@ class QIAdmissionController : public AdmissionController {
    * request, and it returned a response to the client.
    */
   void returnedResponse(std::chrono::nanoseconds) override {
-    auto now = Clock::now();
-    std::lock_guard<std::mutex> guard(mutex_);
-    outgoingRate_.addValue(now, 1.0);
+    increment(shards_->responses, 1);
   }
 
  private:
@@ -115,7 +135,7 @@ class QIAdmissionController : public AdmissionController {
   }
 
   size_t getQueueSize() const {
-    return queueSize_;
+    return std::max<int64_t>(0, queueSize_.load(std::memory_order_relaxed));
   }
 
   double getIntegral() const {
@@ -167,6 +187,7 @@ class QIAdmissionController : public AdmissionController {
       uint32_t count) override {
     // acquire the mutex to avoid other threads udpating them while reporting
     std::lock_guard<std::mutex> guard(mutex_);
+    aggregate(Clock::now());
 
     // Except `integral_ratio`, all of the aggregations below use sum,
     // because the requests are dispatched to each admission controller, thus
@@ -217,56 +238,124 @@ class QIAdmissionController : public AdmissionController {
   }
 
  private:
+  /**
+   * Event counters, timestamps are in microseconds since the creation of the
+   * controller. They are drained (reset to zero) on every aggregation, which
+   * keeps the timestamp sums far away from overflowing.
+   */
+  struct Counters {
+    std::atomic<uint64_t> admitted{0};
+    std::atomic<uint64_t> admittedTimeSumUs{0};
+    std::atomic<uint64_t> dequeued{0};
+    std::atomic<uint64_t> dequeuedTimeSumUs{0};
+    std::atomic<uint64_t> responses{0};
+
+    void drainInto(Counters& into) {
+      increment(into.admitted, drain(admitted));
+      increment(into.admittedTimeSumUs, drain(admittedTimeSumUs));
+      increment(into.dequeued, drain(dequeued));
+      increment(into.dequeuedTimeSumUs, drain(dequeuedTimeSumUs));
+      increment(into.responses, drain(responses));
+    }
+  };
+
+  /**
+   * Per-thread counters. Only the owning thread increments them, so the
+   * atomic operations are uncontended; the counters of an exiting thread are
+   * handed over to `orphans_` so that no event is lost.
+   */
+  struct alignas(folly::hardware_destructive_interference_size) Shard
+      : Counters {
+    explicit Shard(Counters& orphans) : orphans_(orphans) {}
+
+    ~Shard() {
+      this->drainInto(orphans_);
+    }
+
+    Counters& orphans_;
+  };
+
+  struct ShardTag {};
+
   bool reject() {
     return false;
   }
 
-  bool accept() {
-    queueSize_ += 1;
+  bool accept(TimePoint now) {
+    queueSize_.fetch_add(1, std::memory_order_relaxed);
+    auto& shard = *shards_;
+    increment(shard.admitted, 1);
+    increment(shard.admittedTimeSumUs, sinceStartUs(now));
     return true;
   }
 
   /**
-   * Report the metrics and aggregate it with the previous value if metrics is
-   * non-empty.
-   * This can be useful for aggregating metrics accros similar admission
-   * controllers, e.g. the priority admission controller creates *many*
-   * sub-controllers (controller.A.1.xyz, controller.A.2.xyz, ...,
-   * controller.A.128.xyz)
-   * Those metrics are aggregated under controller.A.xyz
+   * Aggregate the per-thread counters if the aggregation interval elapsed.
+   * Only the thread which advances `nextAggregationUs_` does the work, all the
+   * others keep using the last published queue limit.
    */
-  void reportAggregate(
-      const std::string& metricName,
-      const std::unordered_map<std::string, double>& metrics,
-      const AdmissionController::MetricReportFn& report,
-      AdmissionController::AggregationType aggType,
-      double newValue,
-      uint32_t count) {
-    auto value = 0.0;
-    auto it = metrics.find(metricName);
-    if (it != metrics.end()) {
-      value = it->second;
-    }
-    switch (aggType) {
-      case AdmissionController::AggregationType::SUM:
-        value = value + newValue;
-        break;
-      case AdmissionController::AggregationType::AVG:
-        value = (value * (count - 1) + newValue) / std::max(1U, count);
-        break;
+  void maybeAggregate(TimePoint now) {
+    const auto nowUs = sinceStartUs(now);
+    auto next = nextAggregationUs_.load(std::memory_order_relaxed);
+    if (nowUs < next ||
+        !nextAggregationUs_.compare_exchange_strong(
+            next, nowUs + aggregationIntervalUs_, std::memory_order_relaxed)) {
+      return;
     }
-    report(metricName, value);
+    std::lock_guard<std::mutex> guard(mutex_);
+    aggregate(now);
   }
 
   /**
-   * Update the integral value with the queue value for the last interval
+   * Fold all the per-thread counters into the time series, and publish the
+   * new queue limit. mutex_ must be held.
    */
-  void updateIntegral(
-      size_t valueForLastInterval,
-      typename Clock::time_point now) {
-    double dt =
-        std::chrono::duration<double>(now - integral_.getLatestTime()).count();
-    integral_.addValue(now, valueForLastInterval * dt);
+  void aggregate(TimePoint now) {
+    // Another aggregation with a later timestamp may have won the mutex.
+    now = std::max(now, lastAggregation_);
+    Counters delta;
+    orphans_.drainInto(delta);
+    for (auto& shard : shards_.accessAllThreads()) {
+      shard.drainInto(delta);
+    }
+
+    const auto nowUs = static_cast<double>(sinceStartUs(now));
+    const auto lastUs = static_cast<double>(sinceStartUs(lastAggregation_));
+    const auto admitted = delta.admitted.load(std::memory_order_relaxed);
+    const auto dequeued = delta.dequeued.load(std::memory_order_relaxed);
+
+    // The integral of the queue size over (lastAggregation_, now] is the
+    // queue size at the previous aggregation over the whole interval, plus
+    // the contribution of every admission (resp. dequeue) from the time it
+    // happened until now.
+    // Events recorded concurrently with this aggregation are accounted for in
+    // the next one, which keeps the integral exact over consecutive intervals.
+    double integralUs = aggregatedQueueSize_ * (nowUs - lastUs);
+    integralUs += admitted * nowUs -
+        delta.admittedTimeSumUs.load(std::memory_order_relaxed);
+    integralUs -= dequeued * nowUs -
+        delta.dequeuedTimeSumUs.load(std::memory_order_relaxed);
+    aggregatedQueueSize_ += static_cast<int64_t>(admitted) -
+        static_cast<int64_t>(dequeued);
+
+    integral_.addValue(now, integralUs / 1e6);
+    outgoingRate_.addValue(
+        now, delta.responses.load(std::memory_order_relaxed));
+    lastAggregation_ = now;
+
+    queueLimit_.store(getQueueLimit(), std::memory_order_relaxed);
+  }
+
+  uint64_t sinceStartUs(TimePoint now) const {
+    return now > start_ ? toMicroseconds(now - start_) : 0;
+  }
+
+  static void increment(std::atomic<uint64_t>& counter, uint64_t value) {
+    counter.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  static uint64_t drain(std::atomic<uint64_t>& counter) {
+    return counter.exchange(0, std::memory_order_relaxed);
   }
 
   static double toDoubleSecond(Duration duration) {
@@ -274,15 +363,31 @@ class QIAdmissionController : public AdmissionController {
         .count();
   }
 
+  static uint64_t toMicroseconds(Duration duration) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration)
+        .count();
+  }
+
   const double windowSec_;
   const double processTimeoutSec_;
   const double minQueueLength_;
+  const uint64_t aggregationIntervalUs_;
+  const TimePoint start_;
+
+  // Updated on the request path without locking
+  std::atomic<int64_t> queueSize_{0};
+  std::atomic<double> queueLimit_{0};
+  std::atomic<uint64_t> nextAggregationUs_{0};
+  // orphans_ must outlive shards_, see Shard::~Shard
+  Counters orphans_;
+  folly::ThreadLocal<Shard, ShardTag> shards_;
 
   std::mutex mutex_;
   // Accesses to the following members should lock mutex_
   folly::BucketedTimeSeries<double, Clock> outgoingRate_;
   folly::BucketedTimeSeries<double, Clock> integral_;
-  size_t queueSize_;
+  TimePoint lastAggregation_{start_};
+  int64_t aggregatedQueueSize_{0};
 };
 
 } // namespace thrift
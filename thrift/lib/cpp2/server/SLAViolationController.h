@@ -91,6 +91,10 @@ class SLAViolationController : public AdmissionController {
     innerController_.dequeue();
   }
 
+  void dropped() override {
+    innerController_.dropped();
+  }
+
   double ewma() {
     return slaRatio_.estimate();
   }
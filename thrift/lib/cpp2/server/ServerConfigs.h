@@ -18,15 +18,19 @@
 
 #include <atomic>
 #include <chrono>
+#include <memory>
 #include <string>
 
 #include <thrift/lib/cpp/server/TServerObserver.h>
 #include <thrift/lib/cpp/transport/THeader.h>
+#include <thrift/lib/cpp2/server/MethodStats.h>
 #include <thrift/lib/thrift/gen-cpp2/RpcMetadata_types.h>
 
 namespace apache {
 namespace thrift {
 
+class AdmissionStrategy;
+
 namespace server {
 
 /**
@@ -75,6 +79,9 @@ class ServerConfigs {
       const transport::THeader::StringToStringMap* readHeaders,
       const std::string* method) const = 0;
 
+  // @see BaseThriftServer::getAdmissionStrategy function.
+  virtual std::shared_ptr<AdmissionStrategy> getAdmissionStrategy() const = 0;
+
   /**
    * Add ability for ThriftServer to receive setup parameters from client on
    * connection establishment.
@@ -119,9 +126,40 @@ class ServerConfigs {
     }
   }
 
+  /**
+   * Number of requests dropped before processing because their deadline had
+   * already passed, i.e. work the server didn't do for callers which gave up.
+   */
+  void incDeadlineExceededRequests() {
+    deadlineExceededRequests_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  uint64_t getDeadlineExceededRequests() const {
+    return deadlineExceededRequests_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Enables the collection of per-method queue time, process time, request
+   * size and response size histograms, see ServerMethodStats.
+   *
+   * Must be called before spinning up the server.
+   */
+  void enableMethodStats() {
+    if (!methodStats_) {
+      methodStats_ = std::make_unique<ServerMethodStats>();
+    }
+  }
+
+  // nullptr unless enableMethodStats() was called
+  ServerMethodStats* getMethodStats() const {
+    return methodStats_.get();
+  }
+
  private:
   std::atomic<int32_t> activeRequests_{0};
+  std::atomic<uint64_t> deadlineExceededRequests_{0};
   bool disableActiveRequestsTracking_{false};
+  std::unique_ptr<ServerMethodStats> methodStats_;
 };
 
 } // namespace server
@@ -16,9 +16,92 @@
 
 #include <thrift/lib/cpp2/server/ServerInstrumentation.h>
 
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include <thrift/lib/cpp2/server/ThriftServer.h>
+
 namespace apache {
 namespace thrift {
 
+folly::F14FastMap<std::string, MethodStats>
+ServerInstrumentation::getMethodStats() {
+  folly::F14FastMap<std::string, MethodStats> stats;
+  forEachServer([&](ThriftServer& server) {
+    if (auto* methodStats = server.getMethodStats()) {
+      for (const auto& entry : methodStats->getStats()) {
+        stats[entry.first].merge(entry.second);
+      }
+    }
+  });
+  return stats;
+}
+
+folly::SemiFuture<std::vector<SlowRequestsLog::Entry>>
+ServerInstrumentation::snapshotSlowRequests() {
+  std::vector<folly::SemiFuture<std::vector<SlowRequestsLog::Entry>>> tasks;
+  forEachServer([&tasks](ThriftServer& server) {
+    tasks.emplace_back(server.snapshotSlowRequests());
+  });
+  return folly::collectSemiFuture(tasks.begin(), tasks.end())
+      .deferValue(&SlowRequestsLog::merge);
+}
+
+std::vector<EventLoopProbe::Stats> ServerInstrumentation::getEventLoopStats() {
+  std::vector<EventLoopProbe::Stats> stats;
+  forEachServer([&](ThriftServer& server) {
+    auto serverStats = server.getEventLoopStats();
+    std::move(
+        serverStats.begin(), serverStats.end(), std::back_inserter(stats));
+  });
+  return stats;
+}
+
+std::vector<util::LogLinearHistogram>
+ServerInstrumentation::getQueueWaitHistograms() {
+  std::vector<util::LogLinearHistogram> histograms;
+  forEachServer([&](ThriftServer& server) {
+    auto threadManager = server.getThreadManager();
+    if (!threadManager) {
+      return;
+    }
+    auto serverHistograms = threadManager->getQueueWaitHistograms();
+    if (histograms.size() < serverHistograms.size()) {
+      histograms.resize(serverHistograms.size());
+    }
+    for (size_t i = 0; i < serverHistograms.size(); ++i) {
+      histograms[i].merge(serverHistograms[i]);
+    }
+  });
+  return histograms;
+}
+
+std::vector<concurrency::ThreadManager::TenantStats>
+ServerInstrumentation::getTenantStats() {
+  std::vector<concurrency::ThreadManager::TenantStats> stats;
+  folly::F14FastMap<std::pair<std::string, bool>, size_t> indices;
+  forEachServer([&](ThriftServer& server) {
+    auto threadManager = server.getThreadManager();
+    if (!threadManager) {
+      return;
+    }
+    for (auto& entry : threadManager->getTenantStats()) {
+      auto inserted = indices.emplace(
+          std::make_pair(entry.tenant, entry.overflow), stats.size());
+      if (inserted.second) {
+        stats.push_back(std::move(entry));
+        continue;
+      }
+      auto& merged = stats[inserted.first->second];
+      merged.pending += entry.pending;
+      merged.admitted += entry.admitted;
+      merged.rejected += entry.rejected;
+    }
+  });
+  return stats;
+}
+
 ServerInstrumentation::ServerCollection&
 ServerInstrumentation::ServerCollection::getInstance() {
   static ServerCollection* the_singleton = new ServerCollection();
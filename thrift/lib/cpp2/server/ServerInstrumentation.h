@@ -17,11 +17,20 @@
 #pragma once
 
 #include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+#include <folly/futures/Future.h>
 #include <functional>
 #include <mutex>
 #include <set>
+#include <string>
 #include <vector>
 
+#include <thrift/lib/cpp/concurrency/ThreadManager.h>
+#include <thrift/lib/cpp/util/LogLinearHistogram.h>
+#include <thrift/lib/cpp2/server/EventLoopProbe.h>
+#include <thrift/lib/cpp2/server/MethodStats.h>
+#include <thrift/lib/cpp2/server/SlowRequestsLog.h>
+
 namespace apache {
 namespace thrift {
 
@@ -41,6 +50,39 @@ class ServerInstrumentation {
     return ServerCollection::getInstance().getServers()->size();
   }
 
+  /**
+   * Per-method statistics of all the servers which enabled them (see
+   * ServerConfigs::enableMethodStats), merged by method name.
+   */
+  static folly::F14FastMap<std::string, MethodStats> getMethodStats();
+
+  /**
+   * The slowest requests recently completed by all the servers, slowest
+   * first, see ThriftServer::snapshotSlowRequests.
+   */
+  static folly::SemiFuture<std::vector<SlowRequestsLog::Entry>>
+  snapshotSlowRequests();
+
+  /**
+   * Event loop lag and busy ratio of the IO workers of all the servers, see
+   * ThriftServer::getEventLoopStats.
+   */
+  static std::vector<EventLoopProbe::Stats> getEventLoopStats();
+
+  /**
+   * Time spent by tasks in the thread manager queues of all the servers,
+   * merged by priority. Only collected by thread managers created with task
+   * stats enabled (as the default one is).
+   */
+  static std::vector<util::LogLinearHistogram> getQueueWaitHistograms();
+
+  /**
+   * Tasks of each tenant in the thread managers of all the servers, merged by
+   * tenant, see ThreadManager::getTenantStats. The overflow tenants are
+   * merged apart from a tenant of the same name.
+   */
+  static std::vector<concurrency::ThreadManager::TenantStats> getTenantStats();
+
  private:
   static void registerServer(ThriftServer& server) {
     ServerCollection::getInstance().addServer(server);
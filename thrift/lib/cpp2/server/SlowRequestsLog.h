@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace apache {
+namespace thrift {
+
+/**
+ * Keeps the slowest requests completed recently, with their timing breakdown.
+ *
+ * The log holds the `capacity` slowest requests of the current window and of
+ * the previous one, so that an outlier stays visible for at least `window`
+ * but old outliers don't hide the recent ones forever.
+ *
+ * Like ActiveRequestsRegistry, a log belongs to an IO worker and must only be
+ * accessed from its event base thread, which is why it doesn't need any
+ * synchronization.
+ */
+class SlowRequestsLog {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * Time points are left to their default value if the request didn't reach
+   * the corresponding step (e.g. it was rejected before processing).
+   */
+  struct Entry {
+    std::string methodName;
+    // The request object was created by the transport
+    Clock::time_point received;
+    // The handler started processing the request
+    Clock::time_point processBegin;
+    // The response was handed back to the IO thread
+    Clock::time_point processEnd;
+    // The response was written to the transport and the request destroyed
+    Clock::time_point finished;
+    uint64_t requestBytes{0};
+    uint64_t responseBytes{0};
+
+    Clock::duration getLatency() const {
+      return finished - received;
+    }
+  };
+
+  SlowRequestsLog(size_t capacity, Clock::duration window)
+      : capacity_(capacity), window_(window), windowStart_(Clock::now()) {}
+
+  bool isEnabled() const {
+    return capacity_ > 0;
+  }
+
+  /**
+   * Whether a request completed at `now` with the given latency would be
+   * logged. Allows callers to skip building the entry for most requests.
+   */
+  bool shouldRecord(Clock::duration latency, Clock::time_point now) {
+    if (!isEnabled()) {
+      return false;
+    }
+    maybeRotate(now);
+    return current_.size() < capacity_ ||
+        latency > current_.front().getLatency();
+  }
+
+  void record(Entry&& entry) {
+    if (current_.size() == capacity_) {
+      std::pop_heap(current_.begin(), current_.end(), compare);
+      current_.pop_back();
+    }
+    current_.push_back(std::move(entry));
+    std::push_heap(current_.begin(), current_.end(), compare);
+  }
+
+  /**
+   * Entries of the current and previous windows, slowest first.
+   */
+  std::vector<Entry> getEntries() const {
+    std::vector<Entry> entries(previous_);
+    entries.insert(entries.end(), current_.begin(), current_.end());
+    sortSlowestFirst(entries);
+    return entries;
+  }
+
+  /**
+   * Entries of several logs (e.g. of every worker), slowest first.
+   */
+  static std::vector<Entry> merge(std::vector<std::vector<Entry>> logs) {
+    std::vector<Entry> entries;
+    for (auto& log : logs) {
+      std::move(log.begin(), log.end(), std::back_inserter(entries));
+    }
+    sortSlowestFirst(entries);
+    return entries;
+  }
+
+ private:
+  // Keeps the fastest logged request at the top of the heap
+  static bool compare(const Entry& a, const Entry& b) {
+    return a.getLatency() > b.getLatency();
+  }
+
+  static void sortSlowestFirst(std::vector<Entry>& entries) {
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+      return a.getLatency() > b.getLatency();
+    });
+  }
+
+  void maybeRotate(Clock::time_point now) {
+    if (now - windowStart_ < window_) {
+      return;
+    }
+    // If a whole window elapsed without any request, the current entries are
+    // too old to be kept.
+    if (now - windowStart_ < 2 * window_) {
+      previous_ = std::move(current_);
+    } else {
+      previous_.clear();
+    }
+    current_.clear();
+    windowStart_ = now;
+  }
+
+  const size_t capacity_;
+  const Clock::duration window_;
+  Clock::time_point windowStart_;
+  std::vector<Entry> current_;
+  std::vector<Entry> previous_;
+};
+
+} // namespace thrift
+} // namespace apache
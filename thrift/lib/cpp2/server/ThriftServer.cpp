@@ -19,6 +19,7 @@
 #include <fcntl.h>
 #include <signal.h>
 
+#include <algorithm>
 #include <iostream>
 #include <random>
 
@@ -669,5 +670,44 @@ ThriftServer::snapshotActiveRequests() {
         return flat_result;
       });
 }
+
+folly::SemiFuture<std::vector<SlowRequestsLog::Entry>>
+ThriftServer::snapshotSlowRequests() {
+  std::vector<folly::SemiFuture<std::vector<SlowRequestsLog::Entry>>> tasks;
+
+  forEachWorker([&tasks](wangle::Acceptor* acceptor) {
+    auto worker = dynamic_cast<Cpp2Worker*>(acceptor);
+    if (!worker) {
+      return;
+    }
+    auto fut = folly::via(
+        worker->getEventBase(),
+        [reqRegistry = worker->getRequestsRegistry()]() {
+          return reqRegistry->getSlowRequestsLog().getEntries();
+        });
+    tasks.emplace_back(std::move(fut));
+  });
+
+  return folly::collectSemiFuture(tasks.begin(), tasks.end())
+      .deferValue(&SlowRequestsLog::merge);
+}
+
+std::vector<EventLoopProbe::Stats> ThriftServer::getEventLoopStats() const {
+  std::vector<EventLoopProbe::Stats> stats;
+  auto probes = eventLoopProbes_.rlock();
+  for (auto probe : *probes) {
+    stats.push_back(probe->getStats());
+  }
+  return stats;
+}
+
+std::chrono::microseconds ThriftServer::getMaxEventLoopLag() const {
+  auto lag = std::chrono::microseconds::zero();
+  auto probes = eventLoopProbes_.rlock();
+  for (auto probe : *probes) {
+    lag = std::max(lag, probe->getLastLag());
+  }
+  return lag;
+}
 } // namespace thrift
 } // namespace apache
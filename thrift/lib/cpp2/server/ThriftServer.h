@@ -22,11 +22,13 @@
 #include <cstdlib>
 #include <map>
 #include <mutex>
+#include <set>
 #include <vector>
 
 #include <folly/Memory.h>
 #include <folly/Singleton.h>
 #include <folly/SocketAddress.h>
+#include <folly/Synchronized.h>
 #include <folly/executors/IOThreadPoolExecutor.h>
 #include <folly/io/ShutdownSocketSet.h>
 #include <folly/io/async/AsyncServerSocket.h>
@@ -39,8 +41,10 @@
 #include <thrift/lib/cpp2/Thrift.h>
 #include <thrift/lib/cpp2/async/AsyncProcessor.h>
 #include <thrift/lib/cpp2/async/HeaderServerChannel.h>
+#include <thrift/lib/cpp2/async/ResumableStream.h>
 #include <thrift/lib/cpp2/server/ActiveRequestsRegistry.h>
 #include <thrift/lib/cpp2/server/BaseThriftServer.h>
+#include <thrift/lib/cpp2/server/EventLoopProbe.h>
 #include <thrift/lib/cpp2/server/TransportRoutingHandler.h>
 #include <thrift/lib/cpp2/transport/core/ThriftProcessor.h>
 #include <wangle/acceptor/ServerSocketConfig.h>
@@ -156,6 +160,13 @@ class ThriftServer : public apache::thrift::BaseThriftServer,
   // must request or a default transform must be set
   uint32_t minCompressBytes_ = 0;
 
+  // Write buffer limits of rocket connections, 0 for none
+  size_t maxStreamBufferedBytes_ = 0;
+  size_t maxWriteBufferBytes_ = 0;
+
+  // Parked and live resumable streams, null unless stream resumption is on
+  std::shared_ptr<ResumableStreamRegistry> resumableStreams_;
+
   std::vector<uint16_t> writeTrans_;
 
   bool queueSends_ = true;
@@ -188,6 +199,9 @@ class ThriftServer : public apache::thrift::BaseThriftServer,
   std::unique_ptr<ThriftProcessor> thriftProcessor_;
   std::vector<std::unique_ptr<TransportRoutingHandler>> routingHandlers_;
 
+  // Probes of the IO workers, registered by the workers for their lifetime
+  folly::Synchronized<std::set<const EventLoopProbe*>> eventLoopProbes_;
+
   friend class Cpp2Connection;
   friend class Cpp2Worker;
 
@@ -612,6 +626,52 @@ class ThriftServer : public apache::thrift::BaseThriftServer,
     minCompressBytes_ = bytes;
   }
 
+  /**
+   * Set how many bytes a stream may have queued on a rocket connection
+   * before the credits its client grants are held back from the producer
+   * (0 == no limit). Only effective with a write buffer limit, see
+   * setMaxWriteBufferBytes().
+   */
+  void setMaxStreamBufferedBytes(size_t bytes) {
+    maxStreamBufferedBytes_ = bytes;
+  }
+
+  size_t getMaxStreamBufferedBytes() const {
+    return maxStreamBufferedBytes_;
+  }
+
+  /**
+   * Set how many bytes of stream payloads a rocket connection may have
+   * pending in its socket. Beyond that, payloads wait in per-stream queues
+   * drained round-robin, so that one fast stream can't starve the others of
+   * the connection (0 == no limit).
+   */
+  void setMaxWriteBufferBytes(size_t bytes) {
+    maxWriteBufferBytes_ = bytes;
+  }
+
+  size_t getMaxWriteBufferBytes() const {
+    return maxWriteBufferBytes_;
+  }
+
+  /**
+   * Let rocket clients that ask for it resume their streams on a new
+   * connection after losing theirs, see ResumableStreamRegistry. A resumable
+   * stream keeps its last 'replayBufferBytes' of payloads to replay, and is
+   * cancelled if its client isn't back within 'resumeTimeout'. Must be
+   * called before the server starts.
+   */
+  void setStreamResumption(
+      size_t replayBufferBytes,
+      std::chrono::milliseconds resumeTimeout) {
+    resumableStreams_ = std::make_shared<ResumableStreamRegistry>(
+        replayBufferBytes, resumeTimeout);
+  }
+
+  const std::shared_ptr<ResumableStreamRegistry>& getResumableStreams() const {
+    return resumableStreams_;
+  }
+
   /**
    * Set the default write transforms to be used on replies. If client
    * sets transforms, server will reflect them. Otherwise, these will
@@ -800,6 +860,22 @@ class ThriftServer : public apache::thrift::BaseThriftServer,
     std::unique_ptr<folly::IOBuf> payload_;
   };
   folly::SemiFuture<std::vector<RequestSnapshot>> snapshotActiveRequests();
+
+  /**
+   * The slowest requests recently completed by each worker, slowest first.
+   * Empty unless setSlowRequestsLogSizePerWorker was called. Only header and
+   * rocket requests are logged: HTTP/2 requests aren't tracked by the
+   * workers' ActiveRequestsRegistry.
+   */
+  folly::SemiFuture<std::vector<SlowRequestsLog::Entry>> snapshotSlowRequests();
+
+  /**
+   * Event loop lag and busy ratio of each IO worker. Empty unless
+   * setEventLoopProbeInterval was called.
+   */
+  std::vector<EventLoopProbe::Stats> getEventLoopStats() const;
+
+  std::chrono::microseconds getMaxEventLoopLag() const override;
 };
 
 } // namespace thrift
@@ -67,13 +67,12 @@ class PerClientIdAdmissionStrategy : public AdmissionStrategy {
       return wildcardController_;
     }
 
-    const auto& headers = theader->getHeaders();
-    auto headersIt = headers.find(clientIdHeaderName_);
-    if (headersIt == headers.end() || headersIt->second == kWildcard) {
+    auto clientIdHeader = theader->getReadHeader(clientIdHeaderName_);
+    if (!clientIdHeader || *clientIdHeader == kWildcard) {
       return wildcardController_;
     }
 
-    const auto& clientId = headersIt->second;
+    const auto clientId = clientIdHeader->str();
     {
       // Fast path
       auto readOnlyAdmController = admissionControllers_.rlock();
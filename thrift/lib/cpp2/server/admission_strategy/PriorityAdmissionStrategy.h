@@ -176,10 +176,9 @@ class PriorityAdmissionStrategy : public AdmissionStrategy {
 
   Priority& getPriority(const transport::THeader* theader) {
     if (theader != nullptr) {
-      const auto& headers = theader->getHeaders();
-      auto clientIdIt = headers.find(clientIdHeaderName_);
-      if (clientIdIt != headers.end()) {
-        auto priorityIt = priorities_.find(clientIdIt->second);
+      auto clientId = theader->getReadHeader(clientIdHeaderName_);
+      if (clientId) {
+        auto priorityIt = priorities_.find(clientId->str());
         if (priorityIt != priorities_.end()) {
           return priorityIt->second;
         }
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include <thrift/lib/cpp2/server/AdmissionController.h>
+#include <thrift/lib/cpp2/server/QIAdmissionController.h>
+
+using namespace apache::thrift;
+
+// Full life of a request as seen by the admission controller:
+// admission on the IO thread, dequeue and response on the CPU thread.
+template <class Controller>
+void runRequests(Controller& controller, size_t iters, size_t threads) {
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < threads; ++t) {
+    workers.emplace_back([&controller, n = iters / threads] {
+      for (size_t i = 0; i < n; ++i) {
+        if (controller.admit()) {
+          controller.dequeue();
+          controller.returnedResponse(std::chrono::nanoseconds(1));
+        }
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+void acceptAll(size_t iters, size_t threads) {
+  folly::BenchmarkSuspender setup;
+  AcceptAllAdmissionController controller;
+  setup.dismiss();
+  runRequests(controller, iters, threads);
+}
+
+void queueIntegral(size_t iters, size_t threads) {
+  folly::BenchmarkSuspender setup;
+  // Large minimum queue length so that nothing gets rejected, we measure the
+  // bookkeeping overhead only.
+  QIAdmissionController<> controller(
+      std::chrono::seconds(1), std::chrono::seconds(10), 1 << 20);
+  setup.dismiss();
+  runRequests(controller, iters, threads);
+}
+
+BENCHMARK_PARAM(acceptAll, 1)
+BENCHMARK_RELATIVE_PARAM(queueIntegral, 1)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_PARAM(acceptAll, 8)
+BENCHMARK_RELATIVE_PARAM(queueIntegral, 8)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_PARAM(acceptAll, 32)
+BENCHMARK_RELATIVE_PARAM(queueIntegral, 32)
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -14,10 +14,13 @@
  * limitations under the License.
  */
 
+#include <thrift/lib/cpp2/server/AdaptiveConcurrencyController.h>
 #include <thrift/lib/cpp2/server/QIAdmissionController.h>
 #include <thrift/lib/cpp2/server/SLAViolationController.h>
 
 #include <chrono>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -173,6 +176,136 @@ TEST_F(AdmissionControllerTest, steadyMaxRPS) {
   ASSERT_NEAR(rejected, 10, 4);
 }
 
+TEST_F(AdmissionControllerTest, queueLimitPublishedOnAggregation) {
+  constexpr int window = 5;
+  constexpr int sla = 1;
+  constexpr int minQueueLength = 1;
+  QIAdmissionController<FakeClock> controller(
+      seconds(sla), seconds(window), minQueueLength, seconds(1));
+
+  ASSERT_TRUE(controller.admit());
+  for (int i = 0; i < 100; i++) {
+    controller.returnedResponse(std::chrono::nanoseconds(1));
+  }
+
+  // The new response rate isn't taken into account before the next
+  // aggregation, the queue limit is still the minimum one.
+  ASSERT_FALSE(controller.admit());
+
+  FakeClock::advance(seconds(1));
+  ASSERT_TRUE(controller.admit());
+  ASSERT_TRUE(controller.admit());
+}
+
+TEST_F(AdmissionControllerTest, concurrentAdmitDequeue) {
+  constexpr int kThreads = 8;
+  constexpr int kIterations = 10000;
+  QIAdmissionController<> controller(seconds(1), seconds(5), kThreads);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < kIterations; i++) {
+        if (controller.admit()) {
+          controller.dequeue();
+          controller.returnedResponse(std::chrono::nanoseconds(1));
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Threads are gone, their counters must have been handed over to the
+  // controller.
+  std::unordered_map<std::string, double> reported;
+  AdmissionController& base = controller;
+  base.reportMetrics(
+      [&](const std::string& key, double value) { reported[key] = value; },
+      "");
+  EXPECT_EQ(0, reported["queue_size"]);
+  EXPECT_GT(reported["response_rate"], 0);
+  EXPECT_TRUE(controller.admit());
+}
+
+namespace {
+// Simulate a server which processes `capacity` requests concurrently in
+// `baseLatency`, and gets proportionally slower above that. Every step, the
+// clients try to keep `offered` requests inflight, and all admitted requests
+// complete by the end of the step.
+template <class Controller>
+void simulateLoad(
+    Controller& controller,
+    int steps,
+    int offered,
+    int capacity,
+    milliseconds baseLatency) {
+  for (int step = 0; step < steps; step++) {
+    int admitted = 0;
+    for (int i = 0; i < offered; i++) {
+      if (controller.admit()) {
+        admitted++;
+      }
+    }
+    auto latency = baseLatency * std::max(1.0, double(admitted) / capacity);
+    FakeClock::advance(duration_cast<FakeClock::duration>(latency));
+    for (int i = 0; i < admitted; i++) {
+      controller.dequeue();
+      controller.returnedResponse(duration_cast<nanoseconds>(latency));
+    }
+  }
+}
+
+AdaptiveConcurrencyController<FakeClock>::Config adaptiveConfig() {
+  AdaptiveConcurrencyController<FakeClock>::Config config;
+  config.initialLimit = 20;
+  config.maxLimit = 1000;
+  config.sampleInterval = milliseconds(100);
+  config.minLatencyWindow = minutes(10);
+  return config;
+}
+} // namespace
+
+TEST_F(AdmissionControllerTest, adaptiveConcurrencyGrowsWhenLatencyIsFlat) {
+  AdaptiveConcurrencyController<FakeClock> controller(adaptiveConfig());
+
+  simulateLoad(controller, 3000, 200, 1000, milliseconds(10));
+  EXPECT_GT(controller.getLimit(), 200);
+  // The limit doesn't grow indefinitely if it isn't used
+  EXPECT_LT(controller.getLimit(), 1000);
+}
+
+TEST_F(AdmissionControllerTest, adaptiveConcurrencyConvergesToCapacity) {
+  AdaptiveConcurrencyController<FakeClock> controller(adaptiveConfig());
+
+  simulateLoad(controller, 3000, 500, 50, milliseconds(10));
+  // With a tolerance of 1.5, the limit settles a bit above 1.5 * capacity
+  EXPECT_GT(controller.getLimit(), 50);
+  EXPECT_LT(controller.getLimit(), 150);
+
+  // Capacity drops, so should the limit
+  simulateLoad(controller, 3000, 500, 10, milliseconds(10));
+  EXPECT_LT(controller.getLimit(), 50);
+}
+
+TEST_F(AdmissionControllerTest, adaptiveConcurrencyDroppedReleasesSlot) {
+  auto config = adaptiveConfig();
+  config.initialLimit = 1;
+  config.minLimit = 1;
+  config.maxLimit = 1;
+  AdaptiveConcurrencyController<FakeClock> controller(config);
+
+  ASSERT_TRUE(controller.admit());
+  ASSERT_FALSE(controller.admit());
+  controller.dropped();
+  ASSERT_TRUE(controller.admit());
+  controller.dequeue();
+  ASSERT_FALSE(controller.admit());
+  controller.returnedResponse(milliseconds(1));
+  ASSERT_TRUE(controller.admit());
+}
+
 TEST_F(AdmissionControllerTest, SLAViolationControllerTest) {
   auto n = 1000;
   auto tolerance = 0.2;
@@ -42,6 +42,17 @@ Shallow makeShallow() {
   return data;
 }
 
+Point makePoint() {
+  Point data;
+  data.id = 1234567;
+  data.x = -42;
+  data.y = 4242;
+  data.weight = 0.75;
+  data.visible = true;
+  data.label = "p";
+  return data;
+}
+
 Deep makeDeep(size_t triplesz) {
   Deep data;
   for (size_t i = 0; i < triplesz; ++i) {
@@ -149,7 +160,26 @@ BENCHMARK(CompactProtocolReader_deserialize_shallow, kiters) {
   braces.dismiss();
   while (iters--) {
     CompactSerializer s;
-    Deep data;
+    Shallow data;
+    s.deserialize(buf.get(), data);
+  }
+  braces.rehire();
+}
+
+BENCHMARK_RELATIVE(
+    CompactProtocolReader_deserialize_shallow_fast_read,
+    kiters) {
+  BenchmarkSuspender braces;
+  size_t iters = kiters << kMultExp;
+  Shallow data = makeShallow();
+  CompactSerializer ser;
+  IOBufQueue bufq;
+  ser.serialize(data, &bufq);
+  auto buf = bufq.move();
+  braces.dismiss();
+  while (iters--) {
+    CompactSerializer s;
+    ShallowFastRead data;
     s.deserialize(buf.get(), data);
   }
   braces.rehire();
@@ -168,6 +198,40 @@ BENCHMARK(CompactProtocolWriter_serialize_shallow, kiters) {
   braces.rehire();
 }
 
+BENCHMARK(CompactProtocolReader_deserialize_point, kiters) {
+  BenchmarkSuspender braces;
+  size_t iters = kiters << kMultExp;
+  Point data = makePoint();
+  CompactSerializer ser;
+  IOBufQueue bufq;
+  ser.serialize(data, &bufq);
+  auto buf = bufq.move();
+  braces.dismiss();
+  while (iters--) {
+    CompactSerializer s;
+    Point point;
+    s.deserialize(buf.get(), point);
+  }
+  braces.rehire();
+}
+
+BENCHMARK_RELATIVE(CompactProtocolReader_deserialize_point_fast_read, kiters) {
+  BenchmarkSuspender braces;
+  size_t iters = kiters << kMultExp;
+  Point data = makePoint();
+  CompactSerializer ser;
+  IOBufQueue bufq;
+  ser.serialize(data, &bufq);
+  auto buf = bufq.move();
+  braces.dismiss();
+  while (iters--) {
+    CompactSerializer s;
+    PointFastRead point;
+    s.deserialize(buf.get(), point);
+  }
+  braces.rehire();
+}
+
 BENCHMARK(CompactProtocolReader_deserialize_deep, kiters) {
   BenchmarkSuspender braces;
   size_t iters = kiters << kMultExp;
@@ -22,6 +22,29 @@ struct Shallow {
   2: i64 two;
 }
 
+struct ShallowFastRead {
+  1: i64 one;
+  2: i64 two;
+} (cpp.fast_read)
+
+struct Point {
+  1: i64 id;
+  2: i32 x;
+  3: i32 y;
+  4: double weight;
+  5: bool visible;
+  6: string label;
+}
+
+struct PointFastRead {
+  1: i64 id;
+  2: i32 x;
+  3: i32 y;
+  4: double weight;
+  5: bool visible;
+  6: string label;
+} (cpp.fast_read)
+
 struct Deep2 {
   1: list<string> datas;
 }
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/futures/Future.h>
+#include <folly/init/Init.h>
+#include <folly/io/async/EventBase.h>
+
+#include <thrift/lib/cpp2/test/gen-cpp2/Coroutine.h>
+#include <thrift/lib/cpp2/util/ScopedServerInterfaceThread.h>
+
+using apache::thrift::HandlerCallback;
+using apache::thrift::ScopedServerInterfaceThread;
+using apache::thrift::test::CoroutineAsyncClient;
+using apache::thrift::test::CoroutineSvIf;
+using apache::thrift::test::SumRequest;
+using apache::thrift::test::SumResponse;
+
+#if FOLLY_HAS_COROUTINES
+
+namespace {
+
+constexpr size_t kBatchSize = 64;
+
+folly::coro::Task<std::unique_ptr<SumResponse>> sum(
+    std::unique_ptr<SumRequest> request) {
+  auto response = std::make_unique<SumResponse>();
+  response->sum = request->x + request->y;
+  co_return response;
+}
+
+class Handler : virtual public CoroutineSvIf {
+ public:
+  // Started by the processor, without a HandlerCallback
+  folly::coro::Task<std::unique_ptr<SumResponse>> co_computeSum(
+      std::unique_ptr<SumRequest> request) override {
+    return sum(std::move(request));
+  }
+
+  // The same coroutine, dispatched the way cpp.coroutine functions were
+  // before: through a HandlerCallback, queued to the thread manager again.
+  void async_tm_computeSumNoCoro(
+      std::unique_ptr<HandlerCallback<std::unique_ptr<SumResponse>>> callback,
+      std::unique_ptr<SumRequest> request) override {
+    auto tm = callback->getThreadManager();
+    sum(std::move(request))
+        .scheduleOn(tm)
+        .start([callback = std::move(callback)](
+                   folly::Try<std::unique_ptr<SumResponse>>&& result) mutable {
+          HandlerCallback<std::unique_ptr<SumResponse>>::completeInThread(
+              std::move(callback), std::move(result));
+        });
+  }
+};
+
+// Sends the requests in batches, to keep the server's threads busy.
+template <typename Send>
+void runRequests(size_t iters, Send send) {
+  folly::BenchmarkSuspender setup;
+  ScopedServerInterfaceThread ssit(std::make_shared<Handler>());
+  folly::EventBase eb;
+  auto client = ssit.newClient<CoroutineAsyncClient>(eb);
+  SumRequest request;
+  request.x = 1;
+  request.y = 2;
+  setup.dismiss();
+
+  while (iters > 0) {
+    std::vector<folly::SemiFuture<SumResponse>> batch;
+    for (; iters > 0 && batch.size() < kBatchSize; --iters) {
+      batch.push_back(send(*client, request));
+    }
+    for (auto& response : batch) {
+      std::move(response).via(&eb).getVia(&eb);
+    }
+  }
+  setup.rehire();
+}
+
+} // namespace
+
+BENCHMARK(handler_callback, iters) {
+  runRequests(iters, [](CoroutineAsyncClient& client, const SumRequest& req) {
+    return client.semifuture_computeSumNoCoro(req);
+  });
+}
+
+BENCHMARK_RELATIVE(coroutine_dispatch, iters) {
+  runRequests(iters, [](CoroutineAsyncClient& client, const SumRequest& req) {
+    return client.semifuture_computeSum(req);
+  });
+}
+
+#endif // FOLLY_HAS_COROUTINES
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
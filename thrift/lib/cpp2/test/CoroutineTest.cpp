@@ -17,7 +17,11 @@
 #include <exception>
 
 #include <folly/portability/GTest.h>
+#if FOLLY_HAS_COROUTINES
+#include <folly/experimental/coro/CurrentExecutor.h>
+#endif
 
+#include <thrift/lib/cpp2/async/CoroDispatch.h>
 #include <thrift/lib/cpp2/test/gen-cpp2/Coroutine.h>
 #include <thrift/lib/cpp2/util/ScopedServerInterfaceThread.h>
 
@@ -436,7 +440,46 @@ TEST_F(CoroutineNullTest, Basics) {
   client_->sync_noParameters();
 }
 
+TEST(CoroDispatchFramePoolTest, ReusesFramesOfSameSizeClass) {
+  using apache::thrift::detail::ap::CoroDispatchFramePool;
+  auto frame = CoroDispatchFramePool::allocate(200);
+  CoroDispatchFramePool::deallocate(frame, 200);
+  auto reused = CoroDispatchFramePool::allocate(250);
+  EXPECT_EQ(frame, reused);
+  CoroDispatchFramePool::deallocate(reused, 250);
+}
+
 #if FOLLY_HAS_COROUTINES
+class CoroutineServiceHandlerSuspending : public CoroutineServiceHandlerCoro {
+ public:
+  folly::coro::Task<int32_t> co_computeSumPrimitive(int32_t x, int32_t y)
+      override {
+    co_await folly::coro::co_reschedule_on_current_executor;
+    co_return x + y;
+  }
+
+  folly::coro::Task<int32_t> co_computeSumThrowsPrimitive(int32_t, int32_t)
+      override {
+    co_await folly::coro::co_reschedule_on_current_executor;
+    throw std::runtime_error("Not implemented");
+  }
+};
+
+// The processor starts the coroutine inline: check that replies are still
+// sent once the coroutine resumes on the thread manager.
+TEST(CoroutineDispatchTest, HandlerSuspends) {
+  ScopedServerInterfaceThread ssit(
+      std::make_shared<CoroutineServiceHandlerSuspending>());
+  auto client = ssit.newClient<CoroutineAsyncClient>(
+      *EventBaseManager::get()->getEventBase());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(i + 1, client->sync_computeSumPrimitive(i, 1));
+  }
+  EXPECT_THROW(
+      client->sync_computeSumThrowsPrimitive(1, 2),
+      apache::thrift::TApplicationException);
+}
+
 class CoroutineClientTest : public testing::Test {
  protected:
   CoroutineClientTest()
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrift/lib/cpp2/server/EventLoopProbe.h>
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <folly/io/async/EventBase.h>
+
+using namespace apache::thrift;
+using namespace std::chrono;
+
+TEST(EventLoopProbe, measuresBlockedLoop) {
+  folly::EventBase evb;
+  EventLoopProbe probe(evb, milliseconds(10));
+  probe.start();
+
+  // Block the loop right before the first probe is due
+  evb.runAfterDelay(
+      [] {
+        /* sleep override */
+        std::this_thread::sleep_for(milliseconds(50));
+      },
+      5);
+  evb.runAfterDelay([&] { evb.terminateLoopSoon(); }, 100);
+  evb.loopForever();
+
+  auto stats = probe.getStats();
+  EXPECT_LE(3, stats.lagUs.count());
+  EXPECT_LE(40000, stats.lagUs.percentile(100));
+  EXPECT_GE(1.0, stats.busyRatio);
+  EXPECT_LE(0.0, stats.busyRatio);
+}
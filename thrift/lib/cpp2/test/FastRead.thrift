@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+namespace cpp2 apache.thrift.test
+
+enum Shade {
+  LIGHT = 1,
+  DARK = 2,
+}
+
+// Numbers and bools only: the whole struct is read in one go
+struct Sample {
+  1: i64 id,
+  2: i32 count,
+  3: i16 small,
+  4: byte tiny,
+  5: bool flag,
+  6: double ratio,
+  7: float scale,
+  8: Shade shade,
+} (cpp.fast_read)
+
+// Same layout, read field by field
+struct PlainSample {
+  1: i64 id,
+  2: i32 count,
+  3: i16 small,
+  4: byte tiny,
+  5: bool flag,
+  6: double ratio,
+  7: float scale,
+  8: Shade shade,
+}
+
+// Sample with one more field at the end
+struct LongerSample {
+  1: i64 id,
+  2: i32 count,
+  3: i16 small,
+  4: byte tiny,
+  5: bool flag,
+  6: double ratio,
+  7: float scale,
+  8: Shade shade,
+  9: string note,
+}
+
+// The run stops at the string
+struct NamedSample {
+  1: i64 id,
+  2: bool flag,
+  3: string name,
+  4: i32 count,
+} (cpp.fast_read)
+
+// Misses and adds fields compared to Sample
+struct SparseSample {
+  1: i64 id,
+  3: i16 small,
+  9: string extra,
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <limits>
+#include <string>
+
+#include <folly/io/IOBuf.h>
+#include <folly/portability/GTest.h>
+
+#include <thrift/lib/cpp2/protocol/CompactProtocol.h>
+#include <thrift/lib/cpp2/protocol/ProtocolReaderStructReadState.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+#include <thrift/lib/cpp2/test/gen-cpp2/FastRead_types.h>
+
+using apache::thrift::BinarySerializer;
+using apache::thrift::CompactProtocolReader;
+using apache::thrift::CompactSerializer;
+using apache::thrift::test::LongerSample;
+using apache::thrift::test::NamedSample;
+using apache::thrift::test::PlainSample;
+using apache::thrift::test::Sample;
+using apache::thrift::test::Shade;
+using apache::thrift::test::SparseSample;
+
+namespace {
+
+PlainSample makePlain(bool flag) {
+  PlainSample plain;
+  plain.id = std::numeric_limits<int64_t>::min();
+  plain.count = -123456;
+  plain.small = 4242;
+  plain.tiny = -7;
+  plain.flag = flag;
+  plain.ratio = 0.125;
+  plain.scale = -2.5f;
+  plain.shade = Shade::DARK;
+  return plain;
+}
+
+void expectSameFields(const PlainSample& expected, const Sample& actual) {
+  EXPECT_EQ(expected.id, actual.id);
+  EXPECT_EQ(expected.count, actual.count);
+  EXPECT_EQ(expected.small, actual.small);
+  EXPECT_EQ(expected.tiny, actual.tiny);
+  EXPECT_EQ(expected.flag, actual.flag);
+  EXPECT_EQ(expected.ratio, actual.ratio);
+  EXPECT_EQ(expected.scale, actual.scale);
+  EXPECT_EQ(expected.shade, actual.shade);
+}
+
+// Splits `data` into one byte long buffers, too short for any run
+std::unique_ptr<folly::IOBuf> fragment(const std::string& data) {
+  auto head = folly::IOBuf::copyBuffer(data.data(), 1);
+  for (size_t i = 1; i < data.size(); ++i) {
+    head->prependChain(folly::IOBuf::copyBuffer(data.data() + i, 1));
+  }
+  return head;
+}
+
+// Reads a Sample from `data` with its field run only, as generated code does
+bool readSampleRun(const std::string& data, Sample& sample, size_t& read) {
+  using apache::thrift::detail::FieldRunEntry;
+  namespace protocol = apache::thrift::protocol;
+  auto buf = folly::IOBuf::wrapBuffer(data.data(), data.size());
+  CompactProtocolReader reader;
+  reader.setInput(buf.get());
+  apache::thrift::detail::ProtocolReaderStructReadState<CompactProtocolReader>
+      state;
+  state.readStructBegin(&reader);
+  bool ok = state.readFieldRun<
+      FieldRunEntry<1, protocol::T_I64>,
+      FieldRunEntry<2, protocol::T_I32>,
+      FieldRunEntry<3, protocol::T_I16>,
+      FieldRunEntry<4, protocol::T_BYTE>,
+      FieldRunEntry<5, protocol::T_BOOL>,
+      FieldRunEntry<6, protocol::T_DOUBLE>,
+      FieldRunEntry<7, protocol::T_FLOAT>,
+      FieldRunEntry<8, protocol::T_I32>,
+      FieldRunEntry<0, protocol::T_STOP>>(
+      &reader,
+      sample.id,
+      sample.count,
+      sample.small,
+      sample.tiny,
+      sample.flag,
+      sample.ratio,
+      sample.scale,
+      sample.shade);
+  read = reader.getCursorPosition();
+  return ok;
+}
+
+} // namespace
+
+TEST(FastReadTest, exactSizeBuffer) {
+  // much shorter than the longest encoding of the run, with nothing after it
+  auto plain = makePlain(true);
+  auto data = CompactSerializer::serialize<std::string>(plain);
+  Sample sample;
+  size_t read = 0;
+  EXPECT_TRUE(readSampleRun(data, sample, read));
+  EXPECT_EQ(data.size(), read);
+  expectSameFields(plain, sample);
+
+  // without its STOP, the struct would need a byte past the end
+  data.pop_back();
+  Sample truncated;
+  EXPECT_FALSE(readSampleRun(data, truncated, read));
+  EXPECT_EQ(0, read);
+  EXPECT_EQ(0, truncated.id);
+}
+
+TEST(FastReadTest, wholeStruct) {
+  for (bool flag : {false, true}) {
+    auto plain = makePlain(flag);
+    auto data = CompactSerializer::serialize<std::string>(plain);
+    auto sample = CompactSerializer::deserialize<Sample>(data);
+    expectSameFields(plain, sample);
+    EXPECT_TRUE(sample.__isset.id);
+    EXPECT_TRUE(sample.__isset.shade);
+
+    // and back, byte for byte
+    EXPECT_EQ(data, CompactSerializer::serialize<std::string>(sample));
+  }
+}
+
+TEST(FastReadTest, fragmentedInput) {
+  auto plain = makePlain(true);
+  auto buf = fragment(CompactSerializer::serialize<std::string>(plain));
+  Sample sample;
+  CompactSerializer::deserialize(buf.get(), sample);
+  expectSameFields(plain, sample);
+}
+
+TEST(FastReadTest, trailingInput) {
+  // the run may look past the struct, into whatever follows it
+  auto plain = makePlain(false);
+  auto data = CompactSerializer::serialize<std::string>(plain);
+  auto size = data.size();
+  data.append(64, '\xff');
+  Sample sample;
+  EXPECT_EQ(size, CompactSerializer::deserialize(data, sample));
+  expectSameFields(plain, sample);
+}
+
+TEST(FastReadTest, missingAndUnknownFields) {
+  SparseSample sparse;
+  sparse.id = 99;
+  sparse.small = -3;
+  sparse.extra = "not in Sample";
+  auto sample = CompactSerializer::deserialize<Sample>(
+      CompactSerializer::serialize<std::string>(sparse));
+
+  EXPECT_EQ(99, sample.id);
+  EXPECT_EQ(-3, sample.small);
+  EXPECT_EQ(0, sample.count);
+  EXPECT_FALSE(sample.__isset.count);
+  EXPECT_FALSE(sample.flag);
+}
+
+TEST(FastReadTest, mismatchedTypes) {
+  NamedSample named;
+  named.id = 1;
+  named.flag = true;
+  named.name = "skipped";
+  named.count = 5;
+  auto sample = CompactSerializer::deserialize<Sample>(
+      CompactSerializer::serialize<std::string>(named));
+  EXPECT_EQ(1, sample.id);
+  EXPECT_EQ(0, sample.count);
+  EXPECT_FALSE(sample.__isset.count);
+  EXPECT_FALSE(sample.flag);
+}
+
+TEST(FastReadTest, fieldAfterRun) {
+  // every field of Sample matches, but the struct doesn't end after them
+  auto plain = makePlain(true);
+  LongerSample longer;
+  longer.id = plain.id;
+  longer.count = plain.count;
+  longer.small = plain.small;
+  longer.tiny = plain.tiny;
+  longer.flag = plain.flag;
+  longer.ratio = plain.ratio;
+  longer.scale = plain.scale;
+  longer.shade = plain.shade;
+  longer.note = "skipped";
+  auto sample = CompactSerializer::deserialize<Sample>(
+      CompactSerializer::serialize<std::string>(longer));
+  expectSameFields(plain, sample);
+}
+
+TEST(FastReadTest, runFollowedByOtherFields) {
+  NamedSample named;
+  named.id = 1 << 20;
+  named.flag = true;
+  named.name = "after the run";
+  named.count = -1;
+  EXPECT_EQ(
+      named,
+      CompactSerializer::deserialize<NamedSample>(
+          CompactSerializer::serialize<std::string>(named)));
+  EXPECT_EQ(
+      named,
+      BinarySerializer::deserialize<NamedSample>(
+          BinarySerializer::serialize<std::string>(named)));
+}
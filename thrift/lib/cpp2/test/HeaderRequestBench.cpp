@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include <folly/futures/Future.h>
+#include <folly/init/Init.h>
+
+#include <thrift/lib/cpp/transport/THeader.h>
+#include <thrift/lib/cpp2/test/gen-cpp2/TestService.h>
+#include <thrift/lib/cpp2/util/ScopedServerInterfaceThread.h>
+
+using apache::thrift::RpcOptions;
+using apache::thrift::ScopedServerInterfaceThread;
+using apache::thrift::ThriftServer;
+using apache::thrift::test::TestServiceAsyncClient;
+using apache::thrift::test::TestServiceSvIf;
+using apache::thrift::transport::THeader;
+
+namespace {
+
+constexpr size_t kBatchSize = 64;
+
+class Handler : public TestServiceSvIf {
+ public:
+  int32_t echoInt(int32_t req) override {
+    return req;
+  }
+};
+
+// Typical request: a handful of small headers
+RpcOptions makeOptions(size_t numHeaders) {
+  RpcOptions options;
+  for (size_t i = 0; i < numHeaders; ++i) {
+    options.setWriteHeader(
+        folly::to<std::string>("header_", i),
+        folly::to<std::string>("value_", i));
+  }
+  return options;
+}
+
+// Sends requests through the header transport, so that every one of them goes
+// through Cpp2Connection::requestReceived. With customIsOverloaded, the
+// server builds the read headers map of every request for the callback.
+void runRequests(size_t iters, size_t numHeaders, bool customIsOverloaded) {
+  folly::BenchmarkSuspender setup;
+  ScopedServerInterfaceThread ssit(
+      std::make_shared<Handler>(),
+      "::1",
+      0,
+      [&](ThriftServer& server) {
+        if (customIsOverloaded) {
+          server.setIsOverloaded(
+              [](const THeader::StringToStringMap* headers,
+                 const std::string*) {
+                return headers && headers->count("overloaded");
+              });
+        }
+      });
+  auto client = ssit.newClient<TestServiceAsyncClient>();
+  auto options = makeOptions(numHeaders);
+  setup.dismiss();
+
+  while (iters > 0) {
+    std::vector<folly::SemiFuture<int32_t>> batch;
+    for (; iters > 0 && batch.size() < kBatchSize; --iters) {
+      // The client releases the write headers of the options it sends
+      auto requestOptions = options;
+      batch.push_back(client->semifuture_echoInt(requestOptions, 1));
+    }
+    for (auto& response : batch) {
+      folly::doNotOptimizeAway(std::move(response).get());
+    }
+  }
+  setup.rehire();
+}
+
+} // namespace
+
+BENCHMARK(custom_is_overloaded_4, iters) {
+  runRequests(iters, 4, true);
+}
+
+BENCHMARK_RELATIVE(default_is_overloaded_4, iters) {
+  runRequests(iters, 4, false);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(custom_is_overloaded_16, iters) {
+  runRequests(iters, 16, true);
+}
+
+BENCHMARK_RELATIVE(default_is_overloaded_16, iters) {
+  runRequests(iters, 16, false);
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrift/lib/cpp2/server/MethodStats.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace apache::thrift;
+using namespace std::chrono;
+
+using apache::thrift::util::LogLinearHistogram;
+
+TEST(ServerMethodStats, aggregateThreads) {
+  ServerMethodStats stats;
+  constexpr size_t kThreads = 8;
+  constexpr size_t kSamples = 1000;
+  // Keep half of the threads alive while reading the stats, the other half
+  // exits before (their stats are orphaned).
+  std::atomic<size_t> done{0};
+  std::atomic<bool> read{false};
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (size_t i = 0; i < kSamples; ++i) {
+        stats.record(
+            t % 2 ? "odd" : "even",
+            {microseconds(10), microseconds(100), 64, 1024});
+      }
+      ++done;
+      if (t < kThreads / 2) {
+        while (!read) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  while (done < kThreads) {
+    std::this_thread::yield();
+  }
+  for (size_t t = kThreads / 2; t < kThreads; ++t) {
+    threads[t].join();
+  }
+  auto result = stats.getStats();
+  read = true;
+  for (size_t t = 0; t < kThreads / 2; ++t) {
+    threads[t].join();
+  }
+
+  ASSERT_EQ(2, result.size());
+  for (const auto& method : {"odd", "even"}) {
+    const auto& methodStats = result.at(method);
+    EXPECT_EQ(kThreads / 2 * kSamples, methodStats.queueTimeUs.count());
+    EXPECT_EQ(10, methodStats.queueTimeUs.percentile(50));
+    EXPECT_EQ(
+        LogLinearHistogram::bucketUpperBound(
+            LogLinearHistogram::bucketIndex(100)),
+        methodStats.processTimeUs.percentile(50));
+    EXPECT_DOUBLE_EQ(64, methodStats.requestBytes.mean());
+    EXPECT_DOUBLE_EQ(1024, methodStats.responseBytes.mean());
+  }
+  // Exited threads are still accounted for
+  EXPECT_EQ(
+      kThreads / 2 * kSamples, stats.getStats().at("odd").queueTimeUs.count());
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrift/lib/cpp2/async/RequestDeadline.h>
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include <folly/io/async/Request.h>
+
+#include <thrift/lib/cpp/transport/THeader.h>
+#include <thrift/lib/cpp2/server/Cpp2ConnContext.h>
+
+using namespace apache::thrift;
+using namespace std::chrono;
+
+using apache::thrift::transport::THeader;
+
+TEST(RequestDeadline, noDeadline) {
+  THeader header;
+  Cpp2RequestContext ctx(nullptr, &header);
+  EXPECT_FALSE(ctx.getDeadline().hasValue());
+  EXPECT_FALSE(ctx.isDeadlineExceeded());
+}
+
+TEST(RequestDeadline, clientTimeout) {
+  THeader header;
+  header.setClientTimeout(milliseconds(500));
+  auto before = system_clock::now();
+  Cpp2RequestContext ctx(nullptr, &header);
+  auto after = system_clock::now();
+  ASSERT_TRUE(ctx.getDeadline().hasValue());
+  EXPECT_GE(*ctx.getDeadline(), before + milliseconds(500));
+  EXPECT_LE(*ctx.getDeadline(), after + milliseconds(500));
+  EXPECT_FALSE(ctx.isDeadlineExceeded());
+}
+
+TEST(RequestDeadline, propagatedDeadline) {
+  auto deadline = time_point_cast<milliseconds>(
+      system_clock::now() + milliseconds(200));
+  THeader header;
+  header.setDeadline(RequestDeadline::toEpochMs(deadline));
+  Cpp2RequestContext ctx(nullptr, &header);
+  ASSERT_TRUE(ctx.getDeadline().hasValue());
+  EXPECT_TRUE(ctx.isDeadlinePropagated());
+  EXPECT_EQ(
+      deadline + RequestDeadline::clockSkewTolerance(), *ctx.getDeadline());
+  EXPECT_FALSE(ctx.isDeadlineExceeded());
+}
+
+TEST(RequestDeadline, propagatedDeadlineCappedByClientTimeout) {
+  // The caller's clock is far ahead of ours: the client timeout, counted from
+  // the arrival of the request, still bounds the deadline
+  THeader header;
+  header.setDeadline(
+      RequestDeadline::toEpochMs(system_clock::now() + seconds(60)));
+  header.setClientTimeout(milliseconds(100));
+  Cpp2RequestContext ctx(nullptr, &header);
+  auto after = system_clock::now();
+  ASSERT_TRUE(ctx.getDeadline().hasValue());
+  EXPECT_TRUE(ctx.isDeadlinePropagated());
+  EXPECT_LE(*ctx.getDeadline(), after + milliseconds(100));
+}
+
+TEST(RequestDeadline, clientTimeoutIsNotPropagated) {
+  THeader header;
+  header.setClientTimeout(milliseconds(100));
+  Cpp2RequestContext ctx(nullptr, &header);
+  EXPECT_TRUE(ctx.getDeadline().hasValue());
+  EXPECT_FALSE(ctx.isDeadlinePropagated());
+}
+
+TEST(RequestDeadline, toleratedClockSkew) {
+  // The caller's clock is a bit behind ours
+  THeader header;
+  header.setDeadline(
+      RequestDeadline::toEpochMs(system_clock::now() - milliseconds(10)));
+  Cpp2RequestContext ctx(nullptr, &header);
+  EXPECT_FALSE(ctx.isDeadlineExceeded());
+}
+
+TEST(RequestDeadline, expiredDeadline) {
+  THeader header;
+  header.setDeadline(RequestDeadline::toEpochMs(
+      system_clock::now() - RequestDeadline::clockSkewTolerance() -
+      milliseconds(1)));
+  Cpp2RequestContext ctx(nullptr, &header);
+  EXPECT_TRUE(ctx.isDeadlineExceeded());
+}
+
+TEST(RequestDeadline, forwardedTimeout) {
+  auto deadline = system_clock::now() + seconds(10);
+  auto remaining = RequestDeadline::forwardedTimeout(deadline, milliseconds(0));
+  EXPECT_GT(remaining, milliseconds(9000));
+  EXPECT_LE(remaining, milliseconds(10000));
+  // The timeout of the call is kept when sooner
+  EXPECT_EQ(
+      milliseconds(100),
+      RequestDeadline::forwardedTimeout(deadline, milliseconds(100)));
+  // A passed deadline still leaves a positive timeout
+  EXPECT_EQ(
+      milliseconds(1),
+      RequestDeadline::forwardedTimeout(
+          system_clock::now() - seconds(1), milliseconds(0)));
+}
+
+TEST(RequestDeadline, requestContext) {
+  EXPECT_FALSE(RequestDeadline::current().hasValue());
+  auto deadline = system_clock::now() + seconds(1);
+  {
+    folly::ShallowCopyRequestContextScopeGuard guard(
+        RequestDeadline::getRequestToken(),
+        std::make_unique<RequestDeadline>(deadline));
+    ASSERT_TRUE(RequestDeadline::current().hasValue());
+    EXPECT_EQ(deadline, *RequestDeadline::current());
+  }
+  EXPECT_FALSE(RequestDeadline::current().hasValue());
+}
@@ -19,6 +19,8 @@
 #include <memory>
 
 #include <fmt/core.h>
+#include <folly/io/Cursor.h>
+#include <thrift/lib/cpp2/Serialized.h>
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 #include <thrift/lib/cpp2/test/gen-cpp2/TestService.h>
 
@@ -553,3 +555,109 @@ TEST(SerializationTest, BinarySerializedSizeZC) {
 TEST(SerializationTest, CompactSerializedSizeZC) {
   testSerializedSizeZC<CompactSerializer, CompactProtocolWriter>();
 }
+
+TEST(SerializationTest, BinaryFixedSerializedSize) {
+  // Field headers, values and stop of TestFixedSizeStruct and of its nested
+  // TestUnsignedIntStruct
+  constexpr uint32_t kNestedSize = 4 * 3 + (1 + 2 + 4 + 8) + 1;
+  constexpr uint32_t kSize = 5 * 3 + (4 + 8 + 8 + 1 + kNestedSize) + 1;
+  static_assert(
+      TestFixedSizeStruct::__fbthrift_binary_serialized_size == kSize,
+      "Unexpected fixed size for TestFixedSizeStruct");
+
+  TestFixedSizeStruct s;
+  s.i = 42;
+  s.u.u64 = 18446744073709551615ULL;
+  BinaryProtocolWriter w;
+  EXPECT_EQ(kSize, s.serializedSize(&w));
+  EXPECT_EQ(kSize, BinarySerializer::serialize<std::string>(s).size());
+}
+
+TEST(SerializationTest, BinaryFixedSizeContainersSerializedSize) {
+  TestFixedSizeContainersStruct s;
+  for (int32_t i = 0; i < 100; ++i) {
+    TestFixedSizeStruct elem;
+    elem.i = i;
+    s.l.push_back(elem);
+    s.s.insert(i);
+    s.m[i] = elem;
+  }
+
+  BinaryProtocolWriter w;
+  auto serialized = BinarySerializer::serialize<std::string>(s);
+  EXPECT_EQ(serialized.size(), s.serializedSize(&w));
+  EXPECT_EQ(serialized.size(), s.serializedSizeZC(&w));
+  TestFixedSizeContainersStruct out;
+  BinarySerializer::deserialize(serialized, out);
+  EXPECT_EQ(s, out);
+}
+
+std::string ioBufToString(const std::unique_ptr<folly::IOBuf>& buf) {
+  return folly::io::Cursor(buf.get())
+      .readFixedString(buf->computeChainDataLength());
+}
+
+template <class Serializer>
+void testSerializedRoundtrip() {
+  TestSerializedStruct s;
+  s.s = makeTestStruct();
+  s.i = 7;
+
+  auto str = Serializer::template serialize<std::string>(s);
+  TestSerializedStruct out;
+  Serializer::deserialize(str, out);
+  EXPECT_EQ(s.s.value(), out.s.value());
+  EXPECT_EQ(7, out.i);
+
+  // The wrapper writes the same bytes as the struct it holds
+  TestStruct plain = makeTestStruct();
+  EXPECT_EQ(
+      Serializer::template serialize<std::string>(plain),
+      Serializer::template serialize<std::string>(s.s));
+}
+
+TEST(SerializationTest, SerializedBinaryRoundtrip) {
+  testSerializedRoundtrip<BinarySerializer>();
+}
+
+TEST(SerializationTest, SerializedCompactRoundtrip) {
+  testSerializedRoundtrip<CompactSerializer>();
+}
+
+TEST(SerializationTest, SerializedSimpleJSONRoundtrip) {
+  testSerializedRoundtrip<SimpleJSONSerializer>();
+}
+
+TEST(SerializationTest, SerializedCachesBytesUntilMutated) {
+  Serialized<TestStruct> s(makeTestStruct());
+  auto* buf = s.serialized<BinaryProtocolWriter>().get();
+  EXPECT_EQ(buf, s.serialized<BinaryProtocolWriter>().get());
+
+  // Copies share the cached bytes
+  auto copy = s;
+  EXPECT_EQ(buf, copy.serialized<BinaryProtocolWriter>().get());
+
+  copy.mutable_value().i = 49;
+  EXPECT_EQ(48, s.value().i);
+  EXPECT_EQ(buf, s.serialized<BinaryProtocolWriter>().get());
+  EXPECT_EQ(
+      BinarySerializer::serialize<std::string>(copy.value()),
+      ioBufToString(copy.serialized<BinaryProtocolWriter>()));
+}
+
+TEST(SerializationTest, SerializedKeepsReadBytes) {
+  TestSerializedStruct s;
+  s.s = makeTestStruct();
+  auto str = CompactSerializer::serialize<std::string>(s);
+
+  TestSerializedStruct out;
+  CompactSerializer::deserialize(str, out);
+  auto expected = CompactSerializer::serialize<std::string>(makeTestStruct());
+  EXPECT_EQ(expected, ioBufToString(out.s.serialized<CompactProtocolWriter>()));
+  EXPECT_EQ("test", out.s.value().s);
+
+  // Bytes for other protocols are made from the parsed value
+  EXPECT_EQ(
+      BinarySerializer::serialize<std::string>(makeTestStruct()),
+      BinarySerializer::serialize<std::string>(out.s));
+}
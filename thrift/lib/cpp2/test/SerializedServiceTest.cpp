@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <folly/portability/GTest.h>
+#include <thrift/lib/cpp/TProcessorEventHandler.h>
+#include <thrift/lib/cpp2/Serialized.h>
+#include <thrift/lib/cpp2/async/HeaderClientChannel.h>
+#include <thrift/lib/cpp2/test/gen-cpp2/SerializedService.h>
+#include <thrift/lib/cpp2/util/ScopedServerInterfaceThread.h>
+
+using namespace apache::thrift;
+using namespace apache::thrift::test;
+
+namespace {
+
+// Larger than what IOBufQueue copies instead of chaining
+TestStruct makeSnapshot() {
+  TestStruct s;
+  s.s = std::string(16 << 10, 'x');
+  s.i = 42;
+  return s;
+}
+
+bool sharesBuffer(const folly::IOBuf& chain, const folly::IOBuf& buf) {
+  for (auto range : chain) {
+    for (auto other : buf) {
+      if (!range.empty() && range.data() == other.data()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+class SerializedServiceHandler : public SerializedServiceSvIf {
+ public:
+  // Records which serialization of the snapshot each reply carries
+  class SpliceTracker : public TProcessorEventHandler {
+   public:
+    explicit SpliceTracker(const Serialized<TestStruct>& snapshot)
+        : snapshot_(snapshot) {}
+
+    void onWriteData(void*, const char*, const SerializedMessage& msg)
+        override {
+      const auto& cached = msg.protocolType == protocol::T_COMPACT_PROTOCOL
+          ? snapshot_.serialized<CompactProtocolWriter>()
+          : snapshot_.serialized<BinaryProtocolWriter>();
+      std::lock_guard<std::mutex> guard(mutex_);
+      if (sharesBuffer(*msg.buffer, *cached)) {
+        ++splicedReplies_;
+        serializations_.insert(cached.get());
+      }
+    }
+
+    size_t splicedReplies() {
+      std::lock_guard<std::mutex> guard(mutex_);
+      return splicedReplies_;
+    }
+
+    size_t serializations() {
+      std::lock_guard<std::mutex> guard(mutex_);
+      return serializations_.size();
+    }
+
+   private:
+    const Serialized<TestStruct>& snapshot_;
+    std::mutex mutex_;
+    size_t splicedReplies_{0};
+    std::set<const folly::IOBuf*> serializations_;
+  };
+
+  void getSnapshot(Serialized<TestStruct>& ret) override {
+    ret = snapshot_;
+  }
+
+  std::unique_ptr<AsyncProcessor> getProcessor() override {
+    auto processor = SerializedServiceSvIf::getProcessor();
+    processor->addEventHandler(tracker_);
+    return processor;
+  }
+
+  SpliceTracker& tracker() {
+    return *tracker_;
+  }
+
+ private:
+  const Serialized<TestStruct> snapshot_{makeSnapshot()};
+  std::shared_ptr<SpliceTracker> tracker_{
+      std::make_shared<SpliceTracker>(snapshot_)};
+};
+
+void testRepliesShareSerialization(protocol::PROTOCOL_TYPES protocolId) {
+  constexpr size_t kThreads = 4;
+  constexpr size_t kRequestsPerThread = 25;
+
+  auto handler = std::make_shared<SerializedServiceHandler>();
+  ScopedServerInterfaceThread runner(handler);
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&] {
+      auto client = runner.newClient<SerializedServiceAsyncClient>(
+          nullptr, [protocolId](auto socket) mutable {
+            auto channel = HeaderClientChannel::newChannel(std::move(socket));
+            channel->setProtocolId(protocolId);
+            return channel;
+          });
+      for (size_t j = 0; j < kRequestsPerThread; ++j) {
+        Serialized<TestStruct> ret;
+        client->sync_getSnapshot(ret);
+        EXPECT_EQ(makeSnapshot(), ret.value());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Every reply chained the cached bytes, computed once for all of them
+  EXPECT_EQ(kThreads * kRequestsPerThread, handler->tracker().splicedReplies());
+  EXPECT_EQ(1, handler->tracker().serializations());
+}
+
+} // namespace
+
+TEST(SerializedServiceTest, BinaryRepliesShareSerialization) {
+  testRepliesShareSerialization(protocol::T_BINARY_PROTOCOL);
+}
+
+TEST(SerializedServiceTest, CompactRepliesShareSerialization) {
+  testRepliesShareSerialization(protocol::T_COMPACT_PROTOCOL);
+}
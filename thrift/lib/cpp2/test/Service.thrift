@@ -16,6 +16,8 @@
 
 namespace cpp2 apache.thrift.test
 
+cpp_include "thrift/lib/cpp2/Serialized.h"
+
 struct TestStruct {
   1: string s,
   2: i32 i,
@@ -61,6 +63,29 @@ struct TestUnsignedIntMapStruct {
   1: map<UInt32, UInt64> m
 }
 
+struct TestFixedSizeStruct {
+  1: i32 i,
+  2: i64 l,
+  3: double d,
+  4: bool b,
+  5: TestUnsignedIntStruct u,
+}
+
+struct TestFixedSizeContainersStruct {
+  1: list<TestFixedSizeStruct> l,
+  2: set<i64> s,
+  3: map<i32, TestFixedSizeStruct> m,
+}
+
+typedef TestStruct (
+  cpp.type = "::apache::thrift::Serialized<::apache::thrift::test::TestStruct>",
+) SerializedTestStruct
+
+struct TestSerializedStruct {
+  1: SerializedTestStruct s,
+  2: i32 i,
+}
+
 service TestService {
   string sendResponse(1:i64 size)
   oneway void noResponse(1:i64 size)
@@ -74,3 +99,7 @@ service TestService {
   IOBufPtr echoIOBuf(1: IOBuf buf)
   void throwsHandlerException();
 }
+
+service SerializedService {
+  SerializedTestStruct getSnapshot()
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrift/lib/cpp2/server/SlowRequestsLog.h>
+
+#include <gtest/gtest.h>
+
+#include <folly/Conv.h>
+
+using namespace apache::thrift;
+using namespace std::chrono;
+
+namespace {
+
+void finish(
+    SlowRequestsLog& log,
+    const std::string& method,
+    SlowRequestsLog::Clock::time_point now,
+    milliseconds latency) {
+  if (!log.shouldRecord(latency, now)) {
+    return;
+  }
+  SlowRequestsLog::Entry entry;
+  entry.methodName = method;
+  entry.received = now - latency;
+  entry.finished = now;
+  log.record(std::move(entry));
+}
+
+} // namespace
+
+TEST(SlowRequestsLog, disabled) {
+  SlowRequestsLog log(0, seconds(1));
+  EXPECT_FALSE(log.isEnabled());
+  EXPECT_FALSE(log.shouldRecord(seconds(10), SlowRequestsLog::Clock::now()));
+}
+
+TEST(SlowRequestsLog, keepsSlowest) {
+  SlowRequestsLog log(3, seconds(60));
+  auto now = SlowRequestsLog::Clock::now();
+  for (int i = 1; i <= 10; ++i) {
+    finish(log, folly::to<std::string>("m", i), now, milliseconds(i * 10));
+  }
+  finish(log, "fast", now, milliseconds(1));
+
+  auto entries = log.getEntries();
+  ASSERT_EQ(3, entries.size());
+  EXPECT_EQ("m10", entries[0].methodName);
+  EXPECT_EQ("m9", entries[1].methodName);
+  EXPECT_EQ("m8", entries[2].methodName);
+  EXPECT_EQ(milliseconds(100), entries[0].getLatency());
+}
+
+TEST(SlowRequestsLog, windows) {
+  SlowRequestsLog log(2, seconds(10));
+  auto now = SlowRequestsLog::Clock::now();
+  finish(log, "old", now, seconds(5));
+
+  // The outlier of the previous window is still reported, but doesn't
+  // prevent faster requests of the current window from being logged.
+  now += seconds(11);
+  finish(log, "recent", now, milliseconds(100));
+  auto entries = log.getEntries();
+  ASSERT_EQ(2, entries.size());
+  EXPECT_EQ("old", entries[0].methodName);
+  EXPECT_EQ("recent", entries[1].methodName);
+
+  // After two windows, the old outlier is gone
+  now += seconds(11);
+  finish(log, "latest", now, milliseconds(10));
+  entries = log.getEntries();
+  ASSERT_EQ(2, entries.size());
+  EXPECT_EQ("recent", entries[0].methodName);
+  EXPECT_EQ("latest", entries[1].methodName);
+}
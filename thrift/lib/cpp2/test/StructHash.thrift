@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+namespace cpp2 apache.thrift.test
+
+enum Region {
+  US = 1,
+  EU = 2,
+  APAC = 3,
+}
+
+// Typical cache key, with generated std::hash and std::equal_to
+struct CacheKey {
+  1: i64 userId,
+  2: i32 shard,
+  3: Region region,
+  4: bool internal,
+  5: string name,
+  6: optional i32 version,
+} (cpp.define_hash)
+
+// The same key, hashed and compared field by field by hand
+struct PlainCacheKey {
+  1: i64 userId,
+  2: i32 shard,
+  3: Region region,
+  4: bool internal,
+  5: string name,
+  6: optional i32 version,
+}
+
+struct NestedCacheKey {
+  1: CacheKey key,
+  2: double weight,
+  3: binary blob,
+} (cpp.define_hash)
+
+// Containers are hashed element by element
+struct ContainerCacheKey {
+  1: list<CacheKey> keys,
+  2: set<string> tags,
+  3: map<string, i64> limits,
+  4: set<i32> (cpp.template = "std::unordered_set") shards,
+} (cpp.define_hash)
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/container/F14Map.h>
+#include <folly/hash/Hash.h>
+#include <folly/init/Init.h>
+
+#include <thrift/lib/cpp2/test/gen-cpp2/StructHash_types.h>
+
+using apache::thrift::test::CacheKey;
+using apache::thrift::test::PlainCacheKey;
+using apache::thrift::test::Region;
+
+namespace {
+
+constexpr size_t kNumKeys = 1024;
+
+// How keys without cpp.define_hash are usually hashed
+struct PlainCacheKeyHash {
+  size_t operator()(const PlainCacheKey& key) const {
+    return folly::hash::hash_combine(
+        key.userId,
+        key.shard,
+        key.region,
+        key.internal,
+        key.name,
+        key.version_ref().has_value(),
+        key.version_ref().value_or(0));
+  }
+};
+
+template <typename Key>
+std::vector<Key> makeKeys() {
+  std::vector<Key> keys(kNumKeys);
+  for (size_t i = 0; i < kNumKeys; ++i) {
+    keys[i].userId = 1000000 + i * 7919;
+    keys[i].shard = i % 64;
+    keys[i].region = static_cast<Region>(1 + i % 3);
+    keys[i].internal = i % 2;
+    keys[i].name = "snapshot_" + std::to_string(i % 16);
+  }
+  return keys;
+}
+
+template <typename Key, typename Hash>
+void hashKeys(size_t iters) {
+  folly::BenchmarkSuspender setup;
+  auto keys = makeKeys<Key>();
+  Hash hash;
+  setup.dismiss();
+  for (size_t i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(hash(keys[i % kNumKeys]));
+  }
+}
+
+template <typename Key, typename Equal>
+void compareKeys(size_t iters) {
+  folly::BenchmarkSuspender setup;
+  auto keys = makeKeys<Key>();
+  auto copies = keys;
+  Equal equal;
+  setup.dismiss();
+  for (size_t i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(
+        equal(keys[i % kNumKeys], copies[i % kNumKeys]));
+  }
+}
+
+template <typename Key, typename Hash>
+void findKeys(size_t iters) {
+  folly::BenchmarkSuspender setup;
+  auto keys = makeKeys<Key>();
+  folly::F14FastMap<Key, size_t, Hash> map;
+  for (size_t i = 0; i < kNumKeys; ++i) {
+    map.emplace(keys[i], i);
+  }
+  setup.dismiss();
+  for (size_t i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(map.find(keys[i % kNumKeys]));
+  }
+}
+
+} // namespace
+
+BENCHMARK(hash_plain, iters) {
+  hashKeys<PlainCacheKey, PlainCacheKeyHash>(iters);
+}
+
+BENCHMARK_RELATIVE(hash_generated, iters) {
+  hashKeys<CacheKey, std::hash<CacheKey>>(iters);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(equal_plain, iters) {
+  compareKeys<PlainCacheKey, std::equal_to<PlainCacheKey>>(iters);
+}
+
+BENCHMARK_RELATIVE(equal_generated, iters) {
+  compareKeys<CacheKey, std::equal_to<CacheKey>>(iters);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(f14_find_plain, iters) {
+  findKeys<PlainCacheKey, PlainCacheKeyHash>(iters);
+}
+
+BENCHMARK_RELATIVE(f14_find_generated, iters) {
+  findKeys<CacheKey, std::hash<CacheKey>>(iters);
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <folly/container/F14Set.h>
+#include <folly/portability/GTest.h>
+
+#include <thrift/lib/cpp2/test/gen-cpp2/StructHash_types.h>
+
+using apache::thrift::test::CacheKey;
+using apache::thrift::test::ContainerCacheKey;
+using apache::thrift::test::NestedCacheKey;
+using apache::thrift::test::Region;
+
+namespace {
+
+CacheKey makeKey() {
+  CacheKey key;
+  key.userId = 1234567;
+  key.shard = 42;
+  key.region = Region::EU;
+  key.internal = true;
+  key.name = "snapshot";
+  return key;
+}
+
+size_t hash(const CacheKey& key) {
+  return std::hash<CacheKey>()(key);
+}
+
+} // namespace
+
+TEST(StructHashTest, EqualKeysHashEqual) {
+  auto a = makeKey();
+  auto b = makeKey();
+  EXPECT_TRUE(std::equal_to<CacheKey>()(a, b));
+  EXPECT_EQ(hash(a), hash(b));
+  EXPECT_EQ(hash(a), folly::hasher<CacheKey>()(a));
+}
+
+TEST(StructHashTest, EqualToMatchesOperatorEquals) {
+  auto base = makeKey();
+  std::vector<CacheKey> keys(7, base);
+  keys[1].userId = 7654321;
+  keys[2].shard = 43;
+  keys[3].region = Region::US;
+  keys[4].internal = false;
+  keys[5].name = "snapshots";
+  keys[6].version_ref() = 2;
+
+  std::equal_to<CacheKey> equal;
+  for (auto& a : keys) {
+    for (auto& b : keys) {
+      EXPECT_EQ(a == b, equal(a, b));
+    }
+    if (!(a == base)) {
+      EXPECT_NE(hash(base), hash(a));
+    }
+  }
+}
+
+TEST(StructHashTest, UnsetOptionalFieldIsIgnored) {
+  auto a = makeKey();
+  auto b = makeKey();
+  // Assigned without being marked as set
+  b.version_ref().value_unchecked() = 3;
+  EXPECT_TRUE(std::equal_to<CacheKey>()(a, b));
+  EXPECT_EQ(hash(a), hash(b));
+
+  b.version_ref() = 0;
+  EXPECT_FALSE(std::equal_to<CacheKey>()(a, b));
+}
+
+TEST(StructHashTest, NestedKeys) {
+  NestedCacheKey a;
+  a.key = makeKey();
+  a.weight = 0.0;
+  a.blob = "data";
+  auto b = a;
+  b.weight = -0.0;
+  EXPECT_TRUE(std::equal_to<NestedCacheKey>()(a, b));
+  EXPECT_EQ(std::hash<NestedCacheKey>()(a), std::hash<NestedCacheKey>()(b));
+
+  b.key.shard = 0;
+  EXPECT_FALSE(std::equal_to<NestedCacheKey>()(a, b));
+}
+
+TEST(StructHashTest, HashContainers) {
+  auto other = makeKey();
+  other.userId = 1;
+
+  folly::F14FastSet<CacheKey> f14{makeKey(), other};
+  EXPECT_EQ(2, f14.size());
+  EXPECT_EQ(1, f14.count(makeKey()));
+
+  std::unordered_set<CacheKey> set{makeKey(), makeKey(), other};
+  EXPECT_EQ(2, set.size());
+}
+
+TEST(StructHashTest, ContainerFields) {
+  ContainerCacheKey a;
+  a.keys = {makeKey()};
+  a.tags = {"a", "b"};
+  a.limits = {{"qps", 100}};
+  for (int32_t shard = 0; shard < 100; ++shard) {
+    a.shards.insert(shard);
+  }
+  // Same shards, inserted in another order
+  ContainerCacheKey b = a;
+  b.shards.clear();
+  for (int32_t shard = 99; shard >= 0; --shard) {
+    b.shards.insert(shard);
+  }
+  EXPECT_TRUE(std::equal_to<ContainerCacheKey>()(a, b));
+  EXPECT_EQ(
+      std::hash<ContainerCacheKey>()(a), std::hash<ContainerCacheKey>()(b));
+
+  b.keys.front().shard = 0;
+  EXPECT_FALSE(std::equal_to<ContainerCacheKey>()(a, b));
+  EXPECT_NE(
+      std::hash<ContainerCacheKey>()(a), std::hash<ContainerCacheKey>()(b));
+
+  b = a;
+  b.limits["qps"] = 200;
+  EXPECT_FALSE(std::equal_to<ContainerCacheKey>()(a, b));
+  EXPECT_NE(
+      std::hash<ContainerCacheKey>()(a), std::hash<ContainerCacheKey>()(b));
+}
@@ -25,6 +25,7 @@
 
 #include <thrift/lib/cpp/transport/THeader.h>
 #include <thrift/lib/cpp2/async/RequestCallback.h>
+#include <thrift/lib/cpp2/async/RequestDeadline.h>
 #include <thrift/lib/thrift/gen-cpp2/RpcMetadata_types.h>
 
 namespace apache {
@@ -42,10 +43,17 @@ RequestRpcMetadata makeRequestRpcMetadata(
   uint64_t flags = 0;
   metadata.protocol_ref() = protocolId;
   metadata.kind_ref() = kind;
-  if (rpcOptions.getTimeout() > std::chrono::milliseconds::zero()) {
-    metadata.clientTimeoutMs_ref() = rpcOptions.getTimeout().count();
-  } else if (defaultChannelTimeout > std::chrono::milliseconds::zero()) {
-    metadata.clientTimeoutMs_ref() = defaultChannelTimeout.count();
+  auto timeout = rpcOptions.getTimeout() > std::chrono::milliseconds::zero()
+      ? rpcOptions.getTimeout()
+      : defaultChannelTimeout;
+  if (auto deadline = RequestDeadline::current()) {
+    // Forward the deadline of the server request this call is made for,
+    // along with the time left, which bounds it whatever the clocks
+    metadata.deadlineMs_ref() = RequestDeadline::toEpochMs(*deadline).count();
+    timeout = RequestDeadline::forwardedTimeout(*deadline, timeout);
+  }
+  if (timeout > std::chrono::milliseconds::zero()) {
+    metadata.clientTimeoutMs_ref() = timeout.count();
   }
   if (rpcOptions.getQueueTimeout() > std::chrono::milliseconds::zero()) {
     metadata.queueTimeoutMs_ref() = rpcOptions.getQueueTimeout().count();
@@ -39,7 +39,7 @@ void ThriftProcessor::onThriftRequest(
     RequestRpcMetadata&& metadata,
     std::unique_ptr<IOBuf> payload,
     std::shared_ptr<ThriftChannelIf> channel,
-    std::unique_ptr<Cpp2ConnContext> connContext) noexcept {
+    std::shared_ptr<Cpp2ConnContext> connContext) noexcept {
   DCHECK(payload);
   DCHECK(channel);
   DCHECK(tm_);
@@ -78,6 +78,24 @@ void ThriftProcessor::onThriftRequest(
     return;
   }
 
+  if (UNLIKELY(!request->admit())) {
+    evb->runInEventBaseThread([request = std::move(request),
+                               &errorCode =
+                                   serverConfigs_.getOverloadedErrorCode()]() {
+      request->sendErrorWrapped(
+          folly::make_exception_wrapper<TApplicationException>(
+              TApplicationException::LOADSHEDDING,
+              "adaptive loadshedding rejection"),
+          errorCode);
+    });
+    return;
+  }
+
+  if (auto* methodStats = serverConfigs_.getMethodStats()) {
+    request->enableTimings(payload->computeChainDataLength());
+    request->setMethodStats(methodStats);
+  }
+
   auto protoId = request->getProtoId();
   auto reqContext = request->getRequestContext();
   cpp2Processor_->process(
@@ -56,12 +56,13 @@ class ThriftProcessor {
   // "payload" contains the non-stream parameters of the function.
   // "channel" is used to call back with the response for single
   // (non-streaming) responses, and to manage stream objects for RPCs
-  // with streaming.
+  // with streaming.  "connContext" may be shared by all the RPCs of a
+  // connection, a new one is created if it is not provided.
   virtual void onThriftRequest(
       RequestRpcMetadata&& metadata,
       std::unique_ptr<folly::IOBuf> payload,
       std::shared_ptr<ThriftChannelIf> channel,
-      std::unique_ptr<Cpp2ConnContext> connContext = nullptr) noexcept;
+      std::shared_ptr<Cpp2ConnContext> connContext = nullptr) noexcept;
 
   // Called from the server initialization code if there's an update
   // to the thread manager used to manage the server
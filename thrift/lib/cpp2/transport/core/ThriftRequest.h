@@ -42,6 +42,7 @@
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 #include <thrift/lib/cpp2/server/Cpp2ConnContext.h>
 #include <thrift/lib/cpp2/server/ServerConfigs.h>
+#include <thrift/lib/cpp2/server/admission_strategy/AdmissionStrategy.h>
 #include <thrift/lib/cpp2/transport/core/ThriftChannelIf.h>
 #include <thrift/lib/thrift/gen-cpp2/RpcMetadata_types.h>
 
@@ -87,6 +88,9 @@ class ThriftRequestCore : public ResponseChannelRequest {
       clientQueueTimeout_ = std::chrono::milliseconds(*queueTimeoutMs);
       header_.setClientQueueTimeout(clientQueueTimeout_);
     }
+    if (auto deadlineMs = metadata.deadlineMs_ref()) {
+      header_.setDeadline(std::chrono::milliseconds(*deadlineMs));
+    }
     if (auto priority = metadata.priority_ref()) {
       header_.setCallPriority(static_cast<concurrency::PRIORITY>(*priority));
     }
@@ -107,6 +111,7 @@ class ThriftRequestCore : public ResponseChannelRequest {
   }
 
   ~ThriftRequestCore() override {
+    recordMethodStats(getMethodName());
     cancelTimeout();
     serverConfigs_.decActiveRequests();
   }
@@ -142,6 +147,26 @@ class ThriftRequestCore : public ResponseChannelRequest {
     return reqContext_.getMethodName();
   }
 
+  /**
+   * Run the server's admission strategy on this request. If the request is
+   * admitted, the selected controller is attached to it, so that it gets
+   * notified when processing starts and when the response is sent.
+   */
+  bool admit() {
+    auto admissionStrategy = serverConfigs_.getAdmissionStrategy();
+    if (!admissionStrategy ||
+        admissionStrategy->getType() == AdmissionStrategy::ACCEPT_ALL) {
+      return true;
+    }
+    auto admissionController =
+        admissionStrategy->select(getMethodName(), &header_);
+    if (!admissionController->admit()) {
+      return false;
+    }
+    setAdmissionController(std::move(admissionController));
+    return true;
+  }
+
   void sendReply(
       std::unique_ptr<folly::IOBuf>&& buf,
       apache::thrift::MessageChannel::SendCallback*,
@@ -245,6 +270,9 @@ class ThriftRequestCore : public ResponseChannelRequest {
       apache::thrift::MessageChannel::SendCallback* = nullptr) final {
     if (active_.exchange(false)) {
       cancelTimeout();
+      if (getTimings()) {
+        setResponseSent(0);
+      }
       sendErrorWrappedInternal(std::move(ew), exCode);
     }
   }
@@ -253,6 +281,13 @@ class ThriftRequestCore : public ResponseChannelRequest {
     return checksumRequested_;
   }
 
+  void onDeadlineExceeded() override {
+    serverConfigs_.incDeadlineExceededRequests();
+    if (auto* observer = serverConfigs_.getObserver()) {
+      observer->deadlineExceeded();
+    }
+  }
+
  protected:
   virtual void sendThriftResponse(
       ResponseRpcMetadata&& metadata,
@@ -457,8 +492,14 @@ class ThriftRequestCore : public ResponseChannelRequest {
 
   bool checkResponseSize(const folly::IOBuf& buf) {
     auto maxResponseSize = serverConfigs_.getMaxResponseSize();
-    return maxResponseSize == 0 ||
-        buf.computeChainDataLength() <= maxResponseSize;
+    if (maxResponseSize == 0 && !getTimings()) {
+      return true;
+    }
+    auto responseSize = buf.computeChainDataLength();
+    if (getTimings()) {
+      setResponseSent(responseSize);
+    }
+    return maxResponseSize == 0 || responseSize <= maxResponseSize;
   }
 
   class QueueTimeout : public folly::HHWheelTimer::Callback {
@@ -531,13 +572,13 @@ class ThriftRequest final : public ThriftRequestCore {
       server::ServerConfigs& serverConfigs,
       std::shared_ptr<ThriftChannelIf> channel,
       RequestRpcMetadata&& metadata,
-      std::unique_ptr<Cpp2ConnContext> connContext)
+      std::shared_ptr<Cpp2ConnContext> connContext)
       : ThriftRequestCore(
             serverConfigs,
             std::move(metadata),
             [&]() -> Cpp2ConnContext& {
               if (!connContext) {
-                connContext = std::make_unique<Cpp2ConnContext>();
+                connContext = std::make_shared<Cpp2ConnContext>();
               }
               return *connContext;
             }()),
@@ -571,7 +612,7 @@ class ThriftRequest final : public ThriftRequestCore {
 
  private:
   std::shared_ptr<ThriftChannelIf> channel_;
-  std::unique_ptr<Cpp2ConnContext> connContext_;
+  std::shared_ptr<Cpp2ConnContext> connContext_;
 };
 
 } // namespace thrift
@@ -21,6 +21,7 @@
 #include <thrift/lib/cpp/transport/THeader.h>
 #include <thrift/lib/cpp2/async/ResponseChannel.h>
 #include <thrift/lib/cpp2/server/ServerConfigs.h>
+#include <thrift/lib/cpp2/server/admission_strategy/AcceptAllAdmissionStrategy.h>
 #include <thrift/lib/cpp2/transport/core/testutil/FakeServerObserver.h>
 
 namespace apache {
@@ -75,6 +76,10 @@ class ServerConfigsMock : public ServerConfigs {
     return false;
   }
 
+  std::shared_ptr<AdmissionStrategy> getAdmissionStrategy() const override {
+    return admissionStrategy_;
+  }
+
   void onConnectionSetup(
       std::unique_ptr<RequestSetupMetadata> /*setupMetadata*/) override {
     // TODO: honor the setup metadata sent from the client on connection
@@ -90,6 +95,8 @@ class ServerConfigsMock : public ServerConfigs {
       std::make_shared<FakeServerObserver>()};
   size_t numIOWorkerThreads_{10};
   std::chrono::milliseconds streamExpireTime_{std::chrono::minutes(1)};
+  std::shared_ptr<AdmissionStrategy> admissionStrategy_{
+      std::make_shared<AcceptAllAdmissionStrategy>()};
 };
 
 } // namespace server
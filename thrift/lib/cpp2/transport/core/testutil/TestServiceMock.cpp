@@ -102,6 +102,16 @@ void TestServiceMock::hello(
     std::unique_ptr<std::string> name) {
   hello_(*name);
   result = "Hello, " + *name;
+
+  // Count the requests made on the connection in its context
+  auto ctx = getConnectionContext();
+  auto count = static_cast<int32_t*>(ctx->getUserData());
+  if (!count) {
+    count = new int32_t(0);
+    ctx->setUserData(
+        count, [](void* data) { delete static_cast<int32_t*>(data); });
+  }
+  connectionRequests_ = ++*count;
 }
 
 void TestServiceMock::checkPort(int32_t port) {
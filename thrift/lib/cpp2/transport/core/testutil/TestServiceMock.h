@@ -65,8 +65,14 @@ class TestServiceMock : public TestServiceSvIf {
 
   void onewayLogBlob(std::unique_ptr<folly::IOBuf> val) override;
 
+  // Requests to hello() made on the connection of the last one
+  int32_t getConnectionRequests() const {
+    return connectionRequests_;
+  }
+
  protected:
   std::atomic<int32_t> sum{0};
+  std::atomic<int32_t> connectionRequests_{0};
 };
 
 class IntermHeaderService : public IntermHeaderServiceSvIf {
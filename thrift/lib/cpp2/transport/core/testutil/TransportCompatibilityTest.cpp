@@ -308,6 +308,17 @@ void TransportCompatibilityTest::TestConnectionContext() {
   });
 }
 
+void TransportCompatibilityTest::TestConnectionContextSharedByRequests() {
+  connectToServer([this](std::unique_ptr<TestServiceAsyncClient> client) {
+    EXPECT_CALL(*handler_.get(), hello_("world")).Times(3);
+    for (int i = 1; i <= 3; ++i) {
+      EXPECT_EQ("Hello, world", client->future_hello("world").get());
+      // Every request of the connection sees the same connection context
+      EXPECT_EQ(i, handler_->getConnectionRequests());
+    }
+  });
+}
+
 void TransportCompatibilityTest::TestClientIdentityHook() {
   bool flag{false};
   auto hook = [&flag](
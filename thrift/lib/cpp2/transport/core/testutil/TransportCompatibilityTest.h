@@ -118,6 +118,7 @@ class TransportCompatibilityTest {
   void TestConnectionStats();
   void TestObserverSendReceiveRequests();
   void TestConnectionContext();
+  void TestConnectionContextSharedByRequests();
   void TestClientIdentityHook();
 
  protected:
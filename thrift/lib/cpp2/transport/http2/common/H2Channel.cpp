@@ -65,26 +65,32 @@ void H2Channel::encodeHeaders(
 void H2Channel::decodeHeaders(
     const HTTPMessage& source,
     map<string, string>& dest) noexcept {
-  auto decodeAndCopyKeyValue = [&](const string& key, const string& val) {
-    // This decodes key-value pairs that have been encoded using
-    // encodeHeaders() or equivalent methods.  If the key starts with
-    // "encode_", the value is split at the underscore and then the
-    // key and value are decoded from there.  The key is not used
-    // because it will get converted to lowercase and therefore the
-    // original key cannot be recovered.
-    if (key.find("encode_") == 0) {
-      auto us = val.find("_");
-      if (us != string::npos) {
-        auto decodedKey = proxygen::Base64::urlDecode(val.substr(0, us));
-        auto decodedVal = proxygen::Base64::urlDecode(val.substr(us + 1));
-        dest[decodedKey] = decodedVal;
-        return;
-      }
-      LOG(ERROR) << "Encoded value does not contain '_'; preserving original";
+  source.getHeaders().forEach([&](const string& key, const string& val) {
+    decodeHeader(key, val, dest);
+  });
+}
+
+void H2Channel::decodeHeader(
+    const string& key,
+    const string& val,
+    map<string, string>& dest) noexcept {
+  // This decodes key-value pairs that have been encoded using
+  // encodeHeaders() or equivalent methods.  If the key starts with
+  // "encode_", the value is split at the underscore and then the
+  // key and value are decoded from there.  The key is not used
+  // because it will get converted to lowercase and therefore the
+  // original key cannot be recovered.
+  if (key.find("encode_") == 0) {
+    auto us = val.find("_");
+    if (us != string::npos) {
+      auto decodedKey = proxygen::Base64::urlDecode(val.substr(0, us));
+      auto decodedVal = proxygen::Base64::urlDecode(val.substr(us + 1));
+      dest[decodedKey] = decodedVal;
+      return;
     }
-    dest[key] = val;
-  };
-  source.getHeaders().forEach(decodeAndCopyKeyValue);
+    LOG(ERROR) << "Encoded value does not contain '_'; preserving original";
+  }
+  dest[key] = val;
 }
 
 } // namespace thrift
@@ -109,6 +109,12 @@ class H2Channel : public ThriftChannelIf {
       const proxygen::HTTPMessage& source,
       std::map<std::string, std::string>& dest) noexcept;
 
+  // Decodes a single header, see decodeHeaders().
+  static void decodeHeader(
+      const std::string& key,
+      const std::string& val,
+      std::map<std::string, std::string>& dest) noexcept;
+
   // Used to write messages to HTTP/2 on the server side.
   // Owned by H2RequestHandler.  Should not be used after
   // onH2StreamClosed() has been called.
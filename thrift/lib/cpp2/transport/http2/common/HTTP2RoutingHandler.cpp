@@ -71,6 +71,9 @@ class HTTP2RoutingSessionManager : public proxygen::HTTPSession::InfoCallback,
     }
     VLOG(4) << "Created new session for peer " << *peerAddress;
 
+    // Shared by all the streams of the session
+    connContext_ = std::make_shared<Cpp2ConnContext>(peerAddress);
+
     // Create the DownstreamSession.  Note that "this" occurs twice
     // because it acts as both a controller as well as a info
     // callback.
@@ -103,7 +106,8 @@ class HTTP2RoutingSessionManager : public proxygen::HTTPSession::InfoCallback,
     msg->setClientAddress(clientAddr);
     msg->setDstAddress(vipAddr);
 
-    proxygen::RequestHandler* handler = new ThriftRequestHandler(processor_);
+    proxygen::RequestHandler* handler =
+        new ThriftRequestHandler(processor_, connContext_);
     return new proxygen::RequestHandlerAdaptor(handler);
   }
 
@@ -120,6 +124,8 @@ class HTTP2RoutingSessionManager : public proxygen::HTTPSession::InfoCallback,
   std::unique_ptr<proxygen::HTTPServerAcceptor> acceptor_;
 
   ThriftProcessor* processor_;
+
+  std::shared_ptr<Cpp2ConnContext> connContext_;
 };
 
 } // anonymous namespace
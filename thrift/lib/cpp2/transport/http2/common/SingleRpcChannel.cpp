@@ -59,8 +59,11 @@ static constexpr folly::StringPiece kThriftContentType = "application/x-thrift";
 
 SingleRpcChannel::SingleRpcChannel(
     ResponseHandler* toHttp2,
-    ThriftProcessor* processor)
-    : H2Channel(toHttp2), processor_(processor) {
+    ThriftProcessor* processor,
+    std::shared_ptr<Cpp2ConnContext> connContext)
+    : H2Channel(toHttp2),
+      processor_(processor),
+      connContext_(std::move(connContext)) {
   evb_ = EventBaseManager::get()->getExistingEventBase();
 }
 
@@ -144,27 +147,33 @@ void SingleRpcChannel::sendThriftRequest(
         std::chrono::milliseconds(*clientTimeoutMs));
   }
 
-  auto otherMetadata = std::map<std::string, std::string>();
   if (auto other = metadata.otherMetadata_ref()) {
-    otherMetadata = std::move(*other);
+    encodeHeaders(*other, msg);
   }
+  // The Thrift headers are valid HTTP headers, they don't need to go
+  // through encodeHeaders().
   if (auto clientTimeoutMs = metadata.clientTimeoutMs_ref()) {
-    otherMetadata[transport::THeader::CLIENT_TIMEOUT_HEADER] =
-        folly::to<string>(*clientTimeoutMs);
+    msgHeaders.set(
+        transport::THeader::CLIENT_TIMEOUT_HEADER,
+        folly::to<string>(*clientTimeoutMs));
   }
   if (auto queueTimeoutMs = metadata.queueTimeoutMs_ref()) {
     DCHECK(*queueTimeoutMs > 0);
-    otherMetadata[transport::THeader::QUEUE_TIMEOUT_HEADER] =
-        folly::to<string>(*queueTimeoutMs);
+    msgHeaders.set(
+        transport::THeader::QUEUE_TIMEOUT_HEADER,
+        folly::to<string>(*queueTimeoutMs));
+  }
+  if (auto deadlineMs = metadata.deadlineMs_ref()) {
+    msgHeaders.set(
+        transport::THeader::DEADLINE_HEADER, folly::to<string>(*deadlineMs));
   }
   if (auto priority = metadata.priority_ref()) {
-    otherMetadata[transport::THeader::PRIORITY_HEADER] =
-        folly::to<string>(*priority);
+    msgHeaders.set(
+        transport::THeader::PRIORITY_HEADER, folly::to<string>(*priority));
   }
   if (auto kind = metadata.kind_ref()) {
-    otherMetadata[RPC_KIND.str()] = folly::to<string>(*kind);
+    msgHeaders.set(RPC_KIND, folly::to<string>(*kind));
   }
-  encodeHeaders(std::move(otherMetadata), msg);
   httpTransaction_->sendHeaders(msg);
 
   httpTransaction_->sendBody(std::move(payload));
@@ -277,8 +286,9 @@ void SingleRpcChannel::onThriftRequest() noexcept {
     receivedThriftRPC_ = true;
   }
   metadata.seqId_ref() = 0;
-  auto connContext =
-      std::make_unique<Cpp2ConnContext>(&headers_->getClientAddress());
+  auto connContext = connContext_
+      ? std::move(connContext_)
+      : std::make_shared<Cpp2ConnContext>(&headers_->getClientAddress());
   processor_->onThriftRequest(
       std::move(metadata),
       std::move(contents_),
@@ -341,52 +351,51 @@ void SingleRpcChannel::onThriftResponse() noexcept {
 
 void SingleRpcChannel::extractHeaderInfo(
     RequestRpcMetadata* metadata) noexcept {
-  map<string, string> headers;
-  decodeHeaders(*headers_, headers);
-  auto iter = headers.find(transport::THeader::CLIENT_TIMEOUT_HEADER);
-  if (iter != headers.end()) {
-    try {
-      metadata->clientTimeoutMs_ref() = folly::to<int64_t>(iter->second);
-    } catch (const std::range_error&) {
-      LOG(INFO) << "Bad client timeout " << iter->second;
-    }
-    headers.erase(iter);
-  }
-  iter = headers.find(transport::THeader::QUEUE_TIMEOUT_HEADER);
-  if (iter != headers.end()) {
-    try {
-      metadata->queueTimeoutMs_ref() = folly::to<int64_t>(iter->second);
-    } catch (const std::range_error&) {
-      LOG(INFO) << "Bad client timeout " << iter->second;
-    }
-    headers.erase(iter);
-  }
-  iter = headers.find(transport::THeader::PRIORITY_HEADER);
-  if (iter != headers.end()) {
-    try {
-      auto pr = static_cast<RpcPriority>(folly::to<int32_t>(iter->second));
-      if (pr < RpcPriority::N_PRIORITIES) {
-        metadata->priority_ref() = pr;
-      } else {
-        LOG(INFO) << "Too large value for method priority " << iter->second;
+  // The Thrift headers go straight to their metadata field, only the other
+  // headers are copied.
+  map<string, string> otherMetadata;
+  headers_->getHeaders().forEach([&](const string& key, const string& val) {
+    if (key == transport::THeader::CLIENT_TIMEOUT_HEADER) {
+      try {
+        metadata->clientTimeoutMs_ref() = folly::to<int64_t>(val);
+      } catch (const std::range_error&) {
+        LOG(INFO) << "Bad client timeout " << val;
       }
-    } catch (const std::range_error&) {
-      LOG(INFO) << "Bad method priority " << iter->second;
-    }
-    headers.erase(iter);
-  }
-  iter = headers.find(RPC_KIND.str());
-  if (iter != headers.end()) {
-    try {
-      metadata->kind_ref() =
-          static_cast<RpcKind>(folly::to<int32_t>(iter->second));
-    } catch (const std::range_error&) {
-      LOG(INFO) << "Bad Request Kind " << iter->second;
+    } else if (key == transport::THeader::QUEUE_TIMEOUT_HEADER) {
+      try {
+        metadata->queueTimeoutMs_ref() = folly::to<int64_t>(val);
+      } catch (const std::range_error&) {
+        LOG(INFO) << "Bad client timeout " << val;
+      }
+    } else if (key == transport::THeader::DEADLINE_HEADER) {
+      try {
+        metadata->deadlineMs_ref() = folly::to<int64_t>(val);
+      } catch (const std::range_error&) {
+        LOG(INFO) << "Bad deadline " << val;
+      }
+    } else if (key == transport::THeader::PRIORITY_HEADER) {
+      try {
+        auto pr = static_cast<RpcPriority>(folly::to<int32_t>(val));
+        if (pr < RpcPriority::N_PRIORITIES) {
+          metadata->priority_ref() = pr;
+        } else {
+          LOG(INFO) << "Too large value for method priority " << val;
+        }
+      } catch (const std::range_error&) {
+        LOG(INFO) << "Bad method priority " << val;
+      }
+    } else if (key == RPC_KIND) {
+      try {
+        metadata->kind_ref() = static_cast<RpcKind>(folly::to<int32_t>(val));
+      } catch (const std::range_error&) {
+        LOG(INFO) << "Bad Request Kind " << val;
+      }
+    } else {
+      decodeHeader(key, val, otherMetadata);
     }
-    headers.erase(iter);
-  }
-  if (!headers.empty()) {
-    metadata->otherMetadata_ref() = std::move(headers);
+  });
+  if (!otherMetadata.empty()) {
+    metadata->otherMetadata_ref() = std::move(otherMetadata);
   }
 }
 
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include <folly/FixedString.h>
@@ -23,6 +24,7 @@
 
 #include <proxygen/lib/http/session/HTTPTransaction.h>
 #include <thrift/lib/cpp/protocol/TProtocolTypes.h>
+#include <thrift/lib/cpp2/server/Cpp2ConnContext.h>
 #include <thrift/lib/cpp2/transport/http2/common/H2Channel.h>
 
 namespace apache {
@@ -30,9 +32,12 @@ namespace thrift {
 
 class SingleRpcChannel : public H2Channel {
  public:
+  // "connContext" is shared by the streams of the connection, a new context
+  // is created for the request if it is null.
   SingleRpcChannel(
       proxygen::ResponseHandler* toHttp2,
-      ThriftProcessor* processor);
+      ThriftProcessor* processor,
+      std::shared_ptr<Cpp2ConnContext> connContext = nullptr);
 
   SingleRpcChannel(
       folly::EventBase& evb,
@@ -70,6 +75,8 @@ class SingleRpcChannel : public H2Channel {
   // The client side handling code for onH2StreamEnd().
   void onThriftResponse() noexcept;
 
+  // Maps the Thrift headers onto the metadata fields, the others are
+  // copied into otherMetadata.
   void extractHeaderInfo(RequestRpcMetadata* metadata) noexcept;
 
   // Called from onThriftRequest() to send an error response.
@@ -82,6 +89,9 @@ class SingleRpcChannel : public H2Channel {
   // Owned by H2ThriftServer.
   ThriftProcessor* processor_{nullptr};
 
+  // Context of the connection (server side only).
+  std::shared_ptr<Cpp2ConnContext> connContext_;
+
   // Event base on which all methods in this object must be invoked.
   folly::EventBase* evb_{nullptr};
 
@@ -22,6 +22,7 @@
 #include <proxygen/httpserver/ScopedHTTPServer.h>
 
 #include <thrift/lib/cpp/async/TAsyncSocket.h>
+#include <thrift/lib/cpp/transport/THeader.h>
 #include <thrift/lib/cpp2/protocol/CompactProtocol.h>
 #include <thrift/lib/cpp2/transport/core/ThriftClientCallback.h>
 #include <thrift/lib/cpp2/transport/core/testutil/CoreTestFixture.h>
@@ -71,6 +72,28 @@ INSTANTIATE_TEST_CASE_P(
     SingleRpcChannelTest,
     testing::Values(0, 1, 2, 4, 10));
 
+TEST_F(ChannelTestFixture, ThriftHeadersNotInOtherMetadata) {
+  apache::thrift::server::ServerConfigsMock server;
+  EchoProcessor processor(
+      server, "extrakey", "extravalue", "<eom>", eventBase_.get());
+  unordered_map<string, string> inputHeaders;
+  inputHeaders["key1"] = "value1";
+  inputHeaders[transport::THeader::CLIENT_TIMEOUT_HEADER] = "100";
+  inputHeaders[transport::THeader::QUEUE_TIMEOUT_HEADER] = "10";
+  inputHeaders[transport::THeader::PRIORITY_HEADER] = "1";
+  string inputPayload = "single stream payload";
+  unordered_map<string, string>* outputHeaders;
+  IOBuf* outputPayload;
+  sendAndReceiveStream(
+      &processor, inputHeaders, inputPayload, 0, outputHeaders, outputPayload);
+  // The Thrift headers are mapped to their metadata fields, so they are not
+  // echoed back with the other metadata.
+  EXPECT_EQ(2, outputHeaders->size());
+  EXPECT_EQ("value1", outputHeaders->at("key1"));
+  EXPECT_EQ("extravalue", outputHeaders->at("extrakey"));
+  EXPECT_EQ("single stream payload<eom>", toString(outputPayload));
+}
+
 TEST_F(ChannelTestFixture, SingleRpcChannelErrorEmptyBody) {
   apache::thrift::server::ServerConfigsMock server;
   EchoProcessor processor(
@@ -28,7 +28,7 @@ void EchoProcessor::onThriftRequest(
     RequestRpcMetadata&& metadata,
     std::unique_ptr<folly::IOBuf> payload,
     std::shared_ptr<ThriftChannelIf> channel,
-    std::unique_ptr<Cpp2ConnContext> /* connContext */) noexcept {
+    std::shared_ptr<Cpp2ConnContext> /* connContext */) noexcept {
   evb_->runInEventBaseThread([this,
                               evbMetadata = std::move(metadata),
                               evbPayload = std::move(payload),
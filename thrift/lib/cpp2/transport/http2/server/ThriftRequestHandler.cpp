@@ -27,14 +27,17 @@ using proxygen::ProxygenError;
 using proxygen::RequestHandler;
 using proxygen::UpgradeProtocol;
 
-ThriftRequestHandler::ThriftRequestHandler(ThriftProcessor* processor)
-    : processor_(processor) {}
+ThriftRequestHandler::ThriftRequestHandler(
+    ThriftProcessor* processor,
+    std::shared_ptr<Cpp2ConnContext> connContext)
+    : processor_(processor), connContext_(std::move(connContext)) {}
 
 ThriftRequestHandler::~ThriftRequestHandler() {}
 
 void ThriftRequestHandler::onRequest(
     std::unique_ptr<HTTPMessage> headers) noexcept {
-  channel_ = std::make_shared<SingleRpcChannel>(downstream_, processor_);
+  channel_ = std::make_shared<SingleRpcChannel>(
+      downstream_, processor_, std::move(connContext_));
   channel_->onH2StreamBegin(std::move(headers));
 }
 
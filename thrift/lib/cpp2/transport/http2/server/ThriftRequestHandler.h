@@ -38,7 +38,11 @@ namespace thrift {
  */
 class ThriftRequestHandler : public proxygen::RequestHandler {
  public:
-  explicit ThriftRequestHandler(ThriftProcessor* processor);
+  // "connContext" is shared by all the streams of the HTTP/2 connection.
+  // If null, each request gets its own context.
+  explicit ThriftRequestHandler(
+      ThriftProcessor* processor,
+      std::shared_ptr<Cpp2ConnContext> connContext = nullptr);
 
   ~ThriftRequestHandler() override;
 
@@ -59,6 +63,7 @@ class ThriftRequestHandler : public proxygen::RequestHandler {
   // There is a single ThriftProcessor object which is used for all requests.
   // Owned by H2ThriftServer.
   ThriftProcessor* processor_;
+  std::shared_ptr<Cpp2ConnContext> connContext_;
   // The channel used with this request handler.  The request handler
   // creates the channel object.
   std::shared_ptr<H2Channel> channel_;
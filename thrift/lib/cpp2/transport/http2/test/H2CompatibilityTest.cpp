@@ -106,6 +106,10 @@ TEST_F(H2CompatibilityTest, RequestResponse_ResponseSizeTooBig) {
   compatibilityTest_->TestRequestResponse_ResponseSizeTooBig();
 }
 
+TEST_F(H2CompatibilityTest, ConnectionContextSharedByRequests) {
+  compatibilityTest_->TestConnectionContextSharedByRequests();
+}
+
 TEST_F(H2CompatibilityTest, Oneway_Simple) {
   compatibilityTest_->TestOneway_Simple();
 }
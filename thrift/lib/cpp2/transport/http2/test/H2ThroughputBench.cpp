@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/futures/Future.h>
+#include <folly/init/Init.h>
+#include <folly/portability/GFlags.h>
+#include <proxygen/httpserver/HTTPServerOptions.h>
+
+#include <thrift/lib/cpp2/async/RocketClientChannel.h>
+#include <thrift/lib/cpp2/server/ThriftServer.h>
+#include <thrift/lib/cpp2/transport/core/ThriftClient.h>
+#include <thrift/lib/cpp2/transport/core/testutil/gen-cpp2/TestService.h>
+#include <thrift/lib/cpp2/transport/http2/common/HTTP2RoutingHandler.h>
+#include <thrift/lib/cpp2/transport/util/ConnectionManager.h>
+#include <thrift/lib/cpp2/util/ScopedServerInterfaceThread.h>
+
+DEFINE_int32(inflight, 64, "Requests kept in flight by the client");
+DEFINE_int32(blob_size, 64 * 1024, "Size of the echoed blobs");
+
+DECLARE_string(transport);
+
+using namespace apache::thrift;
+using namespace testutil::testservice;
+
+// Round trips over HTTP/2 compared to the header and rocket transports, with
+// the same server, handler and load. Small requests measure the per-stream
+// overhead (header encoding, stream setup); blobs measure bodies split in
+// many frames.
+
+namespace {
+
+class Handler : public TestServiceSvIf {
+ public:
+  int32_t sumTwoNumbers(int32_t x, int32_t y) override {
+    return x + y;
+  }
+
+  void echo(std::string& result, std::unique_ptr<folly::IOBuf> val)
+      override {
+    result = val->moveToFbString().toStdString();
+  }
+};
+
+ScopedServerInterfaceThread& getServer() {
+  static auto server = new ScopedServerInterfaceThread(
+      std::make_shared<ThriftServerAsyncProcessorFactory<Handler>>(
+          std::make_shared<Handler>()),
+      "::1",
+      0,
+      [](ThriftServer& server) {
+        auto h2Options = std::make_unique<proxygen::HTTPServerOptions>();
+        h2Options->threads =
+            static_cast<size_t>(server.getNumIOWorkerThreads());
+        h2Options->idleTimeout = server.getIdleTimeout();
+        server.addRoutingHandler(std::make_unique<HTTP2RoutingHandler>(
+            std::move(h2Options), server.getThriftProcessor(), server));
+      });
+  return *server;
+}
+
+std::unique_ptr<TestServiceAsyncClient> makeHeaderClient() {
+  return getServer().newClient<TestServiceAsyncClient>();
+}
+
+std::unique_ptr<TestServiceAsyncClient> makeRocketClient() {
+  return getServer().newClient<TestServiceAsyncClient>(
+      nullptr, [](auto socket) {
+        return RocketClientChannel::newChannel(std::move(socket));
+      });
+}
+
+std::unique_ptr<TestServiceAsyncClient> makeHTTP2Client() {
+  FLAGS_transport = "http2";
+  auto connection = ConnectionManager::getInstance()->getConnection(
+      "::1", getServer().getPort());
+  auto channel = ThriftClient::Ptr(new ThriftClient(connection));
+  channel->setProtocolId(protocol::T_COMPACT_PROTOCOL);
+  return std::make_unique<TestServiceAsyncClient>(std::move(channel));
+}
+
+template <typename Call>
+void run(size_t iters, TestServiceAsyncClient& client, Call call) {
+  std::vector<folly::SemiFuture<folly::Unit>> inflight;
+  inflight.reserve(FLAGS_inflight);
+  while (iters > 0) {
+    for (; iters > 0 && inflight.size() < size_t(FLAGS_inflight); --iters) {
+      inflight.push_back(call(client));
+    }
+    folly::collectAllSemiFuture(inflight.begin(), inflight.end()).get();
+    inflight.clear();
+  }
+}
+
+void sum(size_t iters, TestServiceAsyncClient& client) {
+  run(iters, client, [](TestServiceAsyncClient& c) {
+    return c.semifuture_sumTwoNumbers(1, 2).unit();
+  });
+}
+
+void echo(size_t iters, TestServiceAsyncClient& client) {
+  auto blob = folly::IOBuf::create(FLAGS_blob_size);
+  blob->append(FLAGS_blob_size);
+  memset(blob->writableData(), 'x', blob->length());
+  run(iters, client, [&](TestServiceAsyncClient& c) {
+    return c.semifuture_echo(*blob).unit();
+  });
+}
+
+template <typename MakeClient, typename Load>
+void benchmark(size_t iters, MakeClient makeClient, Load load) {
+  std::unique_ptr<TestServiceAsyncClient> client;
+  BENCHMARK_SUSPEND {
+    client = makeClient();
+    // Connect before measuring
+    client->semifuture_sumTwoNumbers(1, 2).get();
+  }
+  load(iters, *client);
+  BENCHMARK_SUSPEND {
+    client.reset();
+  }
+}
+
+} // namespace
+
+BENCHMARK(header_sum, iters) {
+  benchmark(iters, makeHeaderClient, sum);
+}
+
+BENCHMARK_RELATIVE(rocket_sum, iters) {
+  benchmark(iters, makeRocketClient, sum);
+}
+
+BENCHMARK_RELATIVE(http2_sum, iters) {
+  benchmark(iters, makeHTTP2Client, sum);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(header_echo, iters) {
+  benchmark(iters, makeHeaderClient, echo);
+}
+
+BENCHMARK_RELATIVE(rocket_echo, iters) {
+  benchmark(iters, makeRocketClient, echo);
+}
+
+BENCHMARK_RELATIVE(http2_echo, iters) {
+  benchmark(iters, makeHTTP2Client, echo);
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  getServer();
+  folly::runBenchmarks();
+  return 0;
+}
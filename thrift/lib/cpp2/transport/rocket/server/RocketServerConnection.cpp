@@ -16,8 +16,12 @@
 
 #include <thrift/lib/cpp2/transport/rocket/server/RocketServerConnection.h>
 
+#include <algorithm>
+#include <limits>
 #include <memory>
+#include <ostream>
 #include <utility>
+#include <vector>
 
 #include <fmt/core.h>
 #include <folly/ExceptionWrapper.h>
@@ -79,8 +83,110 @@ void RocketServerConnection::send(std::unique_ptr<folly::IOBuf> data) {
   }
 
   batchWriteLoopCallback_.enqueueWrite(std::move(data));
-  if (!batchWriteLoopCallback_.isLoopCallbackScheduled()) {
-    evb_.runInLoop(&batchWriteLoopCallback_, true /* thisIteration */);
+  scheduleFlush();
+}
+
+void RocketServerConnection::sendStreamFrame(
+    StreamId streamId,
+    std::unique_ptr<folly::IOBuf> data) {
+  evb_.dcheckIsInEventBaseThread();
+
+  if (state_ != ConnectionState::ALIVE) {
+    return;
+  }
+
+  if (maxWriteBufferBytes_ == 0) {
+    // Without a write buffer limit the queues would be drained whole on the
+    // next flush anyway
+    DCHECK(streamWriteQueues_.empty());
+    send(std::move(data));
+    return;
+  }
+
+  auto& queue = streamWriteQueues_[streamId];
+  if (queue.frames.empty()) {
+    streamWriteOrder_.push_back(streamId);
+  }
+  auto size = data->computeChainDataLength();
+  queue.frames.push_back(std::move(data));
+  queue.bytes += size;
+  streamBufferedBytes_ += size;
+  scheduleFlush();
+}
+
+size_t RocketServerConnection::getStreamBufferedBytes(StreamId streamId) const {
+  auto it = streamWriteQueues_.find(streamId);
+  return it != streamWriteQueues_.end() ? it->second.bytes : 0;
+}
+
+void RocketServerConnection::flushPendingWrites() {
+  DestructorGuard dg(this);
+
+  // Streams whose queue went below maxStreamBufferedBytes_, resumed once the
+  // write is issued since their producers may send more right away
+  std::vector<StreamId> drained;
+  drainStreamWrites(drained);
+
+  if (bufferedWrites_) {
+    ++inflightWrites_;
+    auto writes = std::move(bufferedWrites_);
+    auto size = writes->computeChainDataLength();
+    inflightWriteSizes_.push_back(size);
+    inflightWriteBytes_ += size;
+    socket_->writeChain(this, std::move(writes));
+  }
+
+  for (auto streamId : drained) {
+    if (state_ != ConnectionState::ALIVE) {
+      break;
+    }
+    auto it = streams_.find(streamId);
+    if (it == streams_.end()) {
+      continue;
+    }
+    if (auto* callback =
+            boost::get<std::unique_ptr<RocketStreamClientCallback>>(
+                &it->second)) {
+      // may free the stream
+      (*callback)->resume();
+    }
+  }
+}
+
+void RocketServerConnection::drainStreamWrites(
+    std::vector<StreamId>& drained,
+    bool capped) {
+  size_t budget = std::numeric_limits<size_t>::max();
+  if (capped && maxWriteBufferBytes_ != 0) {
+    budget = maxWriteBufferBytes_ -
+        std::min(inflightWriteBytes_, maxWriteBufferBytes_);
+  }
+
+  while (!streamWriteOrder_.empty() && budget > 0) {
+    auto streamId = streamWriteOrder_.front();
+    streamWriteOrder_.pop_front();
+    auto it = streamWriteQueues_.find(streamId);
+    DCHECK(it != streamWriteQueues_.end());
+    auto& queue = it->second;
+
+    auto frame = std::move(queue.frames.front());
+    queue.frames.pop_front();
+    auto size = frame->computeChainDataLength();
+    if (maxStreamBufferedBytes_ != 0 &&
+        queue.bytes >= maxStreamBufferedBytes_ &&
+        queue.bytes - size < maxStreamBufferedBytes_) {
+      drained.push_back(streamId);
+    }
+    queue.bytes -= size;
+    streamBufferedBytes_ -= size;
+    budget -= std::min(size, budget);
+    batchWriteLoopCallback_.enqueueWrite(std::move(frame));
+
+    if (queue.frames.empty()) {
+      streamWriteQueues_.erase(it);
+    } else {
+      streamWriteOrder_.push_back(streamId);
+    }
   }
 }
 
@@ -88,6 +194,7 @@ RocketServerConnection::~RocketServerConnection() {
   DCHECK(inflightRequests_ == 0);
   DCHECK(inflightWrites_ == 0);
   DCHECK(batchWriteLoopCallback_.empty());
+  DCHECK(streamWriteQueues_.empty());
 }
 
 bool RocketServerConnection::closeIfNeeded() {
@@ -110,7 +217,7 @@ bool RocketServerConnection::closeIfNeeded() {
         it->second,
         [](const std::unique_ptr<RocketStreamClientCallback>& callback) {
           auto& serverCallback = callback->getStreamServerCallback();
-          serverCallback.onStreamCancel();
+          serverCallback.onConnectionClosed();
         },
         [](const std::unique_ptr<RocketSinkClientCallback>& callback) {
           callback->onStreamCancel();
@@ -431,6 +538,11 @@ void RocketServerConnection::close(folly::exception_wrapper ew) {
   DestructorGuard dg(this);
   // Immediately stop processing new requests
   socket_->setReadCB(nullptr);
+  // and write out the stream frames still queued, ahead of the error frame.
+  // No more get queued once closing.
+  std::vector<StreamId> drained;
+  drainStreamWrites(drained, false /* capped */);
+  DCHECK(streamWriteQueues_.empty());
 
   auto rex = ew
       ? RocketException(ErrorCode::CONNECTION_ERROR, ew.what())
@@ -451,7 +563,14 @@ void RocketServerConnection::timeoutExpired() noexcept {
 
 bool RocketServerConnection::isBusy() const {
   return inflightRequests_ != 0 || inflightWrites_ != 0 ||
-      batchWriteLoopCallback_.isLoopCallbackScheduled();
+      batchWriteLoopCallback_.isLoopCallbackScheduled() ||
+      !streamWriteQueues_.empty();
+}
+
+void RocketServerConnection::describe(std::ostream& os) const {
+  os << "streams=" << streams_.size()
+     << " streamBufferedBytes=" << streamBufferedBytes_
+     << " inflightWriteBytes=" << inflightWriteBytes_;
 }
 
 // On graceful shutdown, ConnectionManager will first fire the
@@ -476,6 +595,11 @@ void RocketServerConnection::closeWhenIdle() {
 void RocketServerConnection::writeSuccess() noexcept {
   DCHECK(inflightWrites_ != 0);
   --inflightWrites_;
+  inflightWriteBytes_ -= inflightWriteSizes_.front();
+  inflightWriteSizes_.pop_front();
+  if (!streamWriteOrder_.empty()) {
+    scheduleFlush();
+  }
   closeIfNeeded();
 }
 
@@ -485,6 +609,8 @@ void RocketServerConnection::writeErr(
   DestructorGuard dg(this);
   DCHECK(inflightWrites_ != 0);
   --inflightWrites_;
+  inflightWriteBytes_ -= inflightWriteSizes_.front();
+  inflightWriteSizes_.pop_front();
   close(folly::make_exception_wrapper<std::runtime_error>(fmt::format(
       "Failed to write to remote endpoint. Wrote {} bytes."
       " AsyncSocketException: {}",
@@ -17,10 +17,12 @@
 #pragma once
 
 #include <chrono>
+#include <deque>
 #include <memory>
 #include <ostream>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <boost/variant.hpp>
 
@@ -61,6 +63,11 @@ class RocketServerConnection
 
   void send(std::unique_ptr<folly::IOBuf> data);
 
+  // Queues a frame of a server-to-client stream. Stream frames are written
+  // round-robin across streams, within the write buffer limit. Without that
+  // limit they are sent right away.
+  void sendStreamFrame(StreamId streamId, std::unique_ptr<folly::IOBuf> data);
+
   static RocketStreamClientCallback* createStreamClientCallback(
       RocketServerFrameContext&& context,
       uint32_t initialRequestN);
@@ -115,6 +122,43 @@ class RocketServerConnection
     return minCompressBytes_;
   }
 
+  /**
+   * Once a stream has more than this many bytes queued, the credits the
+   * client grants it are held back from its producer until the queue drains
+   * (0 == no limit). Stream frames are only queued when
+   * setMaxWriteBufferBytes() is also set, so this limit has no effect
+   * without it.
+   */
+  void setMaxStreamBufferedBytes(size_t bytes) {
+    maxStreamBufferedBytes_ = bytes;
+  }
+
+  /**
+   * Stream frames are only handed to the socket while fewer than this many
+   * bytes are being written, the rest waiting in their stream queues
+   * (0 == no limit).
+   */
+  void setMaxWriteBufferBytes(size_t bytes) {
+    maxWriteBufferBytes_ = bytes;
+  }
+
+  size_t getStreamBufferedBytes(StreamId streamId) const;
+
+  // Total of the stream queues
+  size_t getStreamBufferedBytes() const {
+    return streamBufferedBytes_;
+  }
+
+  // Bytes handed to the socket and not written yet
+  size_t getInflightWriteBytes() const {
+    return inflightWriteBytes_;
+  }
+
+  bool isStreamBufferFull(StreamId streamId) const {
+    return maxStreamBufferedBytes_ != 0 &&
+        getStreamBufferedBytes(streamId) >= maxStreamBufferedBytes_;
+  }
+
  private:
   void freeStream(StreamId streamId);
 
@@ -135,8 +179,23 @@ class RocketServerConnection
   // Total number of inflight writes to the underlying transport, i.e., writes
   // for which the writeSuccess()/writeErr() has not yet been called.
   size_t inflightWrites_{0};
+  // Sizes of the inflight writes, in order, and their total
+  std::deque<size_t> inflightWriteSizes_;
+  size_t inflightWriteBytes_{0};
   folly::Optional<CompressionAlgorithm> negotiatedCompressionAlgo_;
   uint32_t minCompressBytes_{0};
+  size_t maxStreamBufferedBytes_{0};
+  size_t maxWriteBufferBytes_{0};
+
+  // Frames of server-to-client streams waiting to be written. Streams with
+  // frames queued take turns in streamWriteOrder_, one frame at a time.
+  struct StreamWriteQueue {
+    std::deque<std::unique_ptr<folly::IOBuf>> frames;
+    size_t bytes{0};
+  };
+  folly::F14FastMap<StreamId, StreamWriteQueue> streamWriteQueues_;
+  std::deque<StreamId> streamWriteOrder_;
+  size_t streamBufferedBytes_{0};
 
   enum class ConnectionState : uint8_t {
     ALIVE,
@@ -185,14 +244,18 @@ class RocketServerConnection
 
   // return true if connection closed
   bool closeIfNeeded();
-  void flushPendingWrites() {
-    ++inflightWrites_;
-    auto writes = std::move(bufferedWrites_);
-    socket_->writeChain(this, std::move(writes));
+  void flushPendingWrites();
+  // Moves stream frames to the write batch, within the write buffer limit if
+  // capped
+  void drainStreamWrites(std::vector<StreamId>& drained, bool capped = true);
+  void scheduleFlush() {
+    if (!batchWriteLoopCallback_.isLoopCallbackScheduled()) {
+      evb_.runInLoop(&batchWriteLoopCallback_, true /* thisIteration */);
+    }
   }
 
   void timeoutExpired() noexcept final;
-  void describe(std::ostream&) const final {}
+  void describe(std::ostream&) const final;
   bool isBusy() const final;
   void notifyPendingShutdown() final;
   void closeWhenIdle() final;
@@ -42,7 +42,9 @@ RocketServerFrameContext::RocketServerFrameContext(
 
 RocketServerFrameContext::RocketServerFrameContext(
     RocketServerFrameContext&& other) noexcept
-    : connection_(other.connection_), streamId_(other.streamId_) {
+    : connection_(other.connection_),
+      streamId_(other.streamId_),
+      streamWrites_(other.streamWrites_) {
   other.connection_ = nullptr;
 }
 
@@ -57,12 +59,19 @@ folly::EventBase& RocketServerFrameContext::getEventBase() const {
   return connection_->getEventBase();
 }
 
+void RocketServerFrameContext::send(std::unique_ptr<folly::IOBuf> buf) {
+  if (streamWrites_) {
+    connection_->sendStreamFrame(streamId_, std::move(buf));
+  } else {
+    connection_->send(std::move(buf));
+  }
+}
+
 void RocketServerFrameContext::sendPayload(Payload&& payload, Flags flags) {
   DCHECK(connection_);
   DCHECK(flags.next() || flags.complete());
 
-  auto buf = PayloadFrame(streamId_, std::move(payload), flags).serialize();
-  connection_->send(std::move(buf));
+  send(PayloadFrame(streamId_, std::move(payload), flags).serialize());
 }
 
 void RocketServerFrameContext::sendError(RocketException&& rex) {
@@ -70,7 +79,7 @@ void RocketServerFrameContext::sendError(RocketException&& rex) {
 
   Serializer writer;
   ErrorFrame(streamId_, std::move(rex)).serialize(writer);
-  connection_->send(std::move(writer).move());
+  send(std::move(writer).move());
 }
 
 void RocketServerFrameContext::sendRequestN(int32_t n) {
@@ -95,9 +104,8 @@ void RocketServerFrameContext::sendExt(
     ExtFrameType extFrameType) {
   DCHECK(connection_);
 
-  auto buf =
-      ExtFrame(streamId_, std::move(payload), flags, extFrameType).serialize();
-  connection_->send(std::move(buf));
+  send(
+      ExtFrame(streamId_, std::move(payload), flags, extFrameType).serialize());
 }
 
 void RocketServerFrameContext::onFullFrame(
@@ -164,6 +172,7 @@ void RocketServerFrameContext::scheduleSinkTimeout(
 
 bool RocketServerFrameContext::takeOwnership(
     RocketStreamClientCallback* callback) {
+  streamWrites_ = true;
   connection_->streams_.emplace(
       streamId_, std::unique_ptr<RocketStreamClientCallback>(callback));
   // Client may have disconnected before onFirstResponse; in some cases, we need
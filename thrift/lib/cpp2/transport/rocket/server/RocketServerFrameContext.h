@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include <boost/variant.hpp>
 #include <folly/io/async/HHWheelTimer.h>
 
@@ -85,6 +87,11 @@ class RocketServerFrameContext {
 
   RocketServerConnection* connection_{nullptr};
   const StreamId streamId_;
+  // Set once a server-to-client stream owns the context: its frames then go
+  // through the connection's stream write queues.
+  bool streamWrites_{false};
+
+  void send(std::unique_ptr<folly::IOBuf> buf);
 
   void onFullFrame(RequestResponseFrame&& fullFrame) &&;
   void onFullFrame(RequestFnfFrame&& fullFrame) &&;
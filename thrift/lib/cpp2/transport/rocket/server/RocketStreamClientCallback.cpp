@@ -151,9 +151,20 @@ void RocketStreamClientCallback::request(uint32_t tokens) {
 
   cancelTimeout();
   tokens_ += tokens;
+  if (pausedTokens_ != 0 ||
+      context_.connection().isStreamBufferFull(context_.streamId())) {
+    pausedTokens_ += tokens;
+    return;
+  }
   serverCallback_->onStreamRequestN(tokens);
 }
 
+void RocketStreamClientCallback::resume() {
+  if (auto tokens = std::exchange(pausedTokens_, 0)) {
+    serverCallback_->onStreamRequestN(tokens);
+  }
+}
+
 void RocketStreamClientCallback::headers(HeadersPayload&& payload) {
   serverCallback_->onSinkHeaders(std::move(payload));
 }
@@ -51,6 +51,8 @@ class RocketStreamClientCallback final : public StreamClientCallback {
   void resetServerCallback(StreamServerCallback&) override;
 
   void request(uint32_t n);
+  // Passes on the credits held back while the stream's write queue was full
+  void resume();
   void headers(HeadersPayload&& payload);
 
   StreamServerCallback& getStreamServerCallback();
@@ -61,6 +63,8 @@ class RocketStreamClientCallback final : public StreamClientCallback {
   RocketServerFrameContext context_;
   StreamServerCallback* serverCallback_{nullptr};
   uint64_t tokens_{0};
+  // granted by the client but not passed to the producer yet
+  uint64_t pausedTokens_{0};
   std::unique_ptr<folly::HHWheelTimer::Callback> timeoutCallback_;
   protocol::PROTOCOL_TYPES protoId_;
 
@@ -16,16 +16,24 @@
 
 #include <thrift/lib/cpp2/transport/rocket/server/RocketThriftRequests.h>
 
+#include <algorithm>
 #include <functional>
+#include <limits>
+#include <map>
 #include <memory>
+#include <string>
+#include <tuple>
 #include <utility>
 
+#include <folly/Conv.h>
 #include <folly/ExceptionWrapper.h>
 #include <folly/Function.h>
 #include <folly/compression/Compression.h>
 #include <folly/io/IOBuf.h>
 #include <folly/io/IOBufQueue.h>
 
+#include <thrift/lib/cpp/TApplicationException.h>
+#include <thrift/lib/cpp2/async/ResumableStream.h>
 #include <thrift/lib/cpp2/async/SemiStream.h>
 #include <thrift/lib/cpp2/async/StreamCallbacks.h>
 #ifdef FOLLY_HAS_COROUTINES
@@ -154,12 +162,14 @@ ThriftServerRequestStream::ThriftServerRequestStream(
     ActiveRequestsRegistry& reqRegistry,
     std::unique_ptr<folly::IOBuf> debugPayload,
     RocketStreamClientCallback* clientCallback,
-    std::shared_ptr<AsyncProcessor> cpp2Processor)
+    std::shared_ptr<AsyncProcessor> cpp2Processor,
+    ResumableStreamRegistry* resumableStreams)
     : ThriftRequestCore(serverConfigs, std::move(metadata), *connContext),
       evb_(evb),
       clientCallback_(clientCallback),
       connContext_(std::move(connContext)),
       cpp2Processor_(std::move(cpp2Processor)),
+      resumableStreams_(resumableStreams),
       debugStub_(
           reqRegistry,
           *this,
@@ -168,6 +178,35 @@ ThriftServerRequestStream::ThriftServerRequestStream(
   scheduleTimeouts();
 }
 
+bool ThriftServerRequestStream::resumeStream() {
+  auto* header = getRequestContext()->getHeader();
+  auto token = header->getReadHeader(kStreamResumeTokenHeader);
+  if (!resumableStreams_ || !token) {
+    return false;
+  }
+
+  // Resumes are answered inline, so they count as processed from here on
+  setStartedProcessing();
+  StreamServerCallback* stream = nullptr;
+  if (auto seq = header->getReadHeader(kStreamResumeSeqHeader)) {
+    if (auto received = folly::tryTo<uint64_t>(*seq)) {
+      stream =
+          resumableStreams_->resume(*token, *received, *clientCallback_, evb_);
+    }
+  }
+  if (stream) {
+    // Tells the client the stream was resumed rather than started again
+    header->setHeader(kStreamResumeTokenHeader.str(), token->str());
+    sendStreamReply(folly::IOBuf::create(0), stream, folly::none);
+  } else {
+    sendErrorWrapped(
+        folly::make_exception_wrapper<TApplicationException>(
+            "Stream can't be resumed"),
+        kStreamResumeErrorCode);
+  }
+  return true;
+}
+
 void ThriftServerRequestStream::sendThriftResponse(
     ResponseRpcMetadata&&,
     std::unique_ptr<folly::IOBuf>) noexcept {
@@ -202,6 +241,19 @@ void ThriftServerRequestStream::sendStreamThriftResponse(
     sendStreamThriftError(std::move(metadata), std::move(data));
     return;
   }
+  auto* header = getRequestContext()->getHeader();
+  if (resumableStreams_ && header->getReadHeader(kStreamResumableHeader) &&
+      !header->getReadHeader(kStreamResumeTokenHeader)) {
+    std::string token;
+    std::tie(stream, token) =
+        resumableStreams_->add(*stream, *clientCallback_, evb_);
+    std::map<std::string, std::string> otherMetadata;
+    if (auto md = metadata.otherMetadata_ref()) {
+      otherMetadata = std::move(*md);
+    }
+    otherMetadata[kStreamResumeTokenHeader.str()] = std::move(token);
+    metadata.otherMetadata_ref() = std::move(otherMetadata);
+  }
   stream->resetClientCallback(*clientCallback_);
   clientCallback_->setProtoId(getProtoId());
   clientCallback_->onFirstResponse(
@@ -341,6 +393,10 @@ void ThriftServerRequestSink::sendSinkThriftResponse(
     auto* executor = sinkConsumer.executor.get();
     clientCallback_->setProtoId(getProtoId());
     clientCallback_->setChunkTimeout(sinkConsumer.chunkTimeout);
+    if (sinkConsumer.batchBytes > 0) {
+      metadata.sinkBatchBytes_ref() = static_cast<int32_t>(std::min<uint64_t>(
+          sinkConsumer.batchBytes, std::numeric_limits<int32_t>::max()));
+    }
     auto serverCallback = apache::thrift::detail::ServerSinkBridge::create(
         std::move(sinkConsumer), *getEventBase(), clientCallback_);
     clientCallback_->onFirstResponse(
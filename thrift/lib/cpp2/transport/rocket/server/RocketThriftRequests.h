@@ -35,6 +35,7 @@ namespace apache {
 namespace thrift {
 
 class AsyncProcessor;
+class ResumableStreamRegistry;
 class RocketSinkClientCallback;
 class RocketStreamClientCallback;
 
@@ -131,7 +132,12 @@ class ThriftServerRequestStream final : public ThriftRequestCore {
       ActiveRequestsRegistry& reqRegistry,
       std::unique_ptr<folly::IOBuf> debugPayload,
       RocketStreamClientCallback* clientCallback,
-      std::shared_ptr<AsyncProcessor> cpp2Processor);
+      std::shared_ptr<AsyncProcessor> cpp2Processor,
+      ResumableStreamRegistry* resumableStreams);
+
+  // Returns whether the request resumes a stream, which it then replies to.
+  // The handler isn't called for those.
+  bool resumeStream();
 
   void sendThriftResponse(
       ResponseRpcMetadata&&,
@@ -178,6 +184,8 @@ class ThriftServerRequestStream final : public ThriftRequestCore {
   // reference.
   const std::shared_ptr<Cpp2ConnContext> connContext_;
   const std::shared_ptr<AsyncProcessor> cpp2Processor_;
+  // Null unless the server resumes streams
+  ResumableStreamRegistry* const resumableStreams_;
 
   // keep last
   ActiveRequestsRegistry::DebugStub debugStub_;
@@ -67,6 +67,15 @@ bool deserializeMetadata(const Payload& p, RequestRpcMetadata& metadata) {
 bool isMetadataValid(const RequestRpcMetadata& metadata) {
   return metadata.protocol_ref() && metadata.name_ref() && metadata.kind_ref();
 }
+
+// Requests resuming a stream get their reply right away, from the stream
+bool resumeStream(ThriftRequestCore&) {
+  return false;
+}
+
+bool resumeStream(ThriftServerRequestStream& request) {
+  return request.resumeStream();
+}
 } // namespace
 
 ThriftRocketServerHandler::ThriftRocketServerHandler(
@@ -186,7 +195,8 @@ void ThriftRocketServerHandler::handleRequestStreamFrame(
         *worker_->getRequestsRegistry(),
         std::move(debugPayload),
         clientCallback,
-        cpp2Processor_);
+        cpp2Processor_,
+        worker_->getServer()->getResumableStreams().get());
   };
 
   handleRequestCommon(std::move(frame.payload()), std::move(makeRequestStream));
@@ -259,6 +269,21 @@ void ThriftRocketServerHandler::handleRequestCommon(
   }
 
   auto request = makeRequest(std::move(metadata), std::move(debugPayload));
+  if (UNLIKELY(!request->admit())) {
+    handleRequestRejectedByAdmissionControl(std::move(request));
+    return;
+  }
+
+  auto* methodStats = serverConfigs_.getMethodStats();
+  if (methodStats || worker_->isSlowRequestsLogEnabled()) {
+    request->enableTimings(data->computeChainDataLength());
+    request->setMethodStats(methodStats);
+  }
+
+  if (resumeStream(*request)) {
+    return;
+  }
+
   const auto protocolId = request->getProtoId();
   auto* const cpp2ReqCtx = request->getRequestContext();
   cpp2Processor_->process(
@@ -298,6 +323,18 @@ void ThriftRocketServerHandler::handleRequestOverloadedServer(
       serverConfigs_.getOverloadedErrorCode());
 }
 
+void ThriftRocketServerHandler::handleRequestRejectedByAdmissionControl(
+    std::unique_ptr<ThriftRequestCore> request) {
+  if (auto* observer = serverConfigs_.getObserver()) {
+    observer->serverOverloaded();
+  }
+  request->sendErrorWrapped(
+      folly::make_exception_wrapper<TApplicationException>(
+          TApplicationException::LOADSHEDDING,
+          "adaptive loadshedding rejection"),
+      serverConfigs_.getOverloadedErrorCode());
+}
+
 void ThriftRocketServerHandler::handleServerShutdown(
     std::unique_ptr<ThriftRequestCore> request) {
   request->sendErrorWrapped(
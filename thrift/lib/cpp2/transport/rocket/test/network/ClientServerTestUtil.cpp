@@ -572,6 +572,8 @@ class RocketTestServerAcceptor final : public wangle::Acceptor {
       const wangle::TransportInfo&) override {
     auto* connection = new RocketServerConnection(
         std::move(socket), frameHandler_, std::chrono::milliseconds::zero());
+    connection->setMaxStreamBufferedBytes(maxStreamBytes_);
+    connection->setMaxWriteBufferBytes(maxWriteBytes_);
     getConnectionManager()->addConnection(connection);
   }
 
@@ -597,11 +599,18 @@ class RocketTestServerAcceptor final : public wangle::Acceptor {
     expectedRemainingStreams_ = size;
   }
 
+  void setWriteBufferLimits(size_t maxStreamBytes, size_t maxWriteBytes) {
+    maxStreamBytes_ = maxStreamBytes;
+    maxWriteBytes_ = maxWriteBytes;
+  }
+
  private:
   const std::shared_ptr<RocketServerHandler> frameHandler_;
   std::promise<void> shutdownPromise_;
   size_t connections_{0};
   folly::Optional<size_t> expectedRemainingStreams_ = folly::none;
+  size_t maxStreamBytes_{0};
+  size_t maxWriteBytes_{0};
 };
 } // namespace
 
@@ -834,6 +843,15 @@ void RocketTestServer::setExpectedRemainingStreams(size_t n) {
   }
 }
 
+void RocketTestServer::setWriteBufferLimits(
+    size_t maxStreamBytes,
+    size_t maxWriteBytes) {
+  if (auto acceptor =
+          dynamic_cast<RocketTestServerAcceptor*>(acceptor_.get())) {
+    acceptor->setWriteBufferLimits(maxStreamBytes, maxWriteBytes);
+  }
+}
+
 void RocketTestServer::setExpectedSetupMetadata(
     MetadataOpaqueMap<std::string, std::string> md) {
   handler_->setExpectedSetupMetadata(std::move(md));
@@ -129,6 +129,8 @@ class RocketTestServer {
 
   uint16_t getListeningPort() const;
   void setExpectedRemainingStreams(size_t n);
+  // Applies to connections accepted afterwards
+  void setWriteBufferLimits(size_t maxStreamBytes, size_t maxWriteBytes);
 
   void setExpectedSetupMetadata(MetadataOpaqueMap<std::string, std::string> md);
 
@@ -14,17 +14,20 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <folly/portability/GTest.h>
 
 #include <folly/Conv.h>
 #include <folly/ExceptionWrapper.h>
 #include <folly/Format.h>
+#include <folly/Optional.h>
 #include <folly/Range.h>
 #include <folly/SocketAddress.h>
 #include <folly/Try.h>
@@ -33,6 +36,7 @@
 #include <folly/experimental/coro/BlockingWait.h>
 #include <folly/experimental/coro/Task.h>
 #include <folly/fibers/FiberManager.h>
+#include <folly/futures/Future.h>
 #include <folly/io/IOBuf.h>
 #include <folly/io/async/AsyncSocket.h>
 #include <folly/io/async/EventBase.h>
@@ -422,6 +426,54 @@ TYPED_TEST(RocketNetworkTest, RequestStreamSmallInitialRequestN) {
   });
 }
 
+TEST(RocketServerConnectionTest, RequestStreamsWithWriteBufferLimits) {
+  // Small limits so that streams keep getting paused and resumed
+  RocketTestServer server;
+  server.setWriteBufferLimits(64, 256);
+  RocketTestClient client(
+      folly::SocketAddress("::1", server.getListeningPort()));
+  folly::ManualExecutor executor;
+
+  constexpr size_t kNumStreams = 4;
+  constexpr size_t kNumRequestedPayloads = 1000;
+  constexpr folly::StringPiece kMetadata("metadata");
+  const auto data = folly::to<std::string>("generate:", kNumRequestedPayloads);
+
+  std::vector<size_t> received(kNumStreams);
+  // Fewest payloads any stream had received when the first one completed
+  folly::Optional<size_t> fewestAtFirstCompletion;
+  std::vector<folly::Future<folly::Unit>> done;
+  for (size_t i = 0; i < kNumStreams; ++i) {
+    auto stream = client.sendRequestStreamSync(
+        Payload::makeFromMetadataAndData(kMetadata, folly::StringPiece{data}));
+    ASSERT_TRUE(stream.hasValue());
+    done.push_back(
+        std::move(*stream)
+            .via(&executor)
+            .subscribe(
+                [&received, &fewestAtFirstCompletion, i](Payload&& payload) {
+                  auto dam = splitMetadataAndData(payload);
+                  const auto x = folly::to<size_t>(getRange(*dam.second));
+                  EXPECT_EQ(++received[i], x);
+                  if (x == kNumRequestedPayloads && !fewestAtFirstCompletion) {
+                    fewestAtFirstCompletion =
+                        *std::min_element(received.begin(), received.end());
+                  }
+                },
+                [](auto ew) { FAIL() << ew.what(); },
+                8 /* batch size */)
+            .futureJoin());
+  }
+
+  folly::collectAll(done).waitVia(&executor);
+  for (auto n : received) {
+    EXPECT_EQ(kNumRequestedPayloads, n);
+  }
+  // The streams were written in turns, none got far ahead of the others
+  ASSERT_TRUE(fewestAtFirstCompletion.has_value());
+  EXPECT_GE(*fewestAtFirstCompletion, kNumRequestedPayloads / 2);
+}
+
 TYPED_TEST(RocketNetworkTest, RequestStreamCancelSubscription) {
   this->withClient([this](RocketTestClient& client) {
     // Open an essentially infinite stream and ensure stream is able to be
@@ -106,6 +106,10 @@ void RSRoutingHandler::handleConnection(
     // set minCompressBytes
     static_cast<rocket::RocketServerConnection*>(connection)
         ->setMinCompressBytes(server->getMinCompressBytes());
+    static_cast<rocket::RocketServerConnection*>(connection)
+        ->setMaxStreamBufferedBytes(server->getMaxStreamBufferedBytes());
+    static_cast<rocket::RocketServerConnection*>(connection)
+        ->setMaxWriteBufferBytes(server->getMaxWriteBufferBytes());
   } else {
     connection = new ManagedRSocketConnection(
         std::move(sock),
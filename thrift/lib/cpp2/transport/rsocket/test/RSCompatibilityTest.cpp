@@ -259,6 +259,10 @@ TEST_P(RSCompatibilityTest, ConnectionContext) {
   compatibilityTest_->TestConnectionContext();
 }
 
+TEST_P(RSCompatibilityTest, ConnectionContextSharedByRequests) {
+  compatibilityTest_->TestConnectionContextSharedByRequests();
+}
+
 TEST_P(RSCompatibilityTest, ClientIdentityHook) {
   compatibilityTest_->TestClientIdentityHook();
 }
@@ -27,6 +27,7 @@
 #include <folly/io/async/ScopedEventBaseThread.h>
 
 #include <thrift/lib/cpp2/async/ClientStreamBridge.h>
+#include <thrift/lib/cpp2/async/ReconnectingRequestChannel.h>
 #include <thrift/lib/cpp2/async/RocketClientChannel.h>
 #include <thrift/lib/cpp2/transport/core/testutil/TAsyncSocketIntercepted.h>
 #include <thrift/lib/cpp2/transport/rsocket/test/util/TestServiceMock.h>
@@ -57,6 +58,26 @@ void waitNoLeak(StreamServiceAsyncClient* client) {
   } while (std::chrono::steady_clock::now() < deadline);
   FAIL() << "waitNoLeak failed";
 }
+
+// Client asking for resumable streams. Runs on evb, 'socket' is the socket of
+// the current connection.
+std::unique_ptr<StreamServiceBufferedAsyncClient> makeResumingClient(
+    folly::EventBase& evb,
+    uint16_t port,
+    TAsyncSocket*& socket,
+    int& connections) {
+  auto channel = ReconnectingRequestChannel::newChannel(
+      evb, [port, &socket, &connections](folly::EventBase& eb) {
+        ++connections;
+        TAsyncSocket::UniquePtr sock(new TAsyncSocket(&eb, "::1", port));
+        socket = sock.get();
+        return ReconnectingRequestChannel::ImplPtr(
+            RocketClientChannel::newChannel(std::move(sock)));
+      });
+  channel->setStreamResumption(true);
+  return std::make_unique<StreamServiceBufferedAsyncClient>(
+      std::move(channel));
+}
 } // namespace
 
 struct StreamingTestParameters {
@@ -135,6 +156,17 @@ class BlockStreamingTest : public StreamingTest {
   }
 };
 
+class ResumableStreamingTest : public StreamingTest {
+ protected:
+  void SetUp() override {
+    // Resumption has to be configured before the server starts serving
+    configureServer_ = [](ThriftServer& server) {
+      server.setStreamResumption(1 << 20, std::chrono::seconds(10));
+    };
+    StreamingTest::SetUp();
+  }
+};
+
 TEST_P(StreamingTest, ClientStreamBridge) {
   connectToServer([this](std::unique_ptr<StreamServiceAsyncClient> client) {
     auto channel = client->getChannel();
@@ -1051,6 +1083,73 @@ TEST_P(StreamingTest, DetachAndAttachEventBase) {
       .waitVia(&mainEventBase);
 }
 
+TEST_P(ResumableStreamingTest, ResumeStreamAfterConnectionLoss) {
+  folly::ScopedEventBaseThread clientThread;
+  auto* const evb = clientThread.getEventBase();
+  TAsyncSocket* socket = nullptr;
+  int connections = 0;
+  std::unique_ptr<StreamServiceBufferedAsyncClient> client;
+  evb->runInEventBaseThreadAndWait(
+      [&] { client = makeResumingClient(*evb, port_, socket, connections); });
+
+  RpcOptions rpcOptions;
+  rpcOptions.setChunkBufferSize(10);
+  auto stream = folly::via(evb, [&] {
+                  return client->semifuture_range(rpcOptions, 0, 1000);
+                }).get();
+
+  // Kill the connection mid-stream, the client should see neither a gap nor
+  // a duplicate
+  int32_t expected = 0;
+  std::move(stream).subscribeInline([&](folly::Try<int32_t>&& next) {
+    if (next.hasException()) {
+      ADD_FAILURE() << "Unexpected error: " << next.exception().what();
+    } else if (next.hasValue()) {
+      EXPECT_EQ(expected++, *next);
+      if (expected == 100) {
+        evb->runInEventBaseThread([&] { socket->closeNow(); });
+      }
+    }
+  });
+  EXPECT_EQ(1000, expected);
+  EXPECT_EQ(2, connections);
+  EXPECT_EQ(0, server_->getResumableStreams()->size());
+
+  evb->runInEventBaseThreadAndWait([&] { client.reset(); });
+}
+
+TEST_P(StreamingTest, StreamNotResumedWithoutServerSupport) {
+  folly::ScopedEventBaseThread clientThread;
+  auto* const evb = clientThread.getEventBase();
+  TAsyncSocket* socket = nullptr;
+  int connections = 0;
+  std::unique_ptr<StreamServiceBufferedAsyncClient> client;
+  evb->runInEventBaseThreadAndWait(
+      [&] { client = makeResumingClient(*evb, port_, socket, connections); });
+
+  RpcOptions rpcOptions;
+  rpcOptions.setChunkBufferSize(10);
+  auto stream = folly::via(evb, [&] {
+                  return client->semifuture_range(rpcOptions, 0, 1000);
+                }).get();
+
+  int32_t received = 0;
+  bool failed = false;
+  std::move(stream).subscribeInline([&](folly::Try<int32_t>&& next) {
+    if (next.hasException()) {
+      EXPECT_TRUE(next.exception().is_compatible_with<TTransportException>());
+      failed = true;
+    } else if (next.hasValue() && ++received == 100) {
+      evb->runInEventBaseThread([&] { socket->closeNow(); });
+    }
+  });
+  EXPECT_TRUE(failed);
+  EXPECT_LT(received, 1000);
+  EXPECT_EQ(1, connections);
+
+  evb->runInEventBaseThreadAndWait([&] { client.reset(); });
+}
+
 TEST_P(StreamingTest, ServerCompletesFirstResponseAfterClientDisconnects) {
   folly::EventBase evb;
 
@@ -1100,5 +1199,10 @@ INSTANTIATE_TEST_CASE_P(
         StreamingTestParameters{false},
         StreamingTestParameters{true}));
 
+INSTANTIATE_TEST_CASE_P(
+    ResumableStreamingTests,
+    ResumableStreamingTest,
+    testing::Values(StreamingTestParameters{true}));
+
 } // namespace thrift
 } // namespace apache
@@ -47,6 +47,9 @@ std::unique_ptr<ThriftServer> TestSetup::createServer(
 
   auto eventHandler = std::make_shared<TestEventHandler>();
   server->setServerEventHandler(eventHandler);
+  if (configureServer_) {
+    configureServer_(*server);
+  }
   server->setup();
 
   // Get the port that the server has bound to
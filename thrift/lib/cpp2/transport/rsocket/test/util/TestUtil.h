@@ -17,6 +17,7 @@
 #include <folly/portability/GFlags.h>
 #include <folly/portability/GMock.h>
 
+#include <folly/Function.h>
 #include <folly/io/async/ScopedEventBaseThread.h>
 #include <thrift/lib/cpp/async/TAsyncSocket.h>
 #include <thrift/lib/cpp2/async/PooledRequestChannel.h>
@@ -83,6 +84,8 @@ class TestSetup : public testing::Test {
 
   int numIOThreads_{10};
   int numWorkerThreads_{10};
+  // Applied by createServer() before the server starts
+  folly::Function<void(ThriftServer&)> configureServer_;
 
   folly::ScopedEventBaseThread evbThread_;
   folly::ScopedEventBaseThread executor_;
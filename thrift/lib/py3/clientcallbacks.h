@@ -42,7 +42,7 @@ class FutureCallback : public apache::thrift::FutureCallbackBase<Result> {
 
   void replyReceived(apache::thrift::ClientReceiveState&& state) override {
     SCOPE_EXIT {
-      if (state.header() && !state.header()->getHeaders().empty()) {
+      if (state.header() && !state.header()->readHeadersEmpty()) {
         options_.setReadHeaders(state.header()->releaseHeaders());
       }
     };
@@ -87,7 +87,7 @@ class FutureCallback<folly::Unit>
 
   void replyReceived(apache::thrift::ClientReceiveState&& state) override {
     SCOPE_EXIT {
-      if (state.header() && !state.header()->getHeaders().empty()) {
+      if (state.header() && !state.header()->readHeadersEmpty()) {
         options_.setReadHeaders(state.header()->releaseHeaders());
       }
     };
@@ -117,6 +117,11 @@ struct RequestRpcMetadata {
   13: optional string loadMetric;
   // The CompressionAlgorithm used to compress requests (if any)
   14: optional CompressionAlgorithm compression;
+  // Absolute time (milliseconds since the Unix epoch) after which the
+  // originator of the call graph this request belongs to won't wait for the
+  // response anymore. Set by the client when the call is made on behalf of a
+  // server request which carried a deadline. Used only by the server.
+  15: optional i64 deadlineMs;
 }
 
 // RPC metadata sent from the server to the client.  The lifetime of
@@ -144,11 +149,18 @@ struct ResponseRpcMetadata {
   5: optional i32 (cpp.type = "std::uint32_t") crc32c;
   // The CompressionAlgorithm used to compress responses (if any)
   6: optional CompressionAlgorithm compression;
+  // Set in the first response of a sink whose consumer accepts coalesced
+  // payloads: the client may then pack several items into one payload of up
+  // to this many bytes.
+  7: optional i32 sinkBatchBytes;
 }
 
 struct StreamPayloadMetadata {
   // The CompressionAlgorithm used to compress responses (if any)
   1: optional CompressionAlgorithm compression;
+  // Sizes of the sink items coalesced in the payload, in order. Unset for a
+  // payload holding a single item.
+  2: optional list<i32> itemSizes;
 }
 
 // Setup metadata sent from the client to the server at the time
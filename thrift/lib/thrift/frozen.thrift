@@ -35,6 +35,10 @@ struct Layout {
 const i32 kCurrentFrozenFileVersion = 1;
 
 struct Schema {
+  // Hash of the schema serialized with a zero fingerprint. Declared first so
+  // it is serialized first and readers can look up a cached layout without
+  // decoding the rest of the schema. Zero in files written before it existed.
+  5: i64 fingerprint = 0;
   // File format version, incremented on breaking changes to Frozen2
   // implementation.  Only backwards-compatibility is guaranteed.
   4: i32 fileVersion = 0;
@@ -47,9 +47,11 @@ DEFINE_int32(timeout_weight, 0, "Test for timeout functionality");
 DEFINE_int32(download_weight, 0, "Test for download functionality");
 DEFINE_int32(upload_weight, 0, "Test for upload functionality");
 DEFINE_int32(stream_weight, 0, "Test stream download functionality");
+DEFINE_int32(sink_upload_weight, 0, "Test sink upload functionality");
 
 DEFINE_uint32(chunk_size, 1024, "Number of bytes per chunk");
 DEFINE_uint32(batch_size, 16, "Flow control batch size");
+DEFINE_uint32(sink_records, 10000, "Number of records per sink upload");
 
 /*
  * This starts num_clients threads with a unique client in each thread.
@@ -85,7 +87,8 @@ int main(int argc, char** argv) {
                                           FLAGS_timeout_weight,
                                           FLAGS_download_weight,
                                           FLAGS_upload_weight,
-                                          FLAGS_stream_weight};
+                                          FLAGS_stream_weight,
+                                          FLAGS_sink_upload_weight};
       int32_t sum = std::accumulate(weights.begin(), weights.end(), 0);
       if (sum == 0) {
         weights[0] = 1;
@@ -27,4 +27,7 @@ service StreamBenchmark extends Api.Benchmark {
   void upload(1: ApiBase.Chunk2 chunk);
 
   stream<ApiBase.Chunk2> streamDownload();
+
+  // Each sink item is one record, the final response is the number received
+  sink<ApiBase.Chunk2, i64> sinkUpload();
 }
@@ -18,12 +18,22 @@
 
 #include <folly/system/ThreadName.h>
 #include <rsocket/internal/ScheduledSubscriber.h>
+#include <thrift/lib/cpp2/async/Sink.h>
 #include <thrift/lib/cpp2/transport/rsocket/YarplStreamImpl.h>
 #include <thrift/perf/cpp2/if/gen-cpp2/StreamBenchmark.h>
 #include <thrift/perf/cpp2/util/QPSStats.h>
 
 DEFINE_uint32(chunk_size, 1024, "Number of bytes per chunk");
 DEFINE_uint32(batch_size, 16, "Flow control batch size");
+DEFINE_uint32(sink_buffer_size, 100, "Sink credits granted up front");
+DEFINE_uint32(
+    sink_batch_bytes,
+    0,
+    "Coalesce sink records into payloads of this many bytes (0: off)");
+DEFINE_uint32(
+    sink_buffer_bytes,
+    0,
+    "Size sink credit grants to keep this many bytes in flight (0: off)");
 
 namespace facebook {
 namespace thrift {
@@ -45,6 +55,8 @@ class BenchmarkHandler : virtual public StreamBenchmarkSvIf {
     stats->registerCounter(kUpload_);
     stats_->registerCounter(ks_Download_);
     stats_->registerCounter(ks_Upload_);
+    stats_->registerCounter(ks_SinkRecords_);
+    stats_->registerCounter(ks_SinkBytes_);
 
     chunk_.data.unshare();
     chunk_.data.reserve(0, FLAGS_chunk_size);
@@ -142,6 +154,25 @@ class BenchmarkHandler : virtual public StreamBenchmarkSvIf {
         folly::EventBaseManager::get()->getEventBase());
   }
 
+#ifdef FOLLY_HAS_COROUTINES
+  apache::thrift::SinkConsumer<Chunk2, int64_t> sinkUpload() override {
+    return apache::thrift::SinkConsumer<Chunk2, int64_t>{
+        [this](folly::coro::AsyncGenerator<Chunk2&&> gen)
+            -> folly::coro::Task<int64_t> {
+          int64_t records = 0;
+          while (auto chunk = co_await gen.next()) {
+            ++records;
+            stats_->add(ks_SinkRecords_);
+            stats_->add(ks_SinkBytes_, chunk->data.computeChainDataLength());
+          }
+          co_return records;
+        },
+        FLAGS_sink_buffer_size}
+        .setBatchBytes(FLAGS_sink_batch_bytes)
+        .setBufferBytes(FLAGS_sink_buffer_bytes);
+  }
+#endif
+
  private:
   QPSStats* stats_;
   std::string kNoop_ = "noop";
@@ -151,6 +182,8 @@ class BenchmarkHandler : virtual public StreamBenchmarkSvIf {
   std::string kUpload_ = "upload";
   std::string ks_Download_ = "s_download";
   std::string ks_Upload_ = "s_upload";
+  std::string ks_SinkRecords_ = "s_sink_records";
+  std::string ks_SinkBytes_ = "s_sink_bytes";
   Chunk2 chunk_;
 };
 
@@ -30,7 +30,7 @@ class Counter {
   explicit Counter(std::string name)
       : name_(name), value_(0, 10000), lastQueryCount_(0), maxPerSec_(0) {}
 
-  Counter& operator+=(uint32_t inc) {
+  Counter& operator+=(uint64_t inc) {
     value_ += inc;
     return *this;
   }
@@ -55,7 +55,7 @@ class Counter {
 
  private:
   std::string name_;
-  folly::ThreadCachedInt<uint32_t> value_;
+  folly::ThreadCachedInt<uint64_t> value_;
   double lastQueryCount_;
   double maxPerSec_;
 };
@@ -24,6 +24,7 @@
 #endif
 
 DECLARE_uint32(chunk_size);
+DECLARE_uint32(sink_records);
 
 using apache::thrift::ClientReceiveState;
 using apache::thrift::RequestCallback;
@@ -40,6 +41,7 @@ enum OP_TYPE {
   DOWNLOAD = 4,
   UPLOAD = 5,
   STREAM = 6,
+  SINK_UPLOAD = 7,
 };
 
 template <typename AsyncClient>
@@ -56,7 +58,11 @@ class Operation {
         upload_(std::make_unique<Upload<AsyncClient>>(stats, FLAGS_chunk_size)),
         stream_(std::make_unique<StreamDownload<AsyncClient>>(
             stats,
-            FLAGS_chunk_size))
+            FLAGS_chunk_size)),
+        sink_(std::make_unique<SinkUpload<AsyncClient>>(
+            stats,
+            FLAGS_chunk_size,
+            FLAGS_sink_records))
 #endif
   {
   }
@@ -92,6 +98,9 @@ class Operation {
       case STREAM:
         stream_->async(client_.get(), std::move(cb), outstanding_ops_);
         break;
+      case SINK_UPLOAD:
+        sink_->async(client_.get(), std::move(cb), outstanding_ops_);
+        break;
 #endif
       default:
         break;
@@ -175,6 +184,7 @@ class Operation {
   std::unique_ptr<Download<AsyncClient>> download_;
   std::unique_ptr<Upload<AsyncClient>> upload_;
   std::unique_ptr<StreamDownload<AsyncClient>> stream_;
+  std::unique_ptr<SinkUpload<AsyncClient>> sink_;
 #endif
 
   int32_t outstanding_ops_{0};
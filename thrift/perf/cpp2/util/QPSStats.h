@@ -52,7 +52,7 @@ class QPSStats {
     ++(*counters_[name]);
   }
 
-  void add(std::string& name, uint32_t sz) {
+  void add(std::string& name, uint64_t sz) {
     (*counters_[name]) += sz;
   }
 
@@ -19,6 +19,7 @@
 #include <folly/GLog.h>
 #include <folly/system/ThreadName.h>
 #include <thrift/lib/cpp2/async/RequestChannel.h>
+#include <thrift/lib/cpp2/async/Sink.h>
 #include <thrift/lib/cpp2/transport/rsocket/YarplStreamImpl.h>
 #include <thrift/perf/cpp2/if/gen-cpp2/ApiBase_types.h>
 #include <thrift/perf/cpp2/util/QPSStats.h>
@@ -233,3 +234,78 @@ class StreamDownload {
   std::string fatal_ = "fatal";
   Chunk2 chunk_;
 };
+
+template <typename AsyncClient>
+class SinkUpload {
+ public:
+  SinkUpload(QPSStats* stats, uint32_t chunkSize, uint32_t records)
+      : stats_(stats), records_per_sink_(records) {
+    stats_->registerCounter(records_);
+    stats_->registerCounter(bytes_);
+    stats_->registerCounter(fatal_);
+    chunk_.data.unshare();
+    chunk_.data.reserve(0, chunkSize);
+    auto buffer = chunk_.data.writableData();
+    // Make it real data to eliminate network optimizations on sending all 0's.
+    srand(time(nullptr));
+    for (uint32_t i = 0; i < chunkSize; ++i) {
+      buffer[i] = (uint8_t)(rand() % 26 + 'A');
+    }
+    chunk_.data.append(chunkSize);
+  }
+  ~SinkUpload() = default;
+
+  // Pushes sink_records records of chunk_size bytes, server side batching
+  // being set by the server flags. Records are counted once the server has
+  // received them, as its final response tells, rather than when generated.
+  void async(
+      AsyncClient* client,
+      std::unique_ptr<RequestCallback>,
+      int32_t& outstandingOps) {
+#ifdef FOLLY_HAS_COROUTINES
+    folly::coro::co_invoke(
+        [this, client, &outstandingOps]() -> folly::coro::Task<void> {
+          try {
+            auto sink = co_await client->co_sinkUpload();
+            auto received = co_await sink.sink(
+                [this]() -> folly::coro::AsyncGenerator<Chunk2&&> {
+                  for (uint32_t i = 0; i < records_per_sink_; ++i) {
+                    auto chunk = chunk_;
+                    co_yield std::move(chunk);
+                  }
+                }());
+            stats_->add(records_, received);
+            stats_->add(
+                bytes_, received * chunk_.data.computeChainDataLength());
+          } catch (const std::exception& ex) {
+            FB_LOG_EVERY_MS(ERROR, 1000) << "Sink error: " << ex.what();
+            stats_->add(fatal_);
+          }
+          --outstandingOps;
+        })
+        .scheduleOn(folly::EventBaseManager::get()->getEventBase())
+        .start();
+#else
+    (void)client;
+    --outstandingOps;
+#endif
+  }
+
+  void asyncReceived(AsyncClient*, ClientReceiveState&&) {}
+
+  void error(AsyncClient*, ClientReceiveState&& state) {
+    if (state.isException()) {
+      FB_LOG_EVERY_MS(INFO, 1000) << "Error is: " << state.exception().what();
+    }
+    stats_->add(error_);
+  }
+
+ private:
+  QPSStats* stats_;
+  uint32_t records_per_sink_;
+  std::string records_ = "sink_records";
+  std::string bytes_ = "sink_bytes";
+  std::string error_ = "error";
+  std::string fatal_ = "fatal";
+  Chunk2 chunk_;
+};
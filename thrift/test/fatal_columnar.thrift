@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+namespace cpp2 apache.thrift.test
+
+enum EventKind {
+  kRequest = 0,
+  kResponse = 1,
+}
+
+struct EventSource {
+  1: string host,
+  2: i32 port,
+}
+
+struct Event {
+  1: i64 timestamp,
+  2: i32 latency,
+  3: double weight = 1.0,
+  4: bool sampled,
+  5: EventKind kind,
+  6: optional string tag,
+  7: optional i64 parent,
+  8: EventSource source,
+  9: list<i32> hops,
+}
+
+struct EventWithRequired {
+  1: required i64 id,
+  2: i32 latency,
+}
+
+struct EventV2 {
+  1: i64 timestamp,
+  2: i32 latency,
+  10: string note,
+}
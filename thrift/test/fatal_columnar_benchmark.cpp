@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include <thrift/test/gen-cpp2/fatal_columnar_fatal_types.h>
+#include <thrift/test/gen-cpp2/fatal_columnar_types.h>
+
+#include <thrift/lib/cpp2/protocol/CompactProtocol.h>
+#include <thrift/lib/cpp2/reflection/columnar.h>
+
+#include <folly/portability/GFlags.h>
+
+#include <numeric>
+#include <random>
+
+using namespace apache::thrift;
+using namespace apache::thrift::test;
+
+DEFINE_int32(rows, 10000, "Number of events in each list");
+
+namespace {
+
+std::vector<Event> make_events() {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<std::int32_t> latency(0, 1 << 20);
+  std::vector<Event> events(FLAGS_rows);
+  for (std::size_t i = 0; i < events.size(); i++) {
+    auto& e = events[i];
+    e.timestamp = 1500000000000 + i;
+    e.latency = latency(gen);
+    e.sampled = gen() % 2 == 0;
+    if (i % 10 == 0) {
+      e.tag_ref() = "slow";
+    }
+    e.source.host = "host.example.com";
+    e.source.port = 443;
+  }
+  return events;
+}
+
+std::unique_ptr<folly::IOBuf> serialize(std::vector<Event> const& events) {
+  folly::IOBufQueue queue;
+  CompactProtocolWriter writer;
+  writer.setOutput(&queue);
+  writer.writeListBegin(protocol::T_STRUCT, events.size());
+  for (auto const& e : events) {
+    e.write(&writer);
+  }
+  writer.writeListEnd();
+  return queue.move();
+}
+
+// the loop generated code runs for a list<Event> field
+void read_rows(folly::IOBuf const* buf, std::vector<Event>& out) {
+  CompactProtocolReader reader;
+  reader.setInput(buf);
+  protocol::TType type;
+  std::uint32_t size;
+  reader.readListBegin(type, size);
+  out.resize(size);
+  for (auto& e : out) {
+    e.read(&reader);
+  }
+  reader.readListEnd();
+}
+
+void read_columns(folly::IOBuf const* buf, ColumnarList<Event>& out) {
+  CompactProtocolReader reader;
+  reader.setInput(buf);
+  out.read(reader);
+}
+
+std::int64_t sum_latency(std::vector<Event> const& events) {
+  std::int64_t sum = 0;
+  for (auto const& e : events) {
+    sum += e.latency;
+  }
+  return sum;
+}
+
+std::int64_t sum_latency(ColumnarList<Event> const& events) {
+  auto const latency = events.column<2>();
+  return std::accumulate(latency.begin(), latency.end(), std::int64_t(0));
+}
+
+struct harness {
+  std::unique_ptr<folly::IOBuf> buf;
+  std::vector<Event> rows;
+  ColumnarList<Event> columns;
+
+  harness() : buf(serialize(make_events())) {
+    read_rows(buf.get(), rows);
+    read_columns(buf.get(), columns);
+  }
+};
+
+harness const& data() {
+  static harness const instance;
+  return instance;
+}
+
+} // namespace
+
+BENCHMARK(RowWise_Deserialize, iters) {
+  folly::BenchmarkSuspender braces;
+  auto const& h = data();
+  std::vector<Event> rows;
+
+  braces.dismissing([&] {
+    while (iters--) {
+      read_rows(h.buf.get(), rows);
+      folly::doNotOptimizeAway(rows);
+    }
+  });
+}
+
+BENCHMARK_RELATIVE(Columnar_Deserialize, iters) {
+  folly::BenchmarkSuspender braces;
+  auto const& h = data();
+  ColumnarList<Event> columns;
+
+  braces.dismissing([&] {
+    while (iters--) {
+      read_columns(h.buf.get(), columns);
+      folly::doNotOptimizeAway(columns);
+    }
+  });
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(RowWise_SumLatency, iters) {
+  folly::BenchmarkSuspender braces;
+  auto const& h = data();
+
+  braces.dismissing([&] {
+    while (iters--) {
+      folly::doNotOptimizeAway(sum_latency(h.rows));
+    }
+  });
+}
+
+BENCHMARK_RELATIVE(Columnar_SumLatency, iters) {
+  folly::BenchmarkSuspender braces;
+  auto const& h = data();
+
+  braces.dismissing([&] {
+    while (iters--) {
+      folly::doNotOptimizeAway(sum_latency(h.columns));
+    }
+  });
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(RowWise_DeserializeAndSum, iters) {
+  folly::BenchmarkSuspender braces;
+  auto const& h = data();
+  std::vector<Event> rows;
+
+  braces.dismissing([&] {
+    while (iters--) {
+      read_rows(h.buf.get(), rows);
+      folly::doNotOptimizeAway(sum_latency(rows));
+    }
+  });
+}
+
+BENCHMARK_RELATIVE(Columnar_DeserializeAndSum, iters) {
+  folly::BenchmarkSuspender braces;
+  auto const& h = data();
+  ColumnarList<Event> columns;
+
+  braces.dismissing([&] {
+    while (iters--) {
+      read_columns(h.buf.get(), columns);
+      folly::doNotOptimizeAway(sum_latency(columns));
+    }
+  });
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  return 0;
+}
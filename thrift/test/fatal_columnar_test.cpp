@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrift/test/gen-cpp2/fatal_columnar_fatal_types.h>
+#include <thrift/test/gen-cpp2/fatal_columnar_types.h>
+
+#include <thrift/lib/cpp2/reflection/columnar.h>
+#include <thrift/lib/cpp2/reflection/internal/test_helpers.h>
+#include <thrift/lib/cpp2/reflection/serializer.h>
+
+#include <thrift/test/fatal_serialization_common.h>
+
+#include <folly/portability/GTest.h>
+
+using namespace apache::thrift;
+using namespace apache::thrift::test;
+
+TYPED_TEST_CASE(MultiProtocolTest, protocol_type_pairs);
+TYPED_TEST_CASE(CompareProtocolTest, protocol_type_pairs);
+
+namespace {
+
+template <typename T>
+using list_methods =
+    protocol_methods<type_class::list<type_class::structure>, std::vector<T>>;
+
+std::vector<Event> make_events(std::size_t count) {
+  std::vector<Event> events(count);
+  for (std::size_t i = 0; i < count; i++) {
+    auto& e = events[i];
+    e.timestamp = 1000 + i;
+    e.latency = i * 3;
+    e.weight = 0.5 * i;
+    e.sampled = i % 2 == 0;
+    e.kind = i % 3 == 0 ? EventKind::kResponse : EventKind::kRequest;
+    if (i % 5 == 0) {
+      e.tag_ref() = "tag-" + std::to_string(i);
+    }
+    if (i % 7 == 0) {
+      e.parent_ref() = i / 7;
+    }
+    e.source.host = "host" + std::to_string(i % 4);
+    e.source.port = 8000 + i % 4;
+    e.hops = {1, int32_t(i)};
+  }
+  return events;
+}
+
+} // namespace
+
+TYPED_TEST(MultiProtocolTest, read_from_list) {
+  auto const events = make_events(150);
+  list_methods<Event>::write(this->writer, events);
+  this->prep_read();
+  this->debug_buffer();
+
+  ColumnarList<Event> columnar;
+  columnar.read(this->reader);
+
+  ASSERT_EQ(events.size(), columnar.size());
+  auto const latency = columnar.column<2>();
+  auto const sampled = columnar.column<4>();
+  auto const tag = columnar.column<6>();
+  ASSERT_EQ(events.size(), latency.size());
+  for (std::size_t i = 0; i < events.size(); i++) {
+    EXPECT_EQ(events[i], columnar.row(i)) << "row " << i;
+    EXPECT_EQ(events[i].latency, latency[i]);
+    EXPECT_EQ(events[i].sampled, sampled[i] != 0);
+    EXPECT_EQ(events[i].tag_ref().has_value(), columnar.is_set<6>(i));
+    EXPECT_EQ(events[i].parent_ref().has_value(), columnar.is_set<7>(i));
+    if (columnar.is_set<6>(i)) {
+      EXPECT_EQ(*events[i].tag_ref(), tag[i]);
+    }
+    EXPECT_TRUE(columnar.is_set<1>(i));
+  }
+}
+
+TYPED_TEST(MultiProtocolTest, write_as_list) {
+  auto const events = make_events(70);
+  ColumnarList<Event> columnar;
+  for (auto const& e : events) {
+    columnar.push_back(e);
+  }
+  columnar.write(this->writer);
+  this->prep_read();
+  this->debug_buffer();
+
+  std::vector<Event> decoded;
+  list_methods<Event>::read(this->reader, decoded);
+  EXPECT_EQ(events, decoded);
+}
+
+TYPED_TEST(CompareProtocolTest, same_bytes_as_list) {
+  auto const events = make_events(20);
+  ColumnarList<Event> columnar;
+  for (auto const& e : events) {
+    columnar.push_back(e);
+  }
+
+  list_methods<Event>::write(this->st1.writer, events);
+  columnar.write(this->st2.writer);
+  this->prep_read();
+  this->debug_buffer();
+
+  EXPECT_TRUE(folly::IOBufEqualTo()(
+      *this->st1.underlying, *this->st2.underlying));
+}
+
+TEST(FatalColumnarTest, empty_list) {
+  MultiProtocolTestConcrete<
+      RWPair<CompactProtocolReader, CompactProtocolWriter, false>>
+      rw;
+  list_methods<Event>::write(rw.writer, std::vector<Event>());
+  rw.prep_read();
+
+  ColumnarList<Event> columnar;
+  columnar.push_back(Event());
+  columnar.read(rw.reader);
+  EXPECT_TRUE(columnar.empty());
+  EXPECT_TRUE(columnar.column<1>().empty());
+}
+
+TEST(FatalColumnarTest, presence_bitmap) {
+  ColumnarList<Event> columnar;
+  for (std::size_t i = 0; i < 130; i++) {
+    Event e;
+    if (i % 64 == 3) {
+      e.parent_ref() = i;
+    }
+    columnar.push_back(e);
+  }
+
+  auto const bits = columnar.isset<7>();
+  ASSERT_EQ(3u, bits.size());
+  for (auto word : bits) {
+    EXPECT_EQ(std::uint64_t(1) << 3, word);
+  }
+  EXPECT_EQ(67, columnar.column<7>()[67]);
+  EXPECT_EQ(0, columnar.column<7>()[68]);
+}
+
+TEST(FatalColumnarTest, unknown_fields_are_skipped) {
+  MultiProtocolTestConcrete<
+      RWPair<BinaryProtocolReader, BinaryProtocolWriter, false>>
+      rw;
+  std::vector<EventV2> events(3);
+  for (std::int32_t i = 0; i < 3; i++) {
+    events[i].timestamp = i;
+    events[i].latency = 10 * i;
+    events[i].note = "not an Event field";
+  }
+  list_methods<EventV2>::write(rw.writer, events);
+  rw.prep_read();
+
+  ColumnarList<Event> columnar;
+  columnar.read(rw.reader);
+  ASSERT_EQ(3u, columnar.size());
+  for (std::int32_t i = 0; i < 3; i++) {
+    EXPECT_EQ(i, columnar.column<1>()[i]);
+    EXPECT_EQ(10 * i, columnar.column<2>()[i]);
+    // unset fields take their default value
+    EXPECT_EQ(1.0, columnar.column<3>()[i]);
+    EXPECT_FALSE(columnar.is_set<6>(i));
+  }
+}
+
+TEST(FatalColumnarTest, missing_required_field) {
+  MultiProtocolTestConcrete<
+      RWPair<BinaryProtocolReader, BinaryProtocolWriter, false>>
+      rw;
+  list_methods<Event>::write(rw.writer, make_events(1));
+  rw.prep_read();
+
+  ColumnarList<EventWithRequired> columnar;
+  EXPECT_THROW(columnar.read(rw.reader), protocol::TProtocolException);
+}
+
+TEST(FatalColumnarTest, bool_column_is_contiguous) {
+  EXPECT_SAME<std::uint8_t, ColumnarList<Event>::element_type<4>>();
+  EXPECT_SAME<std::int64_t, ColumnarList<Event>::element_type<1>>();
+}